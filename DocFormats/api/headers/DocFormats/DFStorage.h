@@ -20,8 +20,11 @@
 #include <DocFormats/DFError.h>
 #include <DocFormats/Formats.h>
 #include <stddef.h>
+#include <stdint.h>
 
 typedef struct DFStorage DFStorage;
+typedef struct DFStorageStream DFStorageStream;
+typedef int (*DFStorageReadFunction)(void *ctx, const void *buf, size_t nbytes);
 
 DFStorage *DFStorageNewFilesystem(const char *rootPath, DFFileFormat format);
 DFStorage *DFStorageNewMemory(DFFileFormat format);
@@ -30,10 +33,19 @@ DFStorage *DFStorageOpenZip(const char *filename, DFError **error);
 DFStorage *DFStorageRetain(DFStorage *storage);
 void DFStorageRelease(DFStorage *storage);
 DFFileFormat DFStorageFormat(DFStorage *storage);
+void DFStorageSetCacheLimit(DFStorage *storage, size_t nbytes);
+void DFStorageSetThreads(DFStorage *storage, int threads);
 int DFStorageSave(DFStorage *storage, DFError **error);
 
 int DFStorageRead(DFStorage *storage, const char *path, void **buf, size_t *nbytes, DFError **error);
+int DFStorageReadChunks(DFStorage *storage, const char *path, DFStorageReadFunction fun, void *ctx, DFError **error);
 int DFStorageWrite(DFStorage *storage, const char *path, void *buf, size_t nbytes, DFError **error);
 int DFStorageExists(DFStorage *storage, const char *path);
+int DFStorageSize(DFStorage *storage, const char *path, size_t *nbytes);
+int DFStorageChecksum(DFStorage *storage, const char *path, uint32_t *crc, size_t *nbytes, DFError **error);
 int DFStorageDelete(DFStorage *storage, const char *path, DFError **error);
 const char **DFStorageList(DFStorage *storage, DFError **error);
+
+DFStorageStream *DFStorageStreamOpen(DFStorage *storage, const char *path, DFError **error);
+int DFStorageStreamWrite(DFStorageStream *stream, const void *buf, size_t nbytes);
+int DFStorageStreamClose(DFStorageStream *stream, DFError **error);
@@ -54,6 +54,9 @@ struct DFAbstractDocument {
  *
  * If someone tries to call put with a HTML document that was not originally created from this exact
  * concrete document, the operation will fail.
+ *
+ * Rather than the full contents of each file, the hash covers its name, size, and CRC-32. For zip
+ * packages these are all recorded in the central directory, so nothing needs to be inflated.
  */
 static int computeDocumentHash(DFStorage *storage, DFHashCode *result, DFError **error)
 {
@@ -67,20 +70,16 @@ static int computeDocumentHash(DFStorage *storage, DFHashCode *result, DFError *
         goto end;
     DFSortStringsCaseSensitive(filenames);
     for (int i = 0; filenames[i]; i++) {
-        unsigned char *buf = NULL;
+        uint32_t crc = 0;
         size_t nbytes = 0;
-        if (!DFStorageRead(storage,filenames[i],(void **)&buf,&nbytes,error)) {
+        if (!DFStorageChecksum(storage,filenames[i],&crc,&nbytes,error)) {
             DFErrorFormat(error,"%s: %s",filenames[i],DFErrorMessage(error));
             goto end;
         }
-        // The hash algorithm works on 32-bit integers; add 4 NULL bytes at the end of the buffer to
-        // ensure its entire contents are taken into account when computing the hash.
-        buf = xrealloc(buf,nbytes+4);
-        memset(&buf[nbytes],0,4);
-        uint32_t *intbuf = (uint32_t *)buf;
-        for (size_t pos = 0; pos < (nbytes+3)/4; pos++)
-            DFHashUpdate(hash,intbuf[pos]);
-        free(buf);
+        for (const char *c = filenames[i]; *c; c++)
+            DFHashUpdate(hash,(unsigned char)*c);
+        DFHashUpdate(hash,crc);
+        DFHashUpdate(hash,(uint32_t)nbytes);
     }
     DFHashEnd(hash);
     *result = hash;
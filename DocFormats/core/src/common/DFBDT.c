@@ -42,6 +42,15 @@ DFNode *BDTContainerGet(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *co
     return abstract;
 }
 
+// Returns the nearest hidden node before con, skipping over visible ones
+static DFNode *findPrevHidden(void *ctx, int (*isVisible)(void *ctx, DFNode *concrete), DFNode *con)
+{
+    DFNode *prevHidden = con->prev;
+    while ((prevHidden != NULL) && isVisible(ctx,prevHidden))
+        prevHidden = prevHidden->prev;
+    return prevHidden;
+}
+
 void BDTContainerPut(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *concrete,
                      DFLookupConcreteFunction lookupConcrete)
 {
@@ -73,29 +82,35 @@ void BDTContainerPut(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *concr
             conChildren[count++] = con;
     }
 
-    DFHashTable *oldPrevHidden = DFHashTableNew(NULL,NULL);
-    for (int i = count-1; i >= 0; i--) {
-        DFNode *con = conChildren[i];
-        DFNode *prevHidden = con->prev;
-        while ((prevHidden != NULL) && isVisible(ctx,prevHidden))
-            prevHidden = prevHidden->prev;
-        if (prevHidden != NULL) {
-            DFHashTableAddInt(oldPrevHidden,con->seqNo,prevHidden);
-        }
-        else {
-            DFHashTableAddInt(oldPrevHidden,con->seqNo,(void *)1);
-        }
+    // Per-child state is kept in arrays parallel to conChildren; conIndex maps a node's seqNo to
+    // its position there (plus one, so that zero means it's not one of the children). For nodes
+    // that occur more than once, the last position is the one used.
+    DFHashTable *conIndex = DFHashTableNew2(NULL,NULL,count);
+    for (int i = 0; i < count; i++)
+        DFHashTableAddInt(conIndex,conChildren[i]->seqNo,(void *)(uintptr_t)(i+1));
+
+    // Record the hidden node each child came after, so it can be put back there. Children already
+    // in the container get this from a single pass over it; others are looked up individually.
+    DFNode **oldPrevHidden = (DFNode **)xcalloc(count+1,sizeof(DFNode *));
+    DFNode *lastHidden = NULL;
+    for (DFNode *con = concrete->first; con != NULL; con = con->next) {
+        uintptr_t index = (uintptr_t)DFHashTableLookupInt(conIndex,con->seqNo);
+        if (index != 0)
+            oldPrevHidden[index-1] = lastHidden;
+        if (!isVisible(ctx,con))
+            lastHidden = con;
+    }
+    for (int i = 0; i < count; i++) {
+        if (conChildren[i]->parent != concrete)
+            oldPrevHidden[i] = findPrevHidden(ctx,isVisible,conChildren[i]);
     }
 
     // Remove concrete nodes for which their abstract counterparts no longer exist
-    DFHashTable *remaining = DFHashTableNew(NULL,NULL);
-    for (int i = 0; i < count; i++)
-        DFHashTableAddInt(remaining,conChildren[i]->seqNo,"");
     DFNode *next;
     for (DFNode *con = concrete->first; con != NULL; con = next) {
         next = con->next;
         if (isVisible(ctx,con)) {
-            if (DFHashTableLookupInt(remaining,con->seqNo) == NULL) {
+            if (DFHashTableLookupInt(conIndex,con->seqNo) == NULL) {
                 if (theLens->remove != NULL)
                     theLens->remove(ctx,con);
                 DFRemoveNode(con);
@@ -114,11 +129,6 @@ void BDTContainerPut(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *concr
     // Reinsert all the nodes in the correct order
     for (int i = count-1; i >= 0; i--) {
         DFNode *con = conChildren[i];
-
-        DFNode *oldNext = con->next;
-        while ((oldNext != NULL) && !isVisible(ctx,oldNext))
-            oldNext = oldNext->next;
-
         DFNode *newNext = (i+1 < count) ? conChildren[i+1] : NULL;
         if (newNext == NULL)
             newNext = last;
@@ -126,46 +136,47 @@ void BDTContainerPut(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *concr
         DFInsertBefore(concrete,con,newNext);
     }
 
-    // Fixup stage - move nodes backwards as much as possible to their previous prevHidden
-    for (DFNode *con = concrete->first; con != NULL; con = next) {
+    // Fixup stage - move nodes backwards as much as possible to their previous prevHidden. A node
+    // can only move back over the hidden nodes between it and the previous visible one; if its
+    // prevHidden is among them, it goes directly after that, and if it's further back, it goes
+    // directly after the previous visible node.
+    //
+    // Rather than searching backwards for prevHidden, we record the position of each hidden node
+    // as we pass it, and give each visible node a sort key that places it relative to those: twice
+    // the position for nodes that stay where they are, one more than twice the position of the
+    // hidden node a moved node now follows, or the same key as the visible node it now follows.
+    DFHashTable *hiddenPos = DFHashTableNew2(NULL,NULL,count);
+    DFNode *prevVisible = NULL;
+    size_t prevVisibleKey = 0;
+    size_t pos = 0;
+    for (DFNode *con = concrete->first; con != NULL; con = next, pos++) {
         next = con->next;
-        if (!isVisible(ctx,con))
+        if (!isVisible(ctx,con)) {
+            DFHashTableAddInt(hiddenPos,con->seqNo,(void *)(uintptr_t)(pos+1));
             continue;
-        void *ph = DFHashTableLookupInt(oldPrevHidden,con->seqNo);
-        if (ph == NULL)
-            continue;
-        if (ph == (void*)1)
-            ph = NULL;;
-        DFNode *prevHidden = (DFNode *)ph;
-        if (prevHidden == NULL)
-            continue;
-        DFNode *insertionPoint = con->next;
-        DFNode *actual = con->prev;
-        int blockedByPrev = 0;
-        int found = 0;
-        for (;;) {
-            if (!blockedByPrev) {
-                if (actual == NULL)
-                    insertionPoint = concrete->first;
-                else
-                    insertionPoint = actual->next;
-            }
-            if ((actual != NULL) && isVisible(ctx,actual))
-                blockedByPrev = 1;
-            if (actual == prevHidden) {
-                found = 1;
-                break;
+        }
+
+        size_t key = 2*pos;
+        uintptr_t index = (uintptr_t)DFHashTableLookupInt(conIndex,con->seqNo);
+        DFNode *prevHidden = (index != 0) ? oldPrevHidden[index-1] : NULL;
+        uintptr_t phPos = (prevHidden != NULL) ? (uintptr_t)DFHashTableLookupInt(hiddenPos,prevHidden->seqNo) : 0;
+        if (phPos != 0) {
+            size_t phKey = 2*(phPos-1);
+            if ((prevVisible == NULL) || (phKey > prevVisibleKey)) {
+                DFInsertBefore(concrete,con,prevHidden->next);
+                key = phKey+1;
             }
-            if (actual == NULL) {
-                break;
+            else {
+                DFInsertBefore(concrete,con,prevVisible->next);
+                key = prevVisibleKey;
             }
-            actual = actual->prev;
         }
-        if (found)
-            DFInsertBefore(concrete,con,insertionPoint);
+        prevVisible = con;
+        prevVisibleKey = key;
     }
 
     free(conChildren);
-    DFHashTableRelease(oldPrevHidden);
-    DFHashTableRelease(remaining);
+    free(oldPrevHidden);
+    DFHashTableRelease(conIndex);
+    DFHashTableRelease(hiddenPos);
 }
@@ -195,23 +195,23 @@ char *CSSSerializeProperties(DFHashTable *cssProperties)
     return result;
 }
 
-static void expandTextDecoration(DFHashTable *properties)
+static void expandTextDecoration(CSSProperties *properties)
 {
-    const char *value = DFHashTableLookup(properties,"text-decoration");
+    const char *value = CSSGet(properties,"text-decoration");
     if (value != NULL) {
         char *textDecoration = DFLowerCase(value);
         const char **tokens = DFStringTokenize(textDecoration,isspace);
         for (int i = 0; tokens[i]; i++) {
             if (!strcmp(tokens[i],"underline"))
-                DFHashTableAdd(properties,"text-decoration-underline","underline");
+                CSSPutID(properties,CSSPropertyTextDecorationUnderline,"underline");
             if (!strcmp(tokens[i],"overline"))
-                DFHashTableAdd(properties,"text-decoration-overline","overline");
+                CSSPutID(properties,CSSPropertyTextDecorationOverline,"overline");
             if (!strcmp(tokens[i],"line-through"))
-                DFHashTableAdd(properties,"text-decoration-line-through","line-through");
+                CSSPutID(properties,CSSPropertyTextDecorationLineThrough,"line-through");
         }
-        DFHashTableRemove(properties,"text-decoration");
         free(tokens);
         free(textDecoration);
+        CSSPut(properties,"text-decoration",NULL);
     }
 }
 
@@ -256,153 +256,147 @@ static int splitSides(const char *shorthand, SideValues *sides)
     return ok;
 }
 
-static void expandBorderSide(const char *prefix, DFHashTable *properties)
+typedef struct {
+    CSSPropertyID left;
+    CSSPropertyID right;
+    CSSPropertyID top;
+    CSSPropertyID bottom;
+} SideIDs;
+
+static const SideIDs BorderWidthIDs = {
+    CSSPropertyBorderLeftWidth, CSSPropertyBorderRightWidth,
+    CSSPropertyBorderTopWidth, CSSPropertyBorderBottomWidth
+};
+
+static const SideIDs BorderStyleIDs = {
+    CSSPropertyBorderLeftStyle, CSSPropertyBorderRightStyle,
+    CSSPropertyBorderTopStyle, CSSPropertyBorderBottomStyle
+};
+
+static const SideIDs BorderColorIDs = {
+    CSSPropertyBorderLeftColor, CSSPropertyBorderRightColor,
+    CSSPropertyBorderTopColor, CSSPropertyBorderBottomColor
+};
+
+static const SideIDs PaddingIDs = {
+    CSSPropertyPaddingLeft, CSSPropertyPaddingRight,
+    CSSPropertyPaddingTop, CSSPropertyPaddingBottom
+};
+
+static const SideIDs MarginIDs = {
+    CSSPropertyMarginLeft, CSSPropertyMarginRight,
+    CSSPropertyMarginTop, CSSPropertyMarginBottom
+};
+
+static void putAllSides(CSSProperties *properties, const SideIDs *ids, const char *value)
 {
-    const char *shorthand = DFHashTableLookup(properties,prefix);
-    if (shorthand != NULL) {
-        const char **tokens = DFStringTokenize(shorthand,isspace);
-        for (int i = 0; tokens[i]; i++) {
-            char *name = NULL;
-            if (CSSValueIsBorderStyle(tokens[i]))
-                name = DFFormatString("%s-style",prefix);
-            else if (CSSValueIsBorderWidth(tokens[i]))
-                name = DFFormatString("%s-width",prefix);
-            else if (CSSValueIsBorderColor(tokens[i]))
-                name = DFFormatString("%s-color",prefix);
-            if (name != NULL)
-                DFHashTableAdd(properties,name,tokens[i]);
-            free(name);
-        }
-        free(tokens);
-        DFHashTableRemove(properties,prefix);
-    }
+    CSSPutID(properties,ids->left,value);
+    CSSPutID(properties,ids->right,value);
+    CSSPutID(properties,ids->top,value);
+    CSSPutID(properties,ids->bottom,value);
 }
 
-static void expandBorderAspect(const char *aspect, DFHashTable *properties)
+// Expand a shorthand of the form used by margin, padding, and border-width, which specifies
+// between one and four values to be distributed among the sides
+
+static void expandSides(CSSProperties *properties, const char *name, const SideIDs *ids)
 {
-    char *propertyName = DFFormatString("border-%s",aspect);
-    const char *shorthand = DFHashTableLookup(properties,propertyName);
+    const char *shorthand = CSSGet(properties,name);
     if (shorthand != NULL) {
         SideValues sides = SideValuesEmpty;
         if (splitSides(shorthand,&sides)) {
-            char *leftName = DFFormatString("border-left-%s",aspect);
-            char *rightName = DFFormatString("border-right-%s",aspect);
-            char *topName = DFFormatString("border-top-%s",aspect);
-            char *bottomName = DFFormatString("border-bottom-%s",aspect);
-            DFHashTableAdd(properties,leftName,sides.left);
-            DFHashTableAdd(properties,rightName,sides.right);
-            DFHashTableAdd(properties,topName,sides.top);
-            DFHashTableAdd(properties,bottomName,sides.bottom);
-            free(leftName);
-            free(rightName);
-            free(topName);
-            free(bottomName);
+            CSSPutID(properties,ids->left,sides.left);
+            CSSPutID(properties,ids->right,sides.right);
+            CSSPutID(properties,ids->top,sides.top);
+            CSSPutID(properties,ids->bottom,sides.bottom);
         }
-        DFHashTableRemove(properties,propertyName);
         SideValuesClear(&sides);
+        CSSPut(properties,name,NULL);
     }
-    free(propertyName);
 }
 
-static void expandBorders(DFHashTable *properties)
+static void expandBorderSide(CSSProperties *properties, const char *name,
+                             CSSPropertyID widthID, CSSPropertyID styleID, CSSPropertyID colorID)
 {
-    expandBorderSide("border-left",properties);
-    expandBorderSide("border-right",properties);
-    expandBorderSide("border-top",properties);
-    expandBorderSide("border-bottom",properties);
+    const char *shorthand = CSSGet(properties,name);
+    if (shorthand != NULL) {
+        const char **tokens = DFStringTokenize(shorthand,isspace);
+        for (int i = 0; tokens[i]; i++) {
+            if (CSSValueIsBorderStyle(tokens[i]))
+                CSSPutID(properties,styleID,tokens[i]);
+            else if (CSSValueIsBorderWidth(tokens[i]))
+                CSSPutID(properties,widthID,tokens[i]);
+            else if (CSSValueIsBorderColor(tokens[i]))
+                CSSPutID(properties,colorID,tokens[i]);
+        }
+        free(tokens);
+        CSSPut(properties,name,NULL);
+    }
+}
 
-    expandBorderAspect("width",properties);
-    expandBorderAspect("color",properties);
-    expandBorderAspect("style",properties);
+static void expandBorders(CSSProperties *properties)
+{
+    expandBorderSide(properties,"border-left",CSSPropertyBorderLeftWidth,
+                     CSSPropertyBorderLeftStyle,CSSPropertyBorderLeftColor);
+    expandBorderSide(properties,"border-right",CSSPropertyBorderRightWidth,
+                     CSSPropertyBorderRightStyle,CSSPropertyBorderRightColor);
+    expandBorderSide(properties,"border-top",CSSPropertyBorderTopWidth,
+                     CSSPropertyBorderTopStyle,CSSPropertyBorderTopColor);
+    expandBorderSide(properties,"border-bottom",CSSPropertyBorderBottomWidth,
+                     CSSPropertyBorderBottomStyle,CSSPropertyBorderBottomColor);
+
+    expandSides(properties,"border-width",&BorderWidthIDs);
+    expandSides(properties,"border-color",&BorderColorIDs);
+    expandSides(properties,"border-style",&BorderStyleIDs);
 
     // border
 
-    const char *border = DFHashTableLookup(properties,"border");
+    const char *border = CSSGet(properties,"border");
     if (border != NULL) {
         const char **tokens = DFStringTokenize(border,isspace);
         for (int i = 0; tokens[i]; i++) {
             const char *token = tokens[i];
-            if (CSSValueIsBorderStyle(token)) {
-                DFHashTableAdd(properties,"border-left-style",token);
-                DFHashTableAdd(properties,"border-right-style",token);
-                DFHashTableAdd(properties,"border-top-style",token);
-                DFHashTableAdd(properties,"border-bottom-style",token);
-            }
-            else if (CSSValueIsBorderWidth(token)) {
-                DFHashTableAdd(properties,"border-left-width",token);
-                DFHashTableAdd(properties,"border-right-width",token);
-                DFHashTableAdd(properties,"border-top-width",token);
-                DFHashTableAdd(properties,"border-bottom-width",token);
-            }
-            else if (CSSValueIsBorderColor(token)) {
-                DFHashTableAdd(properties,"border-left-color",token);
-                DFHashTableAdd(properties,"border-right-color",token);
-                DFHashTableAdd(properties,"border-top-color",token);
-                DFHashTableAdd(properties,"border-bottom-color",token);
-            }
+            if (CSSValueIsBorderStyle(token))
+                putAllSides(properties,&BorderStyleIDs,token);
+            else if (CSSValueIsBorderWidth(token))
+                putAllSides(properties,&BorderWidthIDs,token);
+            else if (CSSValueIsBorderColor(token))
+                putAllSides(properties,&BorderColorIDs,token);
         }
         free(tokens);
-        DFHashTableRemove(properties,"border");
+        CSSPut(properties,"border",NULL);
     }
 
     // border-radius
 
-    const char *radius = DFHashTableLookup(properties,"border-radius");
+    const char *radius = CSSGet(properties,"border-radius");
     if (radius != NULL) {
-        DFHashTableAdd(properties,"border-top-left-radius",radius);
-        DFHashTableAdd(properties,"border-top-right-radius",radius);
-        DFHashTableAdd(properties,"border-bottom-left-radius",radius);
-        DFHashTableAdd(properties,"border-bottom-right-radius",radius);
-        DFHashTableRemove(properties,"border-radius");
+        CSSPutID(properties,CSSPropertyBorderTopLeftRadius,radius);
+        CSSPutID(properties,CSSPropertyBorderTopRightRadius,radius);
+        CSSPutID(properties,CSSPropertyBorderBottomLeftRadius,radius);
+        CSSPutID(properties,CSSPropertyBorderBottomRightRadius,radius);
+        CSSPut(properties,"border-radius",NULL);
     }
 }
 
-static void expandPadding(DFHashTable *properties)
-{
-    const char *shorthand = DFHashTableLookup(properties,"padding");
-    if (shorthand != NULL) {
-        SideValues sides = SideValuesEmpty;
-        if (splitSides(shorthand,&sides)) {
-            DFHashTableAdd(properties,"padding-left",sides.left);
-            DFHashTableAdd(properties,"padding-right",sides.right);
-            DFHashTableAdd(properties,"padding-top",sides.top);
-            DFHashTableAdd(properties,"padding-bottom",sides.bottom);
-        }
-        DFHashTableRemove(properties,"padding");
-        SideValuesClear(&sides);
-    }
-}
-
-static void expandMargins(DFHashTable *properties)
-{
-    const char *shorthand = DFHashTableLookup(properties,"margin");
-    if (shorthand != NULL) {
-        SideValues sides = SideValuesEmpty;
-        if (splitSides(shorthand,&sides)) {
-            DFHashTableAdd(properties,"margin-left",sides.left);
-            DFHashTableAdd(properties,"margin-right",sides.right);
-            DFHashTableAdd(properties,"margin-top",sides.top);
-            DFHashTableAdd(properties,"margin-bottom",sides.bottom);
-        }
-        DFHashTableRemove(properties,"margin");
-        SideValuesClear(&sides);
-    }
-}
-
-void CSSExpandProperties(DFHashTable *properties)
+void CSSExpandProperties(CSSProperties *properties)
 {
+    // None of the shorthand properties have a CSSPropertyID, so if there are no other properties
+    // there is nothing to expand
+    if (DFHashTableCount(properties->others) == 0)
+        return;
     expandTextDecoration(properties);
     expandBorders(properties);
-    expandPadding(properties);
-    expandMargins(properties);
+    expandSides(properties,"padding",&PaddingIDs);
+    expandSides(properties,"margin",&MarginIDs);
 }
 
 DFHashTable *CSSCollapseProperties(CSSProperties *expanded)
 {
-    DFHashTable *collapsed = DFHashTableCopy(expanded->hashTable);
-    const char *underline = DFHashTableLookup(collapsed,"text-decoration-underline");
-    const char *overline = DFHashTableLookup(collapsed,"text-decoration-overline");
-    const char *lineThrough = DFHashTableLookup(collapsed,"text-decoration-line-through");
+    DFHashTable *collapsed = CSSPropertiesCopyTable(expanded);
+    const char *underline = CSSGetID(expanded,CSSPropertyTextDecorationUnderline);
+    const char *overline = CSSGetID(expanded,CSSPropertyTextDecorationOverline);
+    const char *lineThrough = CSSGetID(expanded,CSSPropertyTextDecorationLineThrough);
     if ((underline != NULL) || (overline != NULL) || (lineThrough != NULL)) {
         DFBuffer *buffer = DFBufferNew();
         if (underline != NULL)
@@ -422,10 +416,10 @@ DFHashTable *CSSCollapseProperties(CSSProperties *expanded)
 
     // Margins
 
-    const char *marginLeft = CSSGet(expanded,"margin-left");
-    const char *marginRight = CSSGet(expanded,"margin-right");
-    const char *marginTop = CSSGet(expanded,"margin-top");
-    const char *marginBottom = CSSGet(expanded,"margin-bottom");
+    const char *marginLeft = CSSGetID(expanded,CSSPropertyMarginLeft);
+    const char *marginRight = CSSGetID(expanded,CSSPropertyMarginRight);
+    const char *marginTop = CSSGetID(expanded,CSSPropertyMarginTop);
+    const char *marginBottom = CSSGetID(expanded,CSSPropertyMarginBottom);
     if ((marginLeft != NULL) && (marginRight != NULL) && (marginTop != NULL) && (marginBottom != NULL) &&
         DFStringEquals(marginLeft,marginRight) &&
         DFStringEquals(marginLeft,marginTop) &&
@@ -440,10 +434,10 @@ DFHashTable *CSSCollapseProperties(CSSProperties *expanded)
 
     // Padding
 
-    const char *paddingLeft = CSSGet(expanded,"padding-left");
-    const char *paddingRight = CSSGet(expanded,"padding-right");
-    const char *paddingTop = CSSGet(expanded,"padding-top");
-    const char *paddingBottom = CSSGet(expanded,"padding-bottom");
+    const char *paddingLeft = CSSGetID(expanded,CSSPropertyPaddingLeft);
+    const char *paddingRight = CSSGetID(expanded,CSSPropertyPaddingRight);
+    const char *paddingTop = CSSGetID(expanded,CSSPropertyPaddingTop);
+    const char *paddingBottom = CSSGetID(expanded,CSSPropertyPaddingBottom);
 
     if ((paddingLeft != NULL) && (paddingRight != NULL) && (paddingTop != NULL) && (paddingBottom != NULL) &&
         DFStringEquals(paddingLeft,paddingRight) &&
@@ -459,10 +453,10 @@ DFHashTable *CSSCollapseProperties(CSSProperties *expanded)
 
     // Border radius
 
-    const char *borderTopLeftRadius = CSSGet(expanded,"border-top-left-radius");
-    const char *borderTopRightRadius = CSSGet(expanded,"border-top-right-radius");
-    const char *borderBottomLeftRadius = CSSGet(expanded,"border-bottom-left-radius");
-    const char *borderBottomRightRadius = CSSGet(expanded,"border-bottom-right-radius");
+    const char *borderTopLeftRadius = CSSGetID(expanded,CSSPropertyBorderTopLeftRadius);
+    const char *borderTopRightRadius = CSSGetID(expanded,CSSPropertyBorderTopRightRadius);
+    const char *borderBottomLeftRadius = CSSGetID(expanded,CSSPropertyBorderBottomLeftRadius);
+    const char *borderBottomRightRadius = CSSGetID(expanded,CSSPropertyBorderBottomRightRadius);
 
     if ((borderTopLeftRadius != NULL) && (borderTopRightRadius != NULL) &&
         (borderBottomLeftRadius != NULL) && (borderBottomRightRadius != NULL) &&
@@ -484,20 +478,20 @@ DFHashTable *CSSCollapseProperties(CSSProperties *expanded)
     DFBuffer *borderTop = DFBufferNew();
     DFBuffer *borderBottom = DFBufferNew();
 
-    const char *borderLeftWidth = CSSGet(expanded,"border-left-width");
-    const char *borderRightWidth = CSSGet(expanded,"border-right-width");
-    const char *borderTopWidth = CSSGet(expanded,"border-top-width");
-    const char *borderBottomWidth = CSSGet(expanded,"border-bottom-width");
+    const char *borderLeftWidth = CSSGetID(expanded,CSSPropertyBorderLeftWidth);
+    const char *borderRightWidth = CSSGetID(expanded,CSSPropertyBorderRightWidth);
+    const char *borderTopWidth = CSSGetID(expanded,CSSPropertyBorderTopWidth);
+    const char *borderBottomWidth = CSSGetID(expanded,CSSPropertyBorderBottomWidth);
 
-    const char *borderLeftStyle = CSSGet(expanded,"border-left-style");
-    const char *borderRightStyle = CSSGet(expanded,"border-right-style");
-    const char *borderTopStyle = CSSGet(expanded,"border-top-style");
-    const char *borderBottomStyle = CSSGet(expanded,"border-bottom-style");
+    const char *borderLeftStyle = CSSGetID(expanded,CSSPropertyBorderLeftStyle);
+    const char *borderRightStyle = CSSGetID(expanded,CSSPropertyBorderRightStyle);
+    const char *borderTopStyle = CSSGetID(expanded,CSSPropertyBorderTopStyle);
+    const char *borderBottomStyle = CSSGetID(expanded,CSSPropertyBorderBottomStyle);
 
-    const char *borderLeftColor = CSSGet(expanded,"border-left-color");
-    const char *borderRightColor = CSSGet(expanded,"border-right-color");
-    const char *borderTopColor = CSSGet(expanded,"border-top-color");
-    const char *borderBottomColor = CSSGet(expanded,"border-bottom-color");
+    const char *borderLeftColor = CSSGetID(expanded,CSSPropertyBorderLeftColor);
+    const char *borderRightColor = CSSGetID(expanded,CSSPropertyBorderRightColor);
+    const char *borderTopColor = CSSGetID(expanded,CSSPropertyBorderTopColor);
+    const char *borderBottomColor = CSSGetID(expanded,CSSPropertyBorderBottomColor);
 
     if (borderLeftWidth != NULL)
         DFBufferFormat(borderLeft," %s",borderLeftWidth);
@@ -100,7 +100,7 @@ const char *ListStyleTypeString(ListStyleType type);
 
 DFHashTable *CSSParseProperties(const char *input);
 char *CSSSerializeProperties(DFHashTable *cssProperties);
-void CSSExpandProperties(DFHashTable *properties);
+void CSSExpandProperties(CSSProperties *properties);
 DFHashTable *CSSCollapseProperties(CSSProperties *expanded);
 
 char *CSSCopyStylesheetTextFromRules(DFHashTable *rules);
@@ -34,14 +34,94 @@ char *CSSPropertiesCopyDescription(CSSProperties *properties)
     return result;
 }
 
+// Set a property without notifying anyone. Unknown properties are identified by name.
+
+static void setValue(CSSProperties *properties, CSSPropertyID id, const char *name, const char *value)
+{
+    if (id == CSSPropertyUnknown) {
+        if (value == NULL)
+            DFHashTableRemove(properties->others,name);
+        else
+            DFHashTableAdd(properties->others,name,value);
+        return;
+    }
+
+    char *old = properties->values[id];
+    properties->values[id] = (value != NULL) ? xstrdup(value) : NULL;
+    if ((old == NULL) && (value != NULL))
+        properties->valuesCount++;
+    else if ((old != NULL) && (value == NULL))
+        properties->valuesCount--;
+    free(old);
+}
+
+static void setFromTable(CSSProperties *properties, DFHashTable *table)
+{
+    const char **keys = DFHashTableCopyKeys(table);
+    for (int i = 0; keys[i]; i++)
+        setValue(properties,CSSPropertyIDForName(keys[i]),keys[i],DFHashTableLookup(table,keys[i]));
+    free(keys);
+}
+
+static void clearValues(CSSProperties *properties)
+{
+    for (int id = 0; id < CSSPropertyCount; id++) {
+        free(properties->values[id]);
+        properties->values[id] = NULL;
+    }
+    properties->valuesCount = 0;
+}
+
+static void propertiesChanged(CSSProperties *properties)
+{
+    if (!properties->dirty) // Minimise KVO notifications
+        properties->dirty = 1;
+    DFCallbackInvoke(properties->changeCallbacks,properties,NULL);
+}
+
 const char **CSSPropertiesCopyNames(CSSProperties *properties)
 {
-    return DFHashTableCopyKeys(properties->hashTable);
+    // The names of the predefined properties are static, so only those in the others table need to
+    // be copied into the returned block of memory
+    const char **otherNames = DFHashTableCopyKeys(properties->others);
+    size_t otherCount = 0;
+    size_t otherBytes = 0;
+    for (; otherNames[otherCount]; otherCount++)
+        otherBytes += strlen(otherNames[otherCount])+1;
+
+    size_t count = properties->valuesCount + otherCount;
+    const char **names = (const char **)xmalloc((count+1)*sizeof(char *) + otherBytes);
+    char *storage = (char *)&names[count+1];
+    size_t index = 0;
+    for (int id = CSSPropertyUnknown+1; id < CSSPropertyCount; id++) {
+        if (properties->values[id] != NULL)
+            names[index++] = CSSPropertyNameForID(id);
+    }
+    for (size_t i = 0; i < otherCount; i++) {
+        size_t len = strlen(otherNames[i]);
+        memcpy(storage,otherNames[i],len+1);
+        names[index++] = storage;
+        storage += len+1;
+    }
+    names[index] = NULL;
+    assert(index == count);
+    free(otherNames);
+    return names;
+}
+
+DFHashTable *CSSPropertiesCopyTable(CSSProperties *properties)
+{
+    DFHashTable *table = DFHashTableCopy(properties->others);
+    for (int id = CSSPropertyUnknown+1; id < CSSPropertyCount; id++) {
+        if (properties->values[id] != NULL)
+            DFHashTableAdd(table,CSSPropertyNameForID(id),properties->values[id]);
+    }
+    return table;
 }
 
 int CSSPropertiesIsEmpty(CSSProperties *properties)
 {
-    return (DFHashTableCount(properties->hashTable) == 0);
+    return ((properties->valuesCount == 0) && (DFHashTableCount(properties->others) == 0));
 }
 
 const char *CSSGet(CSSProperties *properties, const char *name)
@@ -49,7 +129,11 @@ const char *CSSGet(CSSProperties *properties, const char *name)
     if (properties == NULL)
         return NULL;
     assert(properties->retainCount > 0);
-    return DFHashTableLookup(properties->hashTable,name);
+    CSSPropertyID id = CSSPropertyIDForName(name);
+    if (id != CSSPropertyUnknown)
+        return properties->values[id];
+    else
+        return DFHashTableLookup(properties->others,name);
 }
 
 void CSSPut(CSSProperties *properties, const char *name, const char *value)
@@ -57,83 +141,109 @@ void CSSPut(CSSProperties *properties, const char *name, const char *value)
     if (properties == NULL)
         return;
     assert(properties->retainCount > 0);
-    if (value == NULL)
-        DFHashTableRemove(properties->hashTable,name);
-    else
-        DFHashTableAdd(properties->hashTable,name,(void *)value);
-    if (!properties->dirty) // Minimise KVO notifications
-        properties->dirty = 1;
-    DFCallbackInvoke(properties->changeCallbacks,properties,NULL);
+    setValue(properties,CSSPropertyIDForName(name),name,value);
+    propertiesChanged(properties);
+}
+
+const char *CSSGetID(CSSProperties *properties, CSSPropertyID id)
+{
+    if (properties == NULL)
+        return NULL;
+    assert(properties->retainCount > 0);
+    assert((id > CSSPropertyUnknown) && (id < CSSPropertyCount));
+    return properties->values[id];
+}
+
+void CSSPutID(CSSProperties *properties, CSSPropertyID id, const char *value)
+{
+    if (properties == NULL)
+        return;
+    assert(properties->retainCount > 0);
+    assert((id > CSSPropertyUnknown) && (id < CSSPropertyCount));
+    setValue(properties,id,NULL,value);
+    propertiesChanged(properties);
 }
 
 void CSSPropertiesUpdateFromRaw(CSSProperties *properties, DFHashTable *raw)
 {
-    DFHashTableRelease(properties->hashTable);
-    properties->hashTable = DFHashTableCopy(raw);
-    CSSExpandProperties(properties->hashTable);
-    if (!properties->dirty) // Minimise KVO notifications
-        properties->dirty = 1;
-    DFCallbackInvoke(properties->changeCallbacks,properties,NULL);
+    // Expand into a separate object, which has no change callbacks, so that the listeners on this
+    // one are only notified once
+    CSSProperties *expanded = CSSPropertiesNew();
+    setFromTable(expanded,raw);
+    CSSExpandProperties(expanded);
+
+    clearValues(properties);
+    memcpy(properties->values,expanded->values,sizeof(properties->values));
+    properties->valuesCount = expanded->valuesCount;
+    memset(expanded->values,0,sizeof(expanded->values));
+    expanded->valuesCount = 0;
+
+    DFHashTable *oldOthers = properties->others;
+    properties->others = expanded->others;
+    expanded->others = oldOthers;
+
+    CSSPropertiesRelease(expanded);
+    propertiesChanged(properties);
 }
 
 int CSSGetBold(CSSProperties *properties)
 {
-    return DFStringEquals(CSSGet(properties,"font-weight"),"bold");
+    return DFStringEquals(CSSGetID(properties,CSSPropertyFontWeight),"bold");
 }
 
 int CSSGetItalic(CSSProperties *properties)
 {
-    return DFStringEquals(CSSGet(properties,"font-style"),"italic");
+    return DFStringEquals(CSSGetID(properties,CSSPropertyFontStyle),"italic");
 }
 
 int CSSGetUnderline(CSSProperties *properties)
 {
-    return (CSSGet(properties,"text-decoration-underline") != NULL);
+    return (CSSGetID(properties,CSSPropertyTextDecorationUnderline) != NULL);
 }
 
 int CSSGetLinethrough(CSSProperties *properties)
 {
-    return (CSSGet(properties,"text-decoration-line-through") != NULL);
+    return (CSSGetID(properties,CSSPropertyTextDecorationLineThrough) != NULL);
 }
 
 int CSSGetOverline(CSSProperties *properties)
 {
-    return (CSSGet(properties,"text-decoration-overline") != NULL);
+    return (CSSGetID(properties,CSSPropertyTextDecorationOverline) != NULL);
 }
 
 int CSSGetDefault(CSSProperties *properties)
 {
-    return DFStringEquals(CSSGet(properties,"-uxwrite-default"),"true");
+    return DFStringEquals(CSSGetID(properties,CSSPropertyUxwriteDefault),"true");
 }
 
 void CSSSetBold(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"font-weight",value ? "bold" : NULL);
+    CSSPutID(properties,CSSPropertyFontWeight,value ? "bold" : NULL);
 }
 
 void CSSSetItalic(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"font-style",value ? "italic" : NULL);
+    CSSPutID(properties,CSSPropertyFontStyle,value ? "italic" : NULL);
 }
 
 void CSSSetUnderline(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"text-decoration-underline",value ? "underline" : NULL);
+    CSSPutID(properties,CSSPropertyTextDecorationUnderline,value ? "underline" : NULL);
 }
 
 void CSSSetLinethrough(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"text-decoration-line-through",value ? "line-through" : NULL);
+    CSSPutID(properties,CSSPropertyTextDecorationLineThrough,value ? "line-through" : NULL);
 }
 
 void CSSSetOverline(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"text-decoration-overline",value ? "overline" : NULL);
+    CSSPutID(properties,CSSPropertyTextDecorationOverline,value ? "overline" : NULL);
 }
 
 void CSSSetDefault(CSSProperties *properties, int value)
 {
-    CSSPut(properties,"-uxwrite-default",value ? "true" : NULL);
+    CSSPutID(properties,CSSPropertyUxwriteDefault,value ? "true" : NULL);
 }
 
 void CSSPropertiesPrint(CSSProperties *properties, const char *indent)
@@ -150,28 +260,18 @@ void CSSPropertiesPrint(CSSProperties *properties, const char *indent)
 
 CSSProperties *CSSPropertiesNewWithExtra(CSSProperties *orig, const char *string)
 {
-    DFHashTable *extra = CSSParseProperties(string);
-    CSSExpandProperties(extra);
-
-    CSSProperties *result = (CSSProperties *)xcalloc(1,sizeof(CSSProperties));
-    result->retainCount = 1;
-    result->hashTable = DFHashTableNew((DFCopyFunction)xstrdup,free);
-    const char **names = DFHashTableCopyKeys(orig->hashTable);
-    for (int i = 0; names[i]; i++) {
-        const char *value = DFHashTableLookup(orig->hashTable,names[i]);
-        DFHashTableAdd(result->hashTable,names[i],(void *)value);
-    }
-    free(names);
+    CSSProperties *extra = CSSPropertiesNewWithString(string);
 
-    const char **keys = DFHashTableCopyKeys(extra);
-    for (int i = 0; keys[i]; i++) {
-        const char *key = keys[i];
-        const char *value = DFHashTableLookup(extra,key);
-        DFHashTableAdd(result->hashTable,key,value);
+    CSSProperties *result = CSSPropertiesNew();
+    for (int id = CSSPropertyUnknown+1; id < CSSPropertyCount; id++) {
+        const char *value = (extra->values[id] != NULL) ? extra->values[id] : orig->values[id];
+        if (value != NULL)
+            setValue(result,id,NULL,value);
     }
-    free(keys);
+    setFromTable(result,orig->others);
+    setFromTable(result,extra->others);
 
-    DFHashTableRelease(extra);
+    CSSPropertiesRelease(extra);
     return result;
 }
 
@@ -180,7 +280,7 @@ CSSProperties *CSSPropertiesNewWithRaw(DFHashTable *raw)
     CSSProperties *result = (CSSProperties *)xcalloc(1,sizeof(CSSProperties));
     result->retainCount = 1;
 
-    result->hashTable = DFHashTableNew((DFCopyFunction)xstrdup,free);
+    result->others = DFHashTableNew((DFCopyFunction)xstrdup,free);
     if (raw != NULL)
         CSSPropertiesUpdateFromRaw(result,raw);
 
@@ -214,6 +314,7 @@ void CSSPropertiesRelease(CSSProperties *properties)
         return;
 
     assert(properties->changeCallbacks == NULL);
-    DFHashTableRelease(properties->hashTable);
+    clearValues(properties);
+    DFHashTableRelease(properties->others);
     free(properties);
 }
@@ -45,13 +45,16 @@
 
 #include "DFCallback.h"
 #include "DFHashTable.h"
+#include "CSSPropertyNames.h"
 
 typedef struct CSSProperties CSSProperties;
 
 struct CSSProperties {
     int retainCount;
     DFCallback *changeCallbacks;
-    DFHashTable *hashTable;
+    char *values[CSSPropertyCount]; // indexed by CSSPropertyID; values[CSSPropertyUnknown] is unused
+    unsigned int valuesCount;       // number of non-NULL entries in values
+    DFHashTable *others;            // properties with no CSSPropertyID
     int dirty;
 };
 
@@ -74,6 +77,11 @@ char *CSSPropertiesCopyDescription(CSSProperties *properties);
  */
 const char **CSSPropertiesCopyNames(CSSProperties *properties);
 
+/**
+ Retrieve a hash table containing a copy of all the properties. The caller must release it.
+ */
+DFHashTable *CSSPropertiesCopyTable(CSSProperties *properties);
+
 int CSSPropertiesIsEmpty(CSSProperties *properties);
 
 /**
@@ -88,6 +96,13 @@ const char *CSSGet(CSSProperties *properties, const char *name);
  */
 void CSSPut(CSSProperties *properties, const char *name, const char *value);
 
+/**
+ Equivalent to CSSGet() and CSSPut(), but taking one of the predefined property identifiers, so that
+ there is no need to look up the name. id must not be CSSPropertyUnknown.
+ */
+const char *CSSGetID(CSSProperties *properties, CSSPropertyID id);
+void CSSPutID(CSSProperties *properties, CSSPropertyID id, const char *value);
+
 /**
  Replace all properties in this object with those from the `raw` hash table, which contains
  collapsed properties. This function first expands the properties, as described above, and then
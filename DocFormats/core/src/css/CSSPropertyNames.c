@@ -0,0 +1,120 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "DFPlatform.h"
+#include "CSSPropertyNames.h"
+#include <string.h>
+
+static const char *CSSPropertyNames[CSSPropertyCount] = {
+    NULL,
+    "-uxwrite-default",
+    "-uxwrite-display-name",
+    "-uxwrite-next",
+    "-uxwrite-parent",
+    "-word-ilvl",
+    "-word-margin-left",
+    "-word-numId",
+    "background-color",
+    "border-bottom-color",
+    "border-bottom-left-radius",
+    "border-bottom-right-radius",
+    "border-bottom-style",
+    "border-bottom-width",
+    "border-left-color",
+    "border-left-style",
+    "border-left-width",
+    "border-right-color",
+    "border-right-style",
+    "border-right-width",
+    "border-top-color",
+    "border-top-left-radius",
+    "border-top-right-radius",
+    "border-top-style",
+    "border-top-width",
+    "bottom",
+    "caption-side",
+    "clear",
+    "color",
+    "content",
+    "counter-increment",
+    "counter-reset",
+    "direction",
+    "display",
+    "float",
+    "font-family",
+    "font-size",
+    "font-style",
+    "font-variant",
+    "font-weight",
+    "height",
+    "left",
+    "letter-spacing",
+    "line-height",
+    "list-style-type",
+    "margin-bottom",
+    "margin-left",
+    "margin-right",
+    "margin-top",
+    "max-width",
+    "min-width",
+    "padding-bottom",
+    "padding-left",
+    "padding-right",
+    "padding-top",
+    "page-break-after",
+    "page-break-before",
+    "position",
+    "right",
+    "size",
+    "text-align",
+    "text-decoration-line-through",
+    "text-decoration-overline",
+    "text-decoration-underline",
+    "text-indent",
+    "text-shadow",
+    "text-transform",
+    "top",
+    "vertical-align",
+    "visibility",
+    "white-space",
+    "width",
+};
+
+CSSPropertyID CSSPropertyIDForName(const char *name)
+{
+    int low = CSSPropertyUnknown + 1;
+    int high = CSSPropertyCount - 1;
+    while (low <= high) {
+        int mid = (low + high)/2;
+        int cmp = strcmp(name,CSSPropertyNames[mid]);
+        if (cmp == 0)
+            return (CSSPropertyID)mid;
+        else if (cmp < 0)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+    return CSSPropertyUnknown;
+}
+
+const char *CSSPropertyNameForID(CSSPropertyID id)
+{
+    if ((id <= CSSPropertyUnknown) || (id >= CSSPropertyCount))
+        return NULL;
+    return CSSPropertyNames[id];
+}
@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                         CSSPropertyNames                                       //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Numeric identifiers for the (expanded) CSS properties that DocFormats itself reads or writes.
+// CSSProperties objects store the values of these in a fixed array of slots, so they can be looked up
+// without hashing the name. Any other property is still supported, but is kept in a hash table
+// instead, and has the identifier CSSPropertyUnknown.
+//
+// The identifiers are in the same order as the (ASCII-sorted) names, which allows
+// CSSPropertyIDForName() to use a binary search. Keep it that way when adding to the list.
+
+typedef enum {
+    CSSPropertyUnknown = 0,
+    CSSPropertyUxwriteDefault,            // -uxwrite-default
+    CSSPropertyUxwriteDisplayName,        // -uxwrite-display-name
+    CSSPropertyUxwriteNext,               // -uxwrite-next
+    CSSPropertyUxwriteParent,             // -uxwrite-parent
+    CSSPropertyWordIlvl,                  // -word-ilvl
+    CSSPropertyWordMarginLeft,            // -word-margin-left
+    CSSPropertyWordNumId,                 // -word-numId
+    CSSPropertyBackgroundColor,           // background-color
+    CSSPropertyBorderBottomColor,         // border-bottom-color
+    CSSPropertyBorderBottomLeftRadius,    // border-bottom-left-radius
+    CSSPropertyBorderBottomRightRadius,   // border-bottom-right-radius
+    CSSPropertyBorderBottomStyle,         // border-bottom-style
+    CSSPropertyBorderBottomWidth,         // border-bottom-width
+    CSSPropertyBorderLeftColor,           // border-left-color
+    CSSPropertyBorderLeftStyle,           // border-left-style
+    CSSPropertyBorderLeftWidth,           // border-left-width
+    CSSPropertyBorderRightColor,          // border-right-color
+    CSSPropertyBorderRightStyle,          // border-right-style
+    CSSPropertyBorderRightWidth,          // border-right-width
+    CSSPropertyBorderTopColor,            // border-top-color
+    CSSPropertyBorderTopLeftRadius,       // border-top-left-radius
+    CSSPropertyBorderTopRightRadius,      // border-top-right-radius
+    CSSPropertyBorderTopStyle,            // border-top-style
+    CSSPropertyBorderTopWidth,            // border-top-width
+    CSSPropertyBottom,                    // bottom
+    CSSPropertyCaptionSide,               // caption-side
+    CSSPropertyClear,                     // clear
+    CSSPropertyColor,                     // color
+    CSSPropertyContent,                   // content
+    CSSPropertyCounterIncrement,          // counter-increment
+    CSSPropertyCounterReset,              // counter-reset
+    CSSPropertyDirection,                 // direction
+    CSSPropertyDisplay,                   // display
+    CSSPropertyFloat,                     // float
+    CSSPropertyFontFamily,                // font-family
+    CSSPropertyFontSize,                  // font-size
+    CSSPropertyFontStyle,                 // font-style
+    CSSPropertyFontVariant,               // font-variant
+    CSSPropertyFontWeight,                // font-weight
+    CSSPropertyHeight,                    // height
+    CSSPropertyLeft,                      // left
+    CSSPropertyLetterSpacing,             // letter-spacing
+    CSSPropertyLineHeight,                // line-height
+    CSSPropertyListStyleType,             // list-style-type
+    CSSPropertyMarginBottom,              // margin-bottom
+    CSSPropertyMarginLeft,                // margin-left
+    CSSPropertyMarginRight,               // margin-right
+    CSSPropertyMarginTop,                 // margin-top
+    CSSPropertyMaxWidth,                  // max-width
+    CSSPropertyMinWidth,                  // min-width
+    CSSPropertyPaddingBottom,             // padding-bottom
+    CSSPropertyPaddingLeft,               // padding-left
+    CSSPropertyPaddingRight,              // padding-right
+    CSSPropertyPaddingTop,                // padding-top
+    CSSPropertyPageBreakAfter,            // page-break-after
+    CSSPropertyPageBreakBefore,           // page-break-before
+    CSSPropertyPosition,                  // position
+    CSSPropertyRight,                     // right
+    CSSPropertySize,                      // size
+    CSSPropertyTextAlign,                 // text-align
+    CSSPropertyTextDecorationLineThrough, // text-decoration-line-through
+    CSSPropertyTextDecorationOverline,    // text-decoration-overline
+    CSSPropertyTextDecorationUnderline,   // text-decoration-underline
+    CSSPropertyTextIndent,                // text-indent
+    CSSPropertyTextShadow,                // text-shadow
+    CSSPropertyTextTransform,             // text-transform
+    CSSPropertyTop,                       // top
+    CSSPropertyVerticalAlign,             // vertical-align
+    CSSPropertyVisibility,                // visibility
+    CSSPropertyWhiteSpace,                // white-space
+    CSSPropertyWidth,                     // width
+    CSSPropertyCount,
+} CSSPropertyID;
+
+// Returns CSSPropertyUnknown if name is not one of the above
+CSSPropertyID CSSPropertyIDForName(const char *name);
+
+// Returns NULL for CSSPropertyUnknown
+const char *CSSPropertyNameForID(CSSPropertyID id);
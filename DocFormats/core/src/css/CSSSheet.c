@@ -40,14 +40,60 @@ struct CSSSheet {
     size_t retainCount;
     DFHashTable *_styles; // const char * -> CSSStyle
     DFHashTable *_defaultStyles; // int(StyleFamily) -> CSSStyle
+    DFHashTable *_flattened; // const char * -> FlattenedStyle
 };
 
+// A cached result of CSSSheetFlattenedStyle, along with the selectors of the styles it was built
+// from. Whenever one of those styles changes, the entry is discarded.
+
+typedef struct {
+    CSSStyle *style;
+    DFHashTable *sources; // atom -> ""
+} FlattenedStyle;
+
+static void FlattenedStyleFree(FlattenedStyle *flattened)
+{
+    CSSStyleRelease(flattened->style);
+    DFHashTableRelease(flattened->sources);
+    free(flattened);
+}
+
+static void styleChanged(void *ctx, void *object, void *data)
+{
+    CSSSheet *sheet = (CSSSheet *)ctx;
+    CSSStyle *style = (CSSStyle *)object;
+    const char **allSelectors = DFHashTableCopyKeys(sheet->_flattened);
+    for (int i = 0; allSelectors[i]; i++) {
+        FlattenedStyle *flattened = DFHashTableLookup(sheet->_flattened,allSelectors[i]);
+        if (DFHashTableLookupAtom(flattened->sources,style->selector) != NULL)
+            DFHashTableRemove(sheet->_flattened,allSelectors[i]);
+    }
+    free(allSelectors);
+    // The style only notifies us of its first change until this is cleared
+    style->dirty = 0;
+}
+
+static void removeAllStyles(CSSSheet *sheet)
+{
+    const char **allSelectors = DFHashTableCopyKeys(sheet->_styles);
+    for (int i = 0; allSelectors[i]; i++) {
+        CSSStyle *style = DFHashTableLookup(sheet->_styles,allSelectors[i]);
+        DFCallbackRemove(&style->changeCallbacks,styleChanged,sheet);
+    }
+    free(allSelectors);
+    DFHashTableRelease(sheet->_styles);
+    sheet->_styles = DFHashTableNewWithAtomKeys((DFCopyFunction)CSSStyleRetain,(DFFreeFunction)CSSStyleRelease);
+    DFHashTableRelease(sheet->_flattened);
+    sheet->_flattened = DFHashTableNewWithAtomKeys(NULL,(DFFreeFunction)FlattenedStyleFree);
+}
+
 CSSSheet *CSSSheetNew(void)
 {
     CSSSheet *sheet = (CSSSheet *)xcalloc(1,sizeof(CSSSheet));
     sheet->retainCount = 1;
-    sheet->_styles = DFHashTableNew((DFCopyFunction)CSSStyleRetain,(DFFreeFunction)CSSStyleRelease);
+    sheet->_styles = DFHashTableNewWithAtomKeys((DFCopyFunction)CSSStyleRetain,(DFFreeFunction)CSSStyleRelease);
     sheet->_defaultStyles = DFHashTableNew((DFCopyFunction)CSSStyleRetain,(DFFreeFunction)CSSStyleRelease);
+    sheet->_flattened = DFHashTableNewWithAtomKeys(NULL,(DFFreeFunction)FlattenedStyleFree);
     return sheet;
 }
 
@@ -63,8 +109,10 @@ void CSSSheetRelease(CSSSheet *sheet)
     if ((sheet == NULL) || (--sheet->retainCount > 0))
         return;
 
+    removeAllStyles(sheet);
     DFHashTableRelease(sheet->_styles);
     DFHashTableRelease(sheet->_defaultStyles);
+    DFHashTableRelease(sheet->_flattened);
     free(sheet);
 }
 
@@ -76,12 +124,28 @@ const char **CSSSheetCopySelectors(CSSSheet *sheet)
 void CSSSheetAddStyle(CSSSheet *sheet, CSSStyle *style)
 {
     assert(style->selector != NULL);
-    DFHashTableAdd(sheet->_styles,style->selector,style);
+    CSSStyle *old = DFHashTableLookupAtom(sheet->_styles,style->selector);
+    if (old == style)
+        return;
+    if (old != NULL)
+        DFCallbackRemove(&old->changeCallbacks,styleChanged,sheet);
+    DFCallbackAdd(&style->changeCallbacks,styleChanged,sheet);
+    style->dirty = 0;
+    DFHashTableAddAtom(sheet->_styles,style->selector,style);
+
+    // The new style may be the parent of others, which previously had none
+    DFHashTableRelease(sheet->_flattened);
+    sheet->_flattened = DFHashTableNewWithAtomKeys(NULL,(DFFreeFunction)FlattenedStyleFree);
 }
 
 void CSSSheetRemoveStyle(CSSSheet *sheet, CSSStyle *style)
 {
-    DFHashTableRemove(sheet->_styles,style->selector);
+    if (DFHashTableLookupAtom(sheet->_styles,style->selector) != style)
+        return;
+    DFCallbackRemove(&style->changeCallbacks,styleChanged,sheet);
+    DFHashTableRemoveAtom(sheet->_styles,style->selector);
+    DFHashTableRelease(sheet->_flattened);
+    sheet->_flattened = DFHashTableNewWithAtomKeys(NULL,(DFFreeFunction)FlattenedStyleFree);
 }
 
 CSSStyle *CSSSheetLookupSelector(CSSSheet *sheet, const char *selector, int add, int latent)
@@ -108,10 +172,18 @@ CSSStyle *CSSSheetLookupElement(CSSSheet *sheet, const char *elementName, const
 
 CSSStyle *CSSSheetFlattenedStyle(CSSSheet *sheet, CSSStyle *orig)
 {
+    // Only styles which belong to the sheet are cached, since we are not notified of changes to others
+    int cache = (DFHashTableLookupAtom(sheet->_styles,orig->selector) == orig);
+    if (cache) {
+        FlattenedStyle *flattened = DFHashTableLookupAtom(sheet->_flattened,orig->selector);
+        if (flattened != NULL)
+            return CSSStyleRetain(flattened->style);
+    }
+
     // FIXME: Need tests for parent cycles
     CSSStyle *ancestor = orig;
     CSSStyle *result = CSSStyleNew("temp");
-    DFHashTable *visited = DFHashTableNew((DFCopyFunction)xstrdup,(DFFreeFunction)free);
+    DFHashTable *visited = DFHashTableNewWithAtomKeys(NULL,NULL);
     const char **allSuffixes = NULL;
     while (1) {
         free(allSuffixes);
@@ -131,12 +203,19 @@ CSSStyle *CSSSheetFlattenedStyle(CSSSheet *sheet, CSSStyle *orig)
             }
             free(allNames);
         }
-        DFHashTableAdd(visited,ancestor->selector,"");
+        DFHashTableAddAtom(visited,ancestor->selector,"");
         ancestor = CSSSheetGetStyleParent(sheet,ancestor);
-        if ((ancestor == NULL) || (DFHashTableLookup(visited,ancestor->selector) != NULL))
+        if ((ancestor == NULL) || (DFHashTableLookupAtom(visited,ancestor->selector) != NULL))
             break;
     }
     free(allSuffixes);
+
+    if (cache) {
+        FlattenedStyle *flattened = (FlattenedStyle *)xcalloc(1,sizeof(FlattenedStyle));
+        flattened->style = CSSStyleRetain(result);
+        flattened->sources = DFHashTableRetain(visited);
+        DFHashTableAddAtom(sheet->_flattened,orig->selector,flattened);
+    }
     DFHashTableRelease(visited);
     return result;
 }
@@ -340,8 +419,7 @@ static void removeRedundantProperties(CSSSheet *sheet)
 static void updateFromRawCSSRules(CSSSheet *sheet, DFHashTable *rules)
 {
     // FIXME: Handle class names containing escape sequences
-    DFHashTableRelease(sheet->_styles);
-    sheet->_styles = DFHashTableNew((DFCopyFunction)CSSStyleRetain,(DFFreeFunction)CSSStyleRelease);
+    removeAllStyles(sheet);
 
     const char **sortedSelectors = DFHashTableCopyKeys(rules);
     DFSortStringsCaseInsensitive(sortedSelectors);
@@ -378,7 +456,7 @@ static void updateFromRawCSSRules(CSSSheet *sheet, DFHashTable *rules)
         free(allNames);
 
         if (!strcmp(suffix,"")) {
-            const char *defaultVal = CSSGet(properties,"-uxwrite-default");
+            const char *defaultVal = CSSGetID(properties,CSSPropertyUxwriteDefault);
             if ((defaultVal != NULL) && DFStringEqualsCI(defaultVal,"true"))
                 CSSSheetSetDefaultStyle(sheet,style,StyleFamilyFromHTMLTag(style->tag));
         }
@@ -463,9 +541,9 @@ int CSSSheetHeadingNumbering(CSSSheet *sheet)
         CSSStyle *style = CSSSheetLookupSelector(sheet,allSelectors[i],0,0);
         if (style->headingLevel == 0)
             continue;
-        if (CSSGet(CSSStyleBefore(style),"content") == NULL)
+        if (CSSGetID(CSSStyleBefore(style),CSSPropertyContent) == NULL)
             continue;
-        DFArray *contentParts = CSSParseContent(CSSGet(CSSStyleBefore(style),"content"));
+        DFArray *contentParts = CSSParseContent(CSSGetID(CSSStyleBefore(style),CSSPropertyContent));
         for (size_t partIndex = 0; partIndex < DFArrayCount(contentParts); partIndex++) {
             ContentPart *part = DFArrayItemAt(contentParts,partIndex);
             if (part->type == ContentPartCounter) {
@@ -527,10 +605,10 @@ static void enableNumberingForStyle(CSSStyle *style)
     DFBufferFormat(content," \" \"");
 
     CSSProperties *rule = CSSStyleRule(style);
-    CSSPut(rule,"counter-increment",style->elementName);
+    CSSPutID(rule,CSSPropertyCounterIncrement,style->elementName);
     if (reset->len > 0)
-        CSSPut(rule,"counter-reset",reset->data);
-    CSSPut(CSSStyleBefore(style),"content",content->data);
+        CSSPutID(rule,CSSPropertyCounterReset,reset->data);
+    CSSPutID(CSSStyleBefore(style),CSSPropertyContent,content->data);
     style->latent = 0;
 
     DFBufferRelease(reset);
@@ -544,16 +622,16 @@ static void disableNumberingForStyle(CSSStyle *style, int explicitly)
     if (explicitly) {
         // FIXME: Not covered by tests
         char *increment = DFFormatString("h%d 0",style->headingLevel);
-        CSSPut(rule,"counter-increment",increment);
-        CSSPut(rule,"counter-reset","null");
-        CSSPut(before,"content","\"\"");
+        CSSPutID(rule,CSSPropertyCounterIncrement,increment);
+        CSSPutID(rule,CSSPropertyCounterReset,"null");
+        CSSPutID(before,CSSPropertyContent,"\"\"");
         style->latent = 0;
         free(increment);
     }
     else {
-        CSSPut(rule,"counter-increment",NULL);
-        CSSPut(rule,"counter-reset",NULL);
-        CSSPut(before,"content",NULL);
+        CSSPutID(rule,CSSPropertyCounterIncrement,NULL);
+        CSSPutID(rule,CSSPropertyCounterReset,NULL);
+        CSSPutID(before,CSSPropertyContent,NULL);
     }
 }
 
@@ -616,9 +694,9 @@ void CSSSheetSetHeadingNumbering(CSSSheet *sheet, int enabled)
         for (int i = 0; allSelectors[i]; i++) {
             CSSStyle *style = CSSSheetLookupSelector(sheet,allSelectors[i],0,0);
             if (style->headingLevel > 0) {
-                CSSPut(CSSStyleRule(style),"counter-increment",NULL);
-                CSSPut(CSSStyleRule(style),"counter-reset",NULL);
-                CSSPut(CSSStyleBefore(style),"content",NULL);
+                CSSPutID(CSSStyleRule(style),CSSPropertyCounterIncrement,NULL);
+                CSSPutID(CSSStyleRule(style),CSSPropertyCounterReset,NULL);
+                CSSPutID(CSSStyleBefore(style),CSSPropertyContent,NULL);
             }
         }
         free(allSelectors);
@@ -630,12 +708,12 @@ void CSSSheetSetHeadingNumbering(CSSSheet *sheet, int enabled)
 int CSSSheetIsNumberingUsed(CSSSheet *sheet)
 {
     CSSStyle *style = CSSSheetLookupElement(sheet,"body",NULL,0,0);
-    return (CSSGet(CSSStyleRule(style),"counter-reset") != NULL);
+    return (CSSGetID(CSSStyleRule(style),CSSPropertyCounterReset) != NULL);
 }
 
 int CSSStyleIsNumbered(CSSStyle *style)
 {
-    const char *beforeContent = CSSGet(CSSStyleBefore(style),"content");
+    const char *beforeContent = CSSGetID(CSSStyleBefore(style),CSSPropertyContent);
     return ((beforeContent != NULL) && !DFStringEquals(beforeContent,"\"\""));
 }
 
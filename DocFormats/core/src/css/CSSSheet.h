@@ -176,8 +176,12 @@ CSSStyle *CSSSheetLookupElement(CSSSheet *sheet, const char *elementName, const
  defined; browsers don't know about the special `-uxwrite-parent` property and cannot infer that
  the style is inherited.
 
- Unlike all other CSSSheet methods, the CSSStyle object returned by this function is newly
- allocated, and the caller must call CSSStyleRelease on the object when finished with it.
+ Unlike all other CSSSheet methods, the CSSStyle object returned by this function is retained on
+ behalf of the caller, who must call CSSStyleRelease on the object when finished with it.
+
+ For styles that belong to the sheet, the result is cached, and the same object is returned on
+ subsequent calls until the style or one of its ancestors changes, or styles are added to or
+ removed from the sheet. It therefore must not be modified.
  */
 CSSStyle *CSSSheetFlattenedStyle(CSSSheet *sheet, CSSStyle *orig);
 
@@ -21,6 +21,7 @@
 #include "CSSProperties.h"
 #include "CSSSelector.h"
 #include "DFHTML.h"
+#include "DFAtom.h"
 #include "DFHashTable.h"
 #include "DFString.h"
 #include "DFCommon.h"
@@ -79,7 +80,7 @@ void CSSStyleRelease(CSSStyle *style)
     if ((style == NULL) || (--style->retainCount > 0))
         return;
 
-    free(style->selector);
+    DFAtomRelease(style->selector);
     free(style->elementName);
     free(style->className);
     const char **keys = DFHashTableCopyKeys(style->rules);
@@ -95,10 +96,10 @@ void CSSStyleRelease(CSSStyle *style)
 
 void CSSStyleSetSelector(CSSStyle *style, const char *newSelector)
 {
-    // Take a copy of newSelector first, just in case it's one of the values we're about to free
-    char *selector = xstrdup(newSelector);
+    // Get the atom for newSelector first, just in case it's one of the values we're about to free
+    const char *selector = DFAtomGet(newSelector);
 
-    free(style->selector);
+    DFAtomRelease(style->selector);
     free(style->elementName);
     free(style->className);
 
@@ -121,40 +122,40 @@ int CSSStyleIsCustom(CSSStyle *style)
 
 char *CSSStyleCopyParent(CSSStyle *style)
 {
-    const char *quotedValue = CSSGet(CSSStyleRule(style),"-uxwrite-parent");
+    const char *quotedValue = CSSGetID(CSSStyleRule(style),CSSPropertyUxwriteParent);
     return DFUnquote(quotedValue);
 }
 
 void CSSStyleSetParent(CSSStyle *style, const char *newParent)
 {
     char *quotedParent = DFQuote(newParent);
-    CSSPut(CSSStyleRule(style),"-uxwrite-parent",quotedParent);
+    CSSPutID(CSSStyleRule(style),CSSPropertyUxwriteParent,quotedParent);
     free(quotedParent);
 }
 
 char *CSSStyleCopyNext(CSSStyle *style)
 {
-    const char *quotedValue = CSSGet(CSSStyleRule(style),"-uxwrite-next");
+    const char *quotedValue = CSSGetID(CSSStyleRule(style),CSSPropertyUxwriteNext);
     return DFUnquote(quotedValue);
 }
 
 void CSSStyleSetNext(CSSStyle *style, const char *newNext)
 {
     char *quotedNext = DFQuote(newNext);
-    CSSPut(CSSStyleRule(style),"-uxwrite-next",quotedNext);
+    CSSPutID(CSSStyleRule(style),CSSPropertyUxwriteNext,quotedNext);
     free(quotedNext);
 }
 
 char *CSSStyleCopyDisplayName(CSSStyle *style)
 {
-    const char *quotedValue = CSSGet(CSSStyleRule(style),"-uxwrite-display-name");
+    const char *quotedValue = CSSGetID(CSSStyleRule(style),CSSPropertyUxwriteDisplayName);
     return DFUnquote(quotedValue);
 }
 
 void CSSStyleSetDisplayName(CSSStyle *style, const char *newDisplayName)
 {
     char *quotedDisplayName = DFQuote(newDisplayName);
-    CSSPut(CSSStyleRule(style),"-uxwrite-display-name",quotedDisplayName);
+    CSSPutID(CSSStyleRule(style),CSSPropertyUxwriteDisplayName,quotedDisplayName);
     free(quotedDisplayName);
 }
 
@@ -233,7 +234,7 @@ int CSSStyleIsEmpty(CSSStyle *style)
     for (int i = 0; allSuffixes[i]; i++) {
         const char *suffix = allSuffixes[i];
         CSSProperties *properties = CSSStyleRuleForSuffix(style,suffix);
-        if (DFHashTableCount(properties->hashTable) > 0) {
+        if (!CSSPropertiesIsEmpty(properties)) {
             free(allSuffixes);
             return 0;
         }
@@ -260,40 +261,40 @@ void CSSStyleAddDefaultHTMLProperties(CSSStyle *style)
     if ((className == NULL) && (strlen(elementName) == 2) && (elementName[0] == 'h')) {
         CSSProperties *rule = CSSStyleRule(style);
         if (!strcmp(elementName,"h1")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","24pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"24pt");
         }
         else if (!strcmp(elementName,"h2")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","18pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"18pt");
         }
         else if (!strcmp(elementName,"h3")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","14pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"14pt");
         }
         else if (!strcmp(elementName,"h4")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","12pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"12pt");
         }
         else if (!strcmp(elementName,"h5")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","10pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"10pt");
         }
         else if (!strcmp(elementName,"h6")) {
-            if (CSSGet(rule,"font-weight") == NULL)
-                CSSPut(rule,"font-weight","bold");
-            if (CSSGet(rule,"font-size") == NULL)
-                CSSPut(rule,"font-size","8pt");
+            if (CSSGetID(rule,CSSPropertyFontWeight) == NULL)
+                CSSPutID(rule,CSSPropertyFontWeight,"bold");
+            if (CSSGetID(rule,CSSPropertyFontSize) == NULL)
+                CSSPutID(rule,CSSPropertyFontSize,"8pt");
         }
     }
     free(elementName);
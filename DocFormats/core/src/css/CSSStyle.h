@@ -148,7 +148,7 @@ typedef struct CSSStyle CSSStyle;
 struct CSSStyle {
     size_t retainCount;
 
-    char *selector;
+    const char *selector; // an atom (see DFAtom.h)
     char *elementName;
     char *className;
     Tag tag;
@@ -104,8 +104,23 @@ static void removeSpecial(TidyDoc doc, TidyNode node)
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Tidy keeps some state in globals, such as its character class table, which every call to
+// tidyCreate writes to. So that documents can be converted on several threads at once, only one
+// thread at a time may have a DFHTDocument; others wait in DFHTDocumentNew until it is freed.
+
+static DFMutex *tidyLock = NULL;
+
+static void initTidyLock(void)
+{
+    tidyLock = DFMutexNew();
+}
+
 DFHTDocument *DFHTDocumentNew()
 {
+    static DFOnce once = DF_ONCE_INIT;
+    DFInitOnce(&once,initTidyLock);
+    DFMutexLock(tidyLock);
+
     DFHTDocument *htd = (DFHTDocument *)xcalloc(1,sizeof(DFHTDocument));
     htd->doc = tidyCreate();
     tidyBufInit(&htd->errbuf);
@@ -124,6 +139,7 @@ void DFHTDocumentFree(DFHTDocument *htd)
     tidyRelease(htd->doc);
     tidyBufFree(&htd->errbuf);
     free(htd);
+    DFMutexUnlock(tidyLock);
 }
 
 int DFHTDocumentParseCString(DFHTDocument *htd, const char *str, DFError **error)
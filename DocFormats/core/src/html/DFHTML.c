@@ -30,8 +30,12 @@
 #include "DFXML.h"
 #include "DFString.h"
 #include "DFCharacterSet.h"
+#include "DFAllocator.h"
 #include "DFCommon.h"
 
+// Block size for the memory of documents parsed from HTML; see DFParseHTMLString
+#define HTML_ARENA_BLOCK_SIZE 4096
+
 static DFNode *HTML_findHead(DFDocument *doc)
 {
     for (DFNode *child1 = doc->docNode->first; child1 != NULL; child1 = child1->next) {
@@ -310,10 +314,10 @@ CSSSize HTML_getImageDimensions(DFNode *img)
     const char *styleAttr = DFGetAttribute(img,HTML_STYLE);
     if (styleAttr != NULL) {
         CSSProperties *properties = CSSPropertiesNewWithString(styleAttr);
-        if (CSSGet(properties,"width") != NULL)
-            dimensions.width = CSSLengthFromString(CSSGet(properties,"width"));
-        if (CSSGet(properties,"height") != NULL)
-            dimensions.height = CSSLengthFromString(CSSGet(properties,"height"));
+        if (CSSGetID(properties,CSSPropertyWidth) != NULL)
+            dimensions.width = CSSLengthFromString(CSSGetID(properties,CSSPropertyWidth));
+        if (CSSGetID(properties,CSSPropertyHeight) != NULL)
+            dimensions.height = CSSLengthFromString(CSSGetID(properties,CSSPropertyHeight));
         CSSPropertiesRelease(properties);
     }
 
@@ -423,7 +427,11 @@ DFDocument *DFParseHTMLString(const char *str, int removeSpecial, DFError **erro
     }
     if (removeSpecial)
         DFHTDocumentRemoveUXWriteSpecial(htdoc);;
-    DFDocument *doc = DFDocumentNew();
+    // fromTidyNode frees the Tidy tree as it goes. Allocating the new document in small blocks lets
+    // it reuse that memory; large blocks would be mapped separately, and both trees would be held
+    // in memory in full.
+    DFAllocator *allocator = DFAllocatorNewWithSize(HTML_ARENA_BLOCK_SIZE,HTML_ARENA_BLOCK_SIZE);
+    DFDocument *doc = DFDocumentNewWithAllocator(allocator);
     DFNode *root = fromTidyNode(doc,htdoc->doc,tidyGetHtml(htdoc->doc));
     if (root == NULL) {
         DFErrorFormat(error,"No root element");
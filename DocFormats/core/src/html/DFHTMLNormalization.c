@@ -35,7 +35,7 @@ static void removeWhitespaceTextChildren(DFNode *node)
     for (DFNode *child = node->first; child != NULL; child = next) {
         next = child->next;
         if (DFIsWhitespaceNode(child))
-            DFRemoveNode(child);
+            DFDestroyNode(child);
     }
 }
 
@@ -99,7 +99,7 @@ static void mergeAdjacentTextNodes(DFNode *node)
             char *mergedValue = DFFormatString("%s%s",value,nextValue);
             DFSetNodeValue(child,mergedValue);
             free(mergedValue);
-            DFRemoveNode(child->next);
+            DFDestroyNode(child->next);
         }
         else {
             child = child->next;
@@ -226,7 +226,7 @@ static void fixParagraphWhitespace(DFNode *paragraph)
         LeafEntry *entry = DFArrayItemAt(leafEntries,i);
         DFNode *node = entry->node;
         if ((node->tag == DOM_TEXT) && (strlen(node->value) == 0))
-            DFRemoveNode(node);
+            DFDestroyNode(node);
     }
     DFArrayRelease(leafEntries);
 }
@@ -243,14 +243,14 @@ static void mergeWithPrev(DFNode *node)
             char *mergedValue = DFFormatString("%s%s",prevValue,curValue);
             DFSetNodeValue(prevText,mergedValue);
             free(mergedValue);
-            DFRemoveNode(node->first);
+            DFDestroyNode(node->first);
         }
         else {
             DFAppendChild(prev,node->first);
         }
     }
 
-    DFRemoveNode(node);
+    DFDestroyNode(node);
 }
 
 static void mergeWithNext(DFNode *node)
@@ -265,13 +265,13 @@ static void mergeWithNext(DFNode *node)
             char *mergedValue = DFFormatString("%s%s",curValue,nextValue);
             DFSetNodeValue(nextText,mergedValue);
             free(mergedValue);
-            DFRemoveNode(node->last);
+            DFDestroyNode(node->last);
         }
         else {
             DFInsertBefore(next,node->last,next->first);
         }
     }
-    DFRemoveNode(node);
+    DFDestroyNode(node);
 }
 
 static int canMergeText(DFNode *a, DFNode *b)
@@ -22,28 +22,28 @@
 #include "DFNameMap.h"
 #include "DFCommon.h"
 
-char *copyTidyNodeValue(TidyNode tnode, TidyDoc tdoc)
-{
-    TidyBuffer buf;
-    tidyBufInit(&buf);
-    tidyNodeGetValue(tdoc,tnode,&buf);
-
-    char *str = (char *)xmalloc(buf.size+1);
-    memcpy(str,buf.bp,buf.size);
-    str[buf.size] = '\0';
+// Tags for HTML names are looked up directly in the predefined tags, which covers nearly all of
+// them, rather than hashing the namespace URI for every element and attribute
 
-    tidyBufFree(&buf);
-    return str;
+static Tag htmlTagForName(DFDocument *htmlDoc, const char *name)
+{
+    Tag tag = DFLookupPredefinedTag(NAMESPACE_HTML,name);
+    if (tag == 0)
+        tag = DFNameMapTagForName(htmlDoc->map,PredefinedNamespaces[NAMESPACE_HTML].namespaceURI,name);
+    return tag;
 }
 
+// Each Tidy node is discarded as soon as it has been converted, so that the memory used by the
+// parts of the Tidy tree already processed is available for the new document, instead of both
+// complete trees being held at once. Text is copied directly from Tidy's lexer buffer.
+
 DFNode *fromTidyNode(DFDocument *htmlDoc, TidyDoc tdoc, TidyNode tnode)
 {
     switch (tidyNodeGetType(tnode)) {
         case TidyNode_Text: {
-            char *value = copyTidyNodeValue(tnode,tdoc);
-            DFNode *result = DFCreateTextNode(htmlDoc,value);
-            free(value);
-            return result;
+            uint len = 0;
+            const char *value = tidyNodeGetValuePtr(tdoc,tnode,&len);
+            return DFCreateTextNodeLen(htmlDoc,(value != NULL) ? value : "",len);
         }
         case TidyNode_CDATA:
             break;
@@ -58,23 +58,24 @@ DFNode *fromTidyNode(DFDocument *htmlDoc, TidyDoc tdoc, TidyNode tnode)
                 printf("NULL name for %p, type %d\n",tnode,tidyNodeGetType(tnode));
                 return NULL;
             }
-            const NamespaceDecl *namespaceDecl = DFNameMapNamespaceForID(htmlDoc->map,NAMESPACE_HTML);
-            Tag tag = DFNameMapTagForName(htmlDoc->map,namespaceDecl->namespaceURI,name);
-            DFNode *element = DFCreateElement(htmlDoc,tag);
+            DFNode *element = DFCreateElement(htmlDoc,htmlTagForName(htmlDoc,name));
 
             for (TidyAttr tattr = tidyAttrFirst(tnode); tattr != NULL; tattr = tidyAttrNext(tattr)) {
                 const char *name = tidyAttrName(tattr);
                 const char *value = tidyAttrValue(tattr);
                 if (value == NULL) // Can happen in case of the empty string
                     value = "";;
-                Tag attrTag = DFNameMapTagForName(htmlDoc->map,namespaceDecl->namespaceURI,name);
-                DFSetAttribute(element,attrTag,value);
+                DFSetAttribute(element,htmlTagForName(htmlDoc,name),value);
             }
 
-            for (TidyNode tchild = tidyGetChild(tnode); tchild != NULL; tchild = tidyGetNext(tchild)) {
+            TidyNode tchild = tidyGetChild(tnode);
+            while (tchild != NULL) {
                 DFNode *child = fromTidyNode(htmlDoc,tdoc,tchild);
                 if (child != NULL)
                     DFAppendChild(element,child);
+                TidyNode next = tidyGetNext(tchild);
+                tidyDiscardElement(tdoc,tchild);
+                tchild = next;
             }
             return element;
         }
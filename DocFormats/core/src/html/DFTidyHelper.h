@@ -20,5 +20,4 @@
 #include "DFDOM.h"
 #include "tidy.h"
 
-char *copyTidyNodeValue(TidyNode tnode, TidyDoc tdoc);
 DFNode *fromTidyNode(DFDocument *htmlDoc, TidyDoc tdoc, TidyNode tnode);
@@ -20,6 +20,25 @@
 #include "DFCommon.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+
+// When built with AddressSanitizer, recycled chunks are poisoned until they are handed out again,
+// so that anything still using a value after it has been replaced is reported
+
+#if defined(__SANITIZE_ADDRESS__)
+#define DF_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define DF_ASAN 1
+#endif
+#endif
+
+#ifdef DF_ASAN
+#include <sanitizer/asan_interface.h>
+#else
+#define ASAN_POISON_MEMORY_REGION(addr,size) ((void)(addr),(void)(size))
+#define ASAN_UNPOISON_MEMORY_REGION(addr,size) ((void)(addr),(void)(size))
+#endif
 
 typedef struct DFAllocatorBlock DFAllocatorBlock;
 
@@ -30,20 +49,63 @@ struct DFAllocatorBlock {
     char ATTRIBUTE_ALIGNED(8) mem[0];
 };
 
+// Recycled memory is kept in a separate free list for each multiple of 8 bytes, up to
+// MAX_RECYCLED_SIZE. The first word of each free chunk points to the next one in the list.
+
+#define MAX_RECYCLED_SIZE 256
+#define SIZE_CLASS_COUNT (MAX_RECYCLED_SIZE/8)
+
+typedef struct DFAllocatorChunk DFAllocatorChunk;
+
+struct DFAllocatorChunk {
+    DFAllocatorChunk *next;
+};
+
 struct DFAllocator {
     DFAllocatorBlock *blocks;
     unsigned int blockCount;
+    size_t nextBlockSize;
+    size_t maxBlockSize;
+    size_t recycledBytes;
+    DFAllocatorChunk *freeLists[SIZE_CLASS_COUNT];
 };
 
+static size_t roundSize(size_t size)
+{
+    size_t remainder = size % 8;
+    if (remainder != 0)
+        size += (8 - remainder);
+    return size;
+}
+
+static DFAllocatorBlock *DFAllocatorBlockNew(size_t size)
+{
+    DFAllocatorBlock *block = (DFAllocatorBlock *)xmalloc(sizeof(DFAllocatorBlock)+size);
+    block->next = NULL;
+    block->used = 0;
+    block->size = size;
+    return block;
+}
+
 DFAllocator *DFAllocatorNew(void)
 {
-    size_t initialSize = 1;
-    DFAllocator *alc = (DFAllocator *)xmalloc(sizeof(DFAllocator));
-    alc->blocks = (DFAllocatorBlock *)xmalloc(sizeof(DFAllocatorBlock)+initialSize);
-    alc->blocks->next = NULL;
-    alc->blocks->used = 0;
-    alc->blocks->size = initialSize;
+    return DFAllocatorNewWithSize(0,0);
+}
+
+DFAllocator *DFAllocatorNewWithSize(size_t initialSize, size_t maxBlockSize)
+{
+    if (maxBlockSize == 0)
+        maxBlockSize = DF_ALLOCATOR_MAX_BLOCK_SIZE;
+    if (initialSize == 0)
+        initialSize = DF_ALLOCATOR_INITIAL_SIZE;
+    initialSize = roundSize(initialSize);
+    maxBlockSize = roundSize(maxBlockSize);
+
+    DFAllocator *alc = (DFAllocator *)xcalloc(1,sizeof(DFAllocator));
+    alc->blocks = DFAllocatorBlockNew(initialSize);
     alc->blockCount = 1;
+    alc->maxBlockSize = maxBlockSize;
+    alc->nextBlockSize = (initialSize < maxBlockSize/2) ? 2*initialSize : maxBlockSize;
     return alc;
 }
 
@@ -57,22 +119,41 @@ void DFAllocatorFree(DFAllocator *alc)
     free(alc);
 }
 
+// When the current block is full, a new one is started, with each being twice the size of the
+// previous one, up to maxBlockSize. Allocations too large to sensibly share a block with others are
+// given a block of their own, which is placed after the current one, so that the space remaining in
+// the latter is not wasted.
+
 void *DFAllocatorAlloc(DFAllocator *alc, size_t size)
 {
-    size_t remainder = size % 8;
-    if (remainder != 0)
-        size += (8 - remainder);
+    size = roundSize(size);
+    if ((size > 0) && (size <= MAX_RECYCLED_SIZE)) {
+        DFAllocatorChunk *chunk = alc->freeLists[size/8 - 1];
+        if (chunk != NULL) {
+            ASAN_UNPOISON_MEMORY_REGION(chunk,size);
+            alc->freeLists[size/8 - 1] = chunk->next;
+            alc->recycledBytes -= size;
+            return chunk;
+        }
+    }
     struct DFAllocatorBlock *block = alc->blocks;
     if (size > block->size - block->used) {
-        size_t newSize = block->size*2;
-        while (size > newSize)
-            newSize *= 2;
-        block = (DFAllocatorBlock *)xmalloc(sizeof(DFAllocatorBlock)+newSize);
-        block->used = 0;
-        block->size = newSize;
+        if (size > alc->nextBlockSize/2) {
+            DFAllocatorBlock *large = DFAllocatorBlockNew(size);
+            large->used = size;
+            large->next = block->next;
+            block->next = large;
+            alc->blockCount++;
+            return large->mem;
+        }
+        block = DFAllocatorBlockNew(alc->nextBlockSize);
         block->next = alc->blocks;
         alc->blocks = block;
         alc->blockCount++;
+        if (alc->nextBlockSize < alc->maxBlockSize/2)
+            alc->nextBlockSize *= 2;
+        else
+            alc->nextBlockSize = alc->maxBlockSize;
     }
     char *mem = block->mem + block->used;
     block->used += size;
@@ -80,3 +161,43 @@ void *DFAllocatorAlloc(DFAllocator *alc, size_t size)
     assert((((unsigned long)mem) % 8) == 0);
     return mem;
 }
+
+void DFAllocatorRecycle(DFAllocator *alc, void *ptr, size_t size)
+{
+    size = roundSize(size);
+    if ((ptr == NULL) || (size == 0) || (size > MAX_RECYCLED_SIZE))
+        return;
+    assert((((unsigned long)ptr) % 8) == 0);
+    DFAllocatorChunk *chunk = (DFAllocatorChunk *)ptr;
+    chunk->next = alc->freeLists[size/8 - 1];
+    alc->freeLists[size/8 - 1] = chunk;
+    alc->recycledBytes += size;
+    ASAN_POISON_MEMORY_REGION(chunk,size);
+}
+
+int DFAllocatorExtend(DFAllocator *alc, void *ptr, size_t oldSize, size_t newSize)
+{
+    oldSize = roundSize(oldSize);
+    newSize = roundSize(newSize);
+    DFAllocatorBlock *block = alc->blocks;
+    if ((ptr == NULL) || (oldSize > block->used) || ((char *)ptr != block->mem + block->used - oldSize))
+        return 0;
+    if (newSize > block->size - block->used + oldSize)
+        return 0;
+    block->used = block->used - oldSize + newSize;
+    return 1;
+}
+
+void DFAllocatorGetStats(DFAllocator *alc, DFAllocatorStats *stats)
+{
+    bzero(stats,sizeof(DFAllocatorStats));
+    for (DFAllocatorBlock *block = alc->blocks; block != NULL; block = block->next) {
+        stats->blockCount++;
+        stats->totalBytes += block->size;
+        stats->usedBytes += block->used;
+        if (block != alc->blocks)
+            stats->wastedBytes += block->size - block->used;
+    }
+    stats->usedBytes -= alc->recycledBytes;
+    stats->recycledBytes = alc->recycledBytes;
+}
@@ -21,6 +21,36 @@
 
 typedef struct DFAllocator DFAllocator;
 
+// Block sizes used when none are given to DFAllocatorNewWithSize
+#define DF_ALLOCATOR_INITIAL_SIZE  1024
+#define DF_ALLOCATOR_MAX_BLOCK_SIZE (16*1024*1024)
+
+typedef struct {
+    size_t blockCount;    // Number of blocks obtained from malloc
+    size_t totalBytes;    // Combined size of those blocks
+    size_t usedBytes;     // Memory currently handed out by DFAllocatorAlloc
+    size_t recycledBytes; // Memory given back with DFAllocatorRecycle, and not yet reused
+    size_t wastedBytes;   // Space left over at the end of blocks that are no longer being filled
+} DFAllocatorStats;
+
 DFAllocator *DFAllocatorNew(void);
+
+// Create an allocator whose first block is initialSize bytes, and whose blocks grow no larger than
+// maxBlockSize (except to hold a single allocation larger than that). Passing 0 for either selects
+// the default.
+DFAllocator *DFAllocatorNewWithSize(size_t initialSize, size_t maxBlockSize);
 void DFAllocatorFree(DFAllocator *alc);
 void *DFAllocatorAlloc(DFAllocator *alc, size_t size);
+
+// Give back memory previously obtained from DFAllocatorAlloc, so that it can be used to satisfy a
+// later allocation of the same size. Only small allocations (such as nodes, attribute arrays and
+// short strings) are kept for reuse; the memory of larger ones stays unused until the allocator is
+// freed. The size must be the one that was originally requested.
+void DFAllocatorRecycle(DFAllocator *alc, void *ptr, size_t size);
+
+// Try to grow the most recent allocation in place, from oldSize to newSize bytes. This succeeds, and
+// returns 1, only if ptr was the last memory handed out from the current block, and there is enough
+// room left in that block. Otherwise it returns 0, and the caller must allocate a new area instead.
+int DFAllocatorExtend(DFAllocator *alc, void *ptr, size_t oldSize, size_t newSize);
+
+void DFAllocatorGetStats(DFAllocator *alc, DFAllocatorStats *stats);
@@ -0,0 +1,209 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "DFPlatform.h"
+#include "DFAtom.h"
+#include "DFHashTable.h"
+#include "DFCommon.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The table uses open addressing with linear probing, and its size is doubled whenever it becomes
+// half full. Each string is stored after its hash, length and reference count, and is removed
+// from the table (by shifting later entries in the same run back) when its last reference is
+// released.
+//
+// Reference counts are updated atomically. Only a count which reaches zero needs the lock: the
+// entry can then be removed without DFAtomGet handing out a new reference to it at the same time.
+// Every other retain and release is lock-free, as the caller already holds a reference.
+
+typedef struct {
+    uint32_t hash;
+    uint32_t len;
+    volatile int refCount;
+    char str[];
+} DFAtomEntry;
+
+#define MIN_ATOM_SLOTS 1024
+
+static DFOnce atomsOnce = DF_ONCE_INIT;
+static DFMutex *atomsLock = NULL;
+static DFAtomEntry **atomSlots = NULL;
+static size_t atomSlotsCount = 0;
+static size_t atomCount = 0;
+
+static void DFAtomInit(void)
+{
+    atomsLock = DFMutexNew();
+    atomSlotsCount = MIN_ATOM_SLOTS;
+    atomSlots = (DFAtomEntry **)xcalloc(atomSlotsCount,sizeof(DFAtomEntry *));
+}
+
+static DFAtomEntry *entryForAtom(const char *atom)
+{
+    return (DFAtomEntry *)(atom - offsetof(DFAtomEntry,str));
+}
+
+static uint32_t hashString(const char *str, size_t len)
+{
+    uint32_t hash = 0;
+    DFHashBegin(hash);
+    for (size_t i = 0; i < len; i++)
+        DFHashUpdate(hash,str[i]);
+    DFHashEnd(hash);
+    return hash;
+}
+
+// Returns the slot containing the string, or the empty slot where it should go. Must be called with
+// the lock held.
+
+static DFAtomEntry **findSlot(const char *str, size_t len, uint32_t hash)
+{
+    size_t mask = atomSlotsCount - 1;
+    for (size_t index = hash & mask; 1; index = (index + 1) & mask) {
+        DFAtomEntry *entry = atomSlots[index];
+        if (entry == NULL)
+            return &atomSlots[index];
+        if ((entry->hash == hash) && (entry->len == len) && !memcmp(entry->str,str,len))
+            return &atomSlots[index];
+    }
+}
+
+static void grow(void)
+{
+    DFAtomEntry **oldSlots = atomSlots;
+    size_t oldCount = atomSlotsCount;
+    atomSlotsCount *= 2;
+    atomSlots = (DFAtomEntry **)xcalloc(atomSlotsCount,sizeof(DFAtomEntry *));
+    size_t mask = atomSlotsCount - 1;
+    for (size_t i = 0; i < oldCount; i++) {
+        if (oldSlots[i] == NULL)
+            continue;
+        size_t index = oldSlots[i]->hash & mask;
+        while (atomSlots[index] != NULL)
+            index = (index + 1) & mask;
+        atomSlots[index] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+const char *DFAtomGetLen(const char *str, size_t len)
+{
+    DFInitOnce(&atomsOnce,DFAtomInit);
+    uint32_t hash = hashString(str,len);
+
+    DFMutexLock(atomsLock);
+    DFAtomEntry **slot = findSlot(str,len,hash);
+    if (*slot == NULL) {
+        DFAtomEntry *entry = (DFAtomEntry *)xmalloc(sizeof(DFAtomEntry)+len+1);
+        entry->hash = hash;
+        entry->len = (uint32_t)len;
+        entry->refCount = 0;
+        memcpy(entry->str,str,len);
+        entry->str[len] = '\0';
+        *slot = entry;
+        atomCount++;
+        if (2*atomCount > atomSlotsCount)
+            grow();
+        slot = findSlot(str,len,hash);
+    }
+    DFAtomicIncrement(&(*slot)->refCount);
+    const char *atom = (*slot)->str;
+    DFMutexUnlock(atomsLock);
+    return atom;
+}
+
+const char *DFAtomGet(const char *str)
+{
+    return DFAtomGetLen(str,strlen(str));
+}
+
+const char *DFAtomFind(const char *str)
+{
+    DFInitOnce(&atomsOnce,DFAtomInit);
+    size_t len = strlen(str);
+    uint32_t hash = hashString(str,len);
+
+    DFMutexLock(atomsLock);
+    DFAtomEntry *entry = *findSlot(str,len,hash);
+    if (entry != NULL)
+        DFAtomicIncrement(&entry->refCount);
+    DFMutexUnlock(atomsLock);
+    return (entry != NULL) ? entry->str : NULL;
+}
+
+const char *DFAtomRetain(const char *atom)
+{
+    if (atom == NULL)
+        return NULL;
+    DFAtomicIncrement(&entryForAtom(atom)->refCount);
+    return atom;
+}
+
+// Empties the given slot, then moves back any later entries in the same run which would otherwise
+// no longer be reachable from their home slot. Must be called with the lock held.
+
+static void removeSlot(size_t index)
+{
+    size_t mask = atomSlotsCount - 1;
+    size_t next = index;
+    while (1) {
+        next = (next + 1) & mask;
+        DFAtomEntry *entry = atomSlots[next];
+        if (entry == NULL)
+            break;
+        size_t home = entry->hash & mask;
+        // Leave the entry where it is if its home slot lies cyclically in (index,next]
+        int reachable = (index <= next) ? ((home > index) && (home <= next))
+                                        : ((home > index) || (home <= next));
+        if (!reachable) {
+            atomSlots[index] = entry;
+            index = next;
+        }
+    }
+    atomSlots[index] = NULL;
+}
+
+void DFAtomRelease(const char *atom)
+{
+    if (atom == NULL)
+        return;
+    DFAtomEntry *entry = entryForAtom(atom);
+    for (int count = DFAtomicLoad(&entry->refCount); count > 1; count = DFAtomicLoad(&entry->refCount)) {
+        if (DFAtomicCompareExchange(&entry->refCount,count,count-1))
+            return;
+    }
+
+    DFMutexLock(atomsLock);
+    if (DFAtomicDecrement(&entry->refCount) == 0) {
+        size_t mask = atomSlotsCount - 1;
+        size_t index = entry->hash & mask;
+        while (atomSlots[index] != entry)
+            index = (index + 1) & mask;
+        removeSlot(index);
+        atomCount--;
+        free(entry);
+    }
+    DFMutexUnlock(atomsLock);
+}
+
+uint32_t DFAtomHash(const char *atom)
+{
+    return entryForAtom(atom)->hash;
+}
@@ -0,0 +1,52 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "DFTypes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                             DFAtom                                             //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Atoms are strings kept in a single, process-wide table, with only one copy of each distinct
+// string. Two atoms are therefore equal if and only if their pointers are equal, and each has its
+// hash code computed in advance. Atoms are reference counted: every atom returned by DFAtomGet,
+// DFAtomGetLen, DFAtomFind or DFAtomRetain must be passed to DFAtomRelease once it is no longer
+// needed, and the string is removed from the table when its last reference is released.
+//
+// All functions may be called from any thread.
+
+// Returns the atom for str, adding it to the table if necessary
+const char *DFAtomGet(const char *str);
+const char *DFAtomGetLen(const char *str, size_t len);
+
+// Returns the atom for str if there is one, or NULL otherwise. Use this for lookups, so that the
+// table does not grow with strings that are never going to match anything.
+const char *DFAtomFind(const char *str);
+
+// Add or remove a reference to an atom the caller already holds. These take no lock, except when
+// releasing the last reference.
+const char *DFAtomRetain(const char *atom);
+void DFAtomRelease(const char *atom);
+
+// The hash of an atom's string, as computed by DFHashBegin/DFHashUpdate/DFHashEnd. atom must have
+// been returned by one of the above functions, and not yet released.
+uint32_t DFAtomHash(const char *atom);
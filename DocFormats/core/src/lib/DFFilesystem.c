@@ -44,6 +44,15 @@ int DFIsDirectory(const char *path)
     return ((0 == stat(path,&statbuf)) && S_ISDIR(statbuf.st_mode));
 }
 
+int DFFileSize(const char *path, size_t *size)
+{
+    struct stat statbuf;
+    if (0 != stat(path,&statbuf))
+        return 0;
+    *size = (size_t)statbuf.st_size;
+    return 1;
+}
+
 int DFCreateDirectory(const char *path, int intermediates, DFError **error)
 {
     size_t len = strlen(path);
@@ -22,6 +22,7 @@
 
 int DFFileExists(const char *path);
 int DFIsDirectory(const char *path);
+int DFFileSize(const char *path, size_t *size);
 int DFCreateDirectory(const char *path, int intermediates, DFError **error);
 int DFEmptyDirectory(const char *path, DFError **error);
 int DFCopyFile(const char *srcPath, const char *destPath, DFError **error);
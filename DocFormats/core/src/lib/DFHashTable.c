@@ -17,45 +17,81 @@
 
 #include "DFPlatform.h"
 #include "DFHashTable.h"
+#include "DFAtom.h"
 #include "DFCommon.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-typedef struct DFHashEntry DFHashEntry;
+// The table uses open addressing with linear probing. Each slot caches the hash of its key, and the
+// hash values EMPTY_HASH and DELETED_HASH are reserved to mark free slots and removed entries
+// (hashes of actual keys are adjusted to avoid them). The number of slots is always a power of two,
+// and is doubled whenever more than three quarters of them are in use (including removed entries,
+// which are discarded when the table is resized).
+//
+// Integer keys are stored directly in the slot, with a NULL string key. They are kept distinct from
+// string keys, which is fine as no table is accessed with both.
+//
+// In a table with atom keys, each string key is an atom, to which the table holds a reference. Atom
+// keys have the same hash as the equivalent string, so lookups by string just compare the strings
+// when the pointers differ, without going through the atom table. Adding an atom retains it without
+// taking the atom table's lock; only adding a plain string has to intern it.
 
-struct DFHashEntry {
-    DFHashEntry *next;
-    void *value;
+#define EMPTY_HASH   0
+#define DELETED_HASH 1
+#define MIN_SLOTS    8
+
+typedef struct {
     DFHashCode hash;
-    char key[0];
-};
+    int intKey;
+    char *key;
+    void *value;
+} DFHashSlot;
 
 struct DFHashTable {
     size_t retainCount;
-    size_t binsCount;
-    DFHashEntry **bins;
+    size_t slotsCount; // allocated when the first entry is added
+    size_t initialSlotsCount;
+    size_t count;
+    size_t deletedCount;
+    DFHashSlot *slots;
     DFCopyFunction copy;
     DFFreeFunction free;
+    int atomKeys;
 };
 
+static int isEntry(DFHashSlot *slot)
+{
+    return (slot->hash != EMPTY_HASH) && (slot->hash != DELETED_HASH);
+}
+
 DFHashTable *DFHashTableNew(DFCopyFunction copy, DFFreeFunction free)
 {
-    return DFHashTableNew2(copy,free,53);
+    return DFHashTableNew2(copy,free,MIN_SLOTS);
 }
 
+// binsCount is the number of entries expected; the table will grow beyond this if needed
+
 DFHashTable *DFHashTableNew2(DFCopyFunction copy, DFFreeFunction free, int binsCount)
 {
     DFHashTable *table = (DFHashTable *)xcalloc(1,sizeof(DFHashTable));
     table->retainCount = 1;
-    table->binsCount = binsCount;
-    table->bins = (DFHashEntry **)xcalloc(1,table->binsCount*sizeof(DFHashEntry *));
+    table->initialSlotsCount = MIN_SLOTS;
+    while (table->initialSlotsCount < (size_t)binsCount)
+        table->initialSlotsCount *= 2;
     table->copy = copy;
     table->free = free;
     return table;
 }
 
+DFHashTable *DFHashTableNewWithAtomKeys(DFCopyFunction copy, DFFreeFunction free)
+{
+    DFHashTable *table = DFHashTableNew(copy,free);
+    table->atomKeys = 1;
+    return table;
+}
+
 DFHashTable *DFHashTableRetain(DFHashTable *table)
 {
     if (table != NULL)
@@ -72,38 +108,149 @@ void DFHashTableRelease(DFHashTable *table)
     if (table->retainCount > 0)
         return;
 
-    for (DFHashCode bin = 0; bin < table->binsCount; bin++) {
-        DFHashEntry *entry = table->bins[bin];
-        while (entry != NULL) {
-            DFHashEntry *next = entry->next;
+    for (size_t i = 0; i < table->slotsCount; i++) {
+        DFHashSlot *slot = &table->slots[i];
+        if (isEntry(slot)) {
             if (table->free != NULL)
-                table->free(entry->value);
-            free(entry);
-            entry = next;
+                table->free(slot->value);
+            if (table->atomKeys)
+                DFAtomRelease(slot->key);
+            else
+                free(slot->key);
         }
     }
-    free(table->bins);
+    free(table->slots);
     free(table);
 }
 
+static void DFHashTableResize(DFHashTable *table, size_t slotsCount)
+{
+    DFHashSlot *oldSlots = table->slots;
+    size_t oldCount = table->slotsCount;
+
+    table->slots = (DFHashSlot *)xcalloc(slotsCount,sizeof(DFHashSlot));
+    table->slotsCount = slotsCount;
+    table->deletedCount = 0;
+
+    size_t mask = slotsCount - 1;
+    for (size_t i = 0; i < oldCount; i++) {
+        if (!isEntry(&oldSlots[i]))
+            continue;
+        size_t index = oldSlots[i].hash & mask;
+        while (table->slots[index].hash != EMPTY_HASH)
+            index = (index + 1) & mask;
+        table->slots[index] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+// Returns the slot holding the given key if present, or otherwise the slot in which it should be
+// added (NULL if the table has no slots yet). If isAtom is set, key is an atom, and is only
+// compared by pointer.
+
+static DFHashSlot *DFHashTableFindSlot(DFHashTable *table, const char *key, int isAtom, int intKey, DFHashCode hash)
+{
+    if (table->slotsCount == 0)
+        return NULL;
+
+    size_t mask = table->slotsCount - 1;
+    DFHashSlot *firstDeleted = NULL;
+    for (size_t index = hash & mask; 1; index = (index + 1) & mask) {
+        DFHashSlot *slot = &table->slots[index];
+        if (slot->hash == EMPTY_HASH)
+            return (firstDeleted != NULL) ? firstDeleted : slot;
+        if (slot->hash == DELETED_HASH) {
+            if (firstDeleted == NULL)
+                firstDeleted = slot;
+            continue;
+        }
+        if (slot->hash != hash)
+            continue;
+        if (key != NULL) {
+            if ((slot->key == key) || (!isAtom && (slot->key != NULL) && !strcmp(slot->key,key)))
+                return slot;
+        }
+        else {
+            if ((slot->key == NULL) && (slot->intKey == intKey))
+                return slot;
+        }
+    }
+}
+
+static DFHashSlot *DFHashTableLookupSlot(DFHashTable *table, const char *key, int isAtom, int intKey, DFHashCode hash)
+{
+    DFHashSlot *slot = DFHashTableFindSlot(table,key,isAtom,intKey,hash);
+    return ((slot != NULL) && isEntry(slot)) ? slot : NULL;
+}
+
+static void DFHashTableAddSlot(DFHashTable *table, const char *key, int isAtom, int intKey, DFHashCode hash, const void *constValue)
+{
+    void *value = (void *)constValue;
+    if (table->copy != NULL) {
+        value = table->copy(value);
+    }
+
+    DFHashSlot *slot = DFHashTableLookupSlot(table,key,isAtom,intKey,hash);
+    if (slot != NULL) {
+        void *oldValue = slot->value;
+        slot->value = value;
+        if (table->free != NULL)
+            table->free(oldValue);
+        return;
+    }
+
+    if (table->slotsCount == 0)
+        DFHashTableResize(table,table->initialSlotsCount);
+    else if (4*(table->count + table->deletedCount + 1) > 3*table->slotsCount)
+        DFHashTableResize(table,(4*(table->count + 1) > table->slotsCount) ? 2*table->slotsCount : table->slotsCount);
+
+    slot = DFHashTableFindSlot(table,key,isAtom,intKey,hash);
+    if (slot->hash == DELETED_HASH)
+        table->deletedCount--;
+    slot->hash = hash;
+    slot->intKey = intKey;
+    if (table->atomKeys)
+        slot->key = (char *)(isAtom ? DFAtomRetain(key) : DFAtomGet(key));
+    else
+        slot->key = (key != NULL) ? xstrdup(key) : NULL;
+    slot->value = value;
+    table->count++;
+}
+
+static void DFHashTableRemoveSlot(DFHashTable *table, const char *key, int isAtom, int intKey, DFHashCode hash)
+{
+    DFHashSlot *slot = DFHashTableLookupSlot(table,key,isAtom,intKey,hash);
+    if (slot == NULL)
+        return;
+    void *value = slot->value;
+    if (table->atomKeys)
+        DFAtomRelease(slot->key);
+    else
+        free(slot->key);
+    slot->hash = DELETED_HASH;
+    slot->key = NULL;
+    slot->value = NULL;
+    table->count--;
+    table->deletedCount++;
+    if (table->free)
+        table->free(value);
+}
+
 DFHashTable *DFHashTableCopy(DFHashTable *src)
 {
-    DFHashTable *result = DFHashTableNew(src->copy,src->free);
-    for (DFHashCode bin = 0; bin < src->binsCount; bin++) {
-        for (DFHashEntry *entry = src->bins[bin]; entry != NULL; entry = entry->next)
-            DFHashTableAdd(result,entry->key,entry->value);
+    DFHashTable *result = DFHashTableNew2(src->copy,src->free,(int)src->count);
+    result->atomKeys = src->atomKeys;
+    for (size_t i = 0; i < src->slotsCount; i++) {
+        DFHashSlot *slot = &src->slots[i];
+        if (isEntry(slot))
+            DFHashTableAddSlot(result,slot->key,src->atomKeys,slot->intKey,slot->hash,slot->value);
     }
     return result;
 }
 
 int DFHashTableCount(DFHashTable *table)
 {
-    int count = 0;
-    for (DFHashCode bin = 0; bin < table->binsCount; bin++) {
-        for (DFHashEntry *entry = table->bins[bin]; entry != NULL; entry = entry->next)
-            count++;
-    }
-    return count;
+    return (int)table->count;
 }
 
 const char **DFHashTableCopyKeys(DFHashTable *table)
@@ -128,9 +275,15 @@ const char **DFHashTableCopyKeys(DFHashTable *table)
 
     int count = DFHashTableCount(table);
     size_t numBytes = (count+1)*sizeof(char *);
-    for (DFHashCode bin = 0; bin < table->binsCount; bin++) {
-        for (DFHashEntry *entry = table->bins[bin]; entry != NULL; entry = entry->next)
-            numBytes += strlen(entry->key)+1;
+    char intKey[40];
+    for (size_t i = 0; i < table->slotsCount; i++) {
+        DFHashSlot *slot = &table->slots[i];
+        if (!isEntry(slot))
+            continue;
+        if (slot->key != NULL)
+            numBytes += strlen(slot->key)+1;
+        else
+            numBytes += snprintf(intKey,40,"%d",slot->intKey)+1;
     }
 
     void *mem = xmalloc(numBytes);
@@ -138,15 +291,21 @@ const char **DFHashTableCopyKeys(DFHashTable *table)
     char *storage = (char *)mem + (count+1)*sizeof(char *);
 
     size_t index = 0;
-    for (DFHashCode bin = 0; bin < table->binsCount; bin++) {
-        for (DFHashEntry *entry = table->bins[bin]; entry != NULL; entry = entry->next) {
-            pointers[index++] = storage;
-            size_t len = strlen(entry->key);
-            memcpy(storage,entry->key,len);
-            storage += len;
-            *storage = '\0';
-            storage += 1;
+    for (size_t i = 0; i < table->slotsCount; i++) {
+        DFHashSlot *slot = &table->slots[i];
+        if (!isEntry(slot))
+            continue;
+        const char *key = slot->key;
+        if (key == NULL) {
+            snprintf(intKey,40,"%d",slot->intKey);
+            key = intKey;
         }
+        pointers[index++] = storage;
+        size_t len = strlen(key);
+        memcpy(storage,key,len);
+        storage += len;
+        *storage = '\0';
+        storage += 1;
     }
     assert(index == count);
     assert(storage == (char *)mem + numBytes);
@@ -154,18 +313,11 @@ const char **DFHashTableCopyKeys(DFHashTable *table)
     return (const char **)pointers;
 }
 
-static DFHashEntry **DFHashTableLookupEntry(DFHashTable *table, const char *key, DFHashCode hash)
+// Avoid the hash values reserved for free slots
+
+static DFHashCode DFHashAdjust(DFHashCode hash)
 {
-    DFHashCode bin = hash % table->binsCount;
-    for (DFHashEntry **ptr = &table->bins[bin]; *ptr != NULL; ptr = &(*ptr)->next) {
-        DFHashEntry *entry = *ptr;
-        if (entry->hash != hash)
-            continue;
-        if (strcmp(entry->key,key))
-            continue;
-        return ptr;
-    }
-    return NULL;
+    return (hash > DELETED_HASH) ? hash : (hash + 2);
 }
 
 static DFHashCode DFHashString(const char *str)
@@ -177,79 +329,70 @@ static DFHashCode DFHashString(const char *str)
         str++;
     }
     DFHashEnd(hash);
-    return hash;
+    return DFHashAdjust(hash);
 }
 
-void *DFHashTableLookup(DFHashTable *table, const char *key)
+// Integers are hashed with the finalizer from MurmurHash3, so that consecutive keys (as is typical)
+// are spread across the table
+
+static DFHashCode DFHashInt(int key)
 {
-    DFHashCode hash = DFHashString(key);
-    DFHashEntry **ptr = DFHashTableLookupEntry(table,key,hash);
-    if (ptr != NULL)
-        return (*ptr)->value;
-    else
-        return NULL;
+    DFHashCode hash = (DFHashCode)key;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return DFHashAdjust(hash);
 }
 
-void DFHashTableAdd(DFHashTable *table, const char *key, const void *constValue)
+void *DFHashTableLookup(DFHashTable *table, const char *key)
 {
-    void *value = (void *)constValue;
-    if (table->copy != NULL) {
-        value = table->copy(value);
-    }
+    DFHashSlot *slot = DFHashTableLookupSlot(table,key,0,0,DFHashString(key));
+    return (slot != NULL) ? slot->value : NULL;
+}
 
-    DFHashCode hash = DFHashString(key);
-    DFHashEntry **ptr = DFHashTableLookupEntry(table,key,hash);
-    if (ptr != NULL) {
-        DFHashEntry *entry = *ptr;
-        void *oldValue = entry->value;
-        entry->value = value;
-        if (table->free != NULL)
-            table->free(oldValue);
-    }
-    else {
-        size_t len = strlen(key);
-        DFHashEntry *entry = (DFHashEntry *)xmalloc(sizeof(DFHashEntry)+len*sizeof(char)+1);
-        entry->value = value;
-        entry->hash = hash;
-        memcpy(&entry->key[0],key,len);
-        entry->key[len] = '\0';
-
-        DFHashCode bin = hash % table->binsCount;
-        entry->next = table->bins[bin];
-        table->bins[bin] = entry;
-    }
+void DFHashTableAdd(DFHashTable *table, const char *key, const void *value)
+{
+    DFHashTableAddSlot(table,key,0,0,DFHashString(key),value);
 }
 
 void DFHashTableRemove(DFHashTable *table, const char *key)
 {
-    DFHashCode hash = DFHashString(key);
-    DFHashEntry **ptr = DFHashTableLookupEntry(table,key,hash);
-    if (ptr != NULL) {
-        DFHashEntry *entry = *ptr;
-        *ptr = entry->next;
-        if (table->free)
-            table->free(entry->value);
-        free(entry);
-    }
+    DFHashTableRemoveSlot(table,key,0,0,DFHashString(key));
+}
+
+void *DFHashTableLookupAtom(DFHashTable *table, const char *atom)
+{
+    assert(table->atomKeys);
+    DFHashSlot *slot = DFHashTableLookupSlot(table,atom,1,0,DFHashAdjust(DFAtomHash(atom)));
+    return (slot != NULL) ? slot->value : NULL;
+}
+
+void DFHashTableAddAtom(DFHashTable *table, const char *atom, const void *value)
+{
+    assert(table->atomKeys);
+    DFHashTableAddSlot(table,atom,1,0,DFHashAdjust(DFAtomHash(atom)),value);
+}
+
+void DFHashTableRemoveAtom(DFHashTable *table, const char *atom)
+{
+    assert(table->atomKeys);
+    DFHashTableRemoveSlot(table,atom,1,0,DFHashAdjust(DFAtomHash(atom)));
 }
 
 void *DFHashTableLookupInt(DFHashTable *table, int key)
 {
-    char strkey[40];
-    snprintf(strkey,40,"%d",key);
-    return DFHashTableLookup(table,strkey);
+    DFHashSlot *slot = DFHashTableLookupSlot(table,NULL,0,key,DFHashInt(key));
+    return (slot != NULL) ? slot->value : NULL;
 }
 
 void DFHashTableAddInt(DFHashTable *table, int key, void *value)
 {
-    char strkey[40];
-    snprintf(strkey,40,"%d",key);
-    DFHashTableAdd(table,strkey,value);
+    DFHashTableAddSlot(table,NULL,0,key,DFHashInt(key),value);
 }
 
 void DFHashTableRemoveInt(DFHashTable *table, int key)
 {
-    char strkey[40];
-    snprintf(strkey,40,"%d",key);
-    DFHashTableRemove(table,strkey);
+    DFHashTableRemoveSlot(table,NULL,0,key,DFHashInt(key));
 }
@@ -42,6 +42,12 @@ typedef void (*DFFreeFunction)(void *object);
 
 DFHashTable *DFHashTableNew(DFCopyFunction copy, DFFreeFunction free);
 DFHashTable *DFHashTableNew2(DFCopyFunction copy, DFFreeFunction free, int binsCount);
+
+// Create a table whose string keys are stored as atoms (see DFAtom.h), rather than copied for each
+// entry. The table holds a reference to each key, which it releases when the entry is removed. The
+// usual functions accept any string as a key; when the caller already has an atom, the *Atom
+// variants compare it by pointer, do not recompute its hash, and only retain it when adding.
+DFHashTable *DFHashTableNewWithAtomKeys(DFCopyFunction copy, DFFreeFunction free);
 DFHashTable *DFHashTableRetain(DFHashTable *table);
 void DFHashTableRelease(DFHashTable *table);
 
@@ -52,6 +58,10 @@ void *DFHashTableLookup(DFHashTable *table, const char *key);
 void DFHashTableAdd(DFHashTable *table, const char *key, const void *value);
 void DFHashTableRemove(DFHashTable *table, const char *key);
 
+void *DFHashTableLookupAtom(DFHashTable *table, const char *atom);
+void DFHashTableAddAtom(DFHashTable *table, const char *atom, const void *value);
+void DFHashTableRemoveAtom(DFHashTable *table, const char *atom);
+
 void *DFHashTableLookupInt(DFHashTable *table, int key);
 void DFHashTableAddInt(DFHashTable *table, int key, void *value);
 void DFHashTableRemoveInt(DFHashTable *table, int key);
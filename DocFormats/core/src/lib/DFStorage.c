@@ -22,22 +22,39 @@
 #include "DFFilesystem.h"
 #include "DFBuffer.h"
 #include "DFZipFile.h"
+#include "DFArray.h"
 #include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Amount of data passed at once by DFStorageReadChunks, when the data is already in memory or
+// comes from the filesystem
+#define STORAGE_CHUNK_SIZE 65536
+
 typedef struct DFStorageOps DFStorageOps;
 
 struct DFStorageOps {
     int (*save)(DFStorage *storage, DFError **error);
     int (*read)(DFStorage *storage, const char *path, void **buf, size_t *nbytes, DFError **error);
+    int (*readChunks)(DFStorage *storage, const char *path, DFStorageReadFunction fun, void *ctx, DFError **error);
     int (*write)(DFStorage *storage, const char *path, void *buf, size_t nbytes, DFError **error);
     int (*exists)(DFStorage *storage, const char *path);
+    int (*size)(DFStorage *storage, const char *path, size_t *nbytes);
+    int (*checksum)(DFStorage *storage, const char *path, uint32_t *crc, size_t *nbytes);
     int (*delete)(DFStorage *storage, const char *path, DFError **error);
     const char **(*list)(DFStorage *storage, DFError **error);
 };
 
+struct DFStorageStream {
+    DFStorage *storage;
+    char *path;
+    DFBuffer *buffer;
+    DFextZipStreamP zipStream;
+    int ok;
+};
+
 struct DFStorage {
     size_t retainCount;
     DFFileFormat format;
@@ -45,6 +62,18 @@ struct DFStorage {
     char *zipFilename;
     DFHashTable *files;
     const DFStorageOps *ops;
+
+    // Zip storage only
+    DFextZipHandleP zipHandle;
+    DFHashTable *zipWritten;
+    DFHashTable *zipPending;
+    DFHashTable *zipEntries;
+    DFHashTable *cache;
+    DFArray *cacheOrder;
+    size_t cacheBytes;
+    size_t cacheLimit;
+    int threads;
+    int modified;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -93,6 +122,40 @@ end:
     return ok;
 }
 
+static int fsReadChunks(DFStorage *storage, const char *path, DFStorageReadFunction fun, void *ctx, DFError **error)
+{
+    char *fullPath = DFAppendPathComponent(storage->rootPath,path);
+    char *chunk = NULL;
+    int ok = 0;
+
+    FILE *file = fopen(fullPath,"rb");
+    if (file == NULL) {
+        DFErrorSetPosix(error,errno);
+        goto end;
+    }
+
+    chunk = (char *)xmalloc(STORAGE_CHUNK_SIZE);
+    size_t r;
+    while (0 < (r = fread(chunk,1,STORAGE_CHUNK_SIZE,file))) {
+        if (!fun(ctx,chunk,r)) {
+            DFErrorFormat(error,"Read cancelled");
+            goto end;
+        }
+    }
+    if (ferror(file)) {
+        DFErrorSetPosix(error,errno);
+        goto end;
+    }
+    ok = 1;
+
+end:
+    if (file != NULL)
+        fclose(file);
+    free(chunk);
+    free(fullPath);
+    return ok;
+}
+
 static int fsWrite(DFStorage *storage, const char *path, void *buf, size_t nbytes, DFError **error)
 {
     char *fullPath = DFAppendPathComponent(storage->rootPath,path);
@@ -131,6 +194,14 @@ static int fsExists(DFStorage *storage, const char *path)
     return r;
 }
 
+static int fsSize(DFStorage *storage, const char *path, size_t *nbytes)
+{
+    char *fullPath = DFAppendPathComponent(storage->rootPath,path);
+    int r = DFFileSize(fullPath,nbytes);
+    free(fullPath);
+    return r;
+}
+
 static int fsDelete(DFStorage *storage, const char *path, DFError **error)
 {
     char *fullPath = DFAppendPathComponent(storage->rootPath,path);
@@ -163,8 +234,10 @@ const char **fsList(DFStorage *storage, DFError **error)
 static DFStorageOps fsOps = {
     .save = fsSave,
     .read = fsRead,
+    .readChunks = fsReadChunks,
     .write = fsWrite,
     .exists = fsExists,
+    .size = fsSize,
     .delete = fsDelete,
     .list = fsList,
 };
@@ -211,6 +284,15 @@ static int memExists(DFStorage *storage, const char *path)
     return (DFHashTableLookup(storage->files,path) != NULL);
 }
 
+static int memSize(DFStorage *storage, const char *path, size_t *nbytes)
+{
+    DFBuffer *buffer = DFHashTableLookup(storage->files,path);
+    if (buffer == NULL)
+        return 0;
+    *nbytes = buffer->len;
+    return 1;
+}
+
 static int memDelete(DFStorage *storage, const char *path, DFError **error)
 {
     DFHashTableRemove(storage->files,path);
@@ -227,6 +309,7 @@ static DFStorageOps memOps = {
     .read = memRead,
     .write = memWrite,
     .exists = memExists,
+    .size = memSize,
     .delete = memDelete,
     .list = memList,
 };
@@ -237,64 +320,471 @@ static DFStorageOps memOps = {
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Currently, zip storage objects operate just like memory storage objects, in that they store their
-// contents in a hash table. The only difference is that they extract all the entries from a zip
-// file on creation, and overwrite the zip file on save.
+// Zip storage objects read only the central directory of the archive when opened. An entry is
+// inflated the first time it is read, and kept in a small cache (bounded by cacheLimit bytes) so
+// that parts which are read several times during a conversion, such as relationships and content
+// types, are only inflated once. Entries which are written take precedence over the corresponding
+// entries in the archive. Those written with DFStorageWrite are held uncompressed, in the zipPending
+// table, until the storage is saved; those written through a stream are compressed as they arrive,
+// and held in the zipWritten table.
 //
-// Eventually, we should make it so the entries are read on-demand, and also that a new, temporary
-// zip file is written if the storage is modified, and that new version replaces the existing one on
-// save.
+// On save, the pending entries are first compressed, using up to threads threads, and moved to
+// zipWritten. A new archive is then written to a temporary file, which replaces the original. Both
+// the written entries and the untouched ones from the original archive are copied into it in their
+// compressed form. Each entry is compressed the same way regardless of the number of threads, so
+// the result does not depend on it. If the storage has not been modified since it was opened,
+// saving does nothing.
+
+#define ZIP_DEFAULT_CACHE_LIMIT (4*1024*1024)
+#define ZIP_DEFAULT_THREADS 4
+
+static void zipCacheRemove(DFStorage *storage, const char *path)
+{
+    DFBuffer *buffer = DFHashTableLookup(storage->cache,path);
+    if (buffer == NULL)
+        return;
+
+    storage->cacheBytes -= buffer->len;
+    DFHashTableRemove(storage->cache,path);
+    for (size_t i = 0; i < DFArrayCount(storage->cacheOrder); i++) {
+        if (!strcmp(DFArrayItemAt(storage->cacheOrder,i),path)) {
+            DFArrayRemove(storage->cacheOrder,i);
+            break;
+        }
+    }
+}
+
+static void zipCacheTrim(DFStorage *storage, size_t limit)
+{
+    while ((storage->cacheBytes > limit) && (DFArrayCount(storage->cacheOrder) > 0)) {
+        char *oldest = xstrdup(DFArrayItemAt(storage->cacheOrder,0));
+        zipCacheRemove(storage,oldest);
+        free(oldest);
+    }
+}
+
+static void zipCacheAdd(DFStorage *storage, const char *path, const void *data, size_t len)
+{
+    if (len > storage->cacheLimit)
+        return;
+
+    zipCacheTrim(storage,storage->cacheLimit - len);
+
+    DFBuffer *buffer = DFBufferNew();
+    DFBufferAppendData(buffer,data,len);
+    DFHashTableAdd(storage->cache,path,buffer);
+    DFArrayAppend(storage->cacheOrder,(void *)path);
+    storage->cacheBytes += len;
+    DFBufferRelease(buffer);
+}
+
+static int zipOpenArchive(DFStorage *storage, DFError **error)
+{
+    storage->zipHandle = DFextZipOpen(storage->zipFilename);
+    if (storage->zipHandle == NULL) {
+        DFErrorFormat(error,"Cannot open file");
+        return 0;
+    }
+
+    for (int i = 0; i < storage->zipHandle->zipFileCount; i++) {
+        DFextZipDirEntry *entry = &storage->zipHandle->zipFileEntries[i];
+        DFHashTableAdd(storage->zipEntries,entry->fileName,entry);
+    }
+    return 1;
+}
+
+static void zipCloseArchive(DFStorage *storage)
+{
+    DFHashTableRelease(storage->zipEntries);
+    storage->zipEntries = DFHashTableNew(NULL,NULL);
+    DFHashTableRelease(storage->cache);
+    storage->cache = DFHashTableNew((DFCopyFunction)DFBufferRetain,(DFFreeFunction)DFBufferRelease);
+    DFArrayRelease(storage->cacheOrder);
+    storage->cacheOrder = DFArrayNew((DFCopyFunction)xstrdup,(DFFreeFunction)free);
+    storage->cacheBytes = 0;
+
+    if (storage->zipHandle != NULL)
+        DFextZipClose(storage->zipHandle);
+    storage->zipHandle = NULL;
+}
+
+static const char **zipList(DFStorage *storage, DFError **error)
+{
+    // Entries from the archive are listed in their original order, followed by any new ones
+    DFArray *paths = DFArrayNew((DFCopyFunction)xstrdup,(DFFreeFunction)free);
+    if (storage->zipHandle != NULL) {
+        for (int i = 0; i < storage->zipHandle->zipFileCount; i++) {
+            const char *fileName = storage->zipHandle->zipFileEntries[i].fileName;
+            if (DFHashTableLookup(storage->zipEntries,fileName) != NULL)
+                DFArrayAppend(paths,(void *)fileName);
+        }
+    }
+
+    const char **added = DFHashTableCopyKeys(storage->zipWritten);
+    for (int i = 0; added[i]; i++) {
+        if (DFHashTableLookup(storage->zipEntries,added[i]) == NULL)
+            DFArrayAppend(paths,(void *)added[i]);
+    }
+    free(added);
+
+    const char **pending = DFHashTableCopyKeys(storage->zipPending);
+    for (int i = 0; pending[i]; i++) {
+        if ((DFHashTableLookup(storage->zipEntries,pending[i]) == NULL) &&
+            (DFHashTableLookup(storage->zipWritten,pending[i]) == NULL))
+            DFArrayAppend(paths,(void *)pending[i]);
+    }
+    free(pending);
+
+    const char **result = DFStringArrayFlatten(paths);
+    DFArrayRelease(paths);
+    return result;
+}
+
+static int zipWriteArchive(DFStorage *storage, const char *filename, DFError **error)
+{
+    DFextZipHandleP zipHandle = DFextZipCreate(filename);
+    if (zipHandle == NULL) {
+        DFErrorFormat(error,"Cannot create file");
+        return 0;
+    }
+
+    int ok = 0;
+    const char **paths = zipList(storage,error);
+    for (int i = 0; paths[i]; i++) {
+        const char *path = paths[i];
+
+        // Entries which have not been written since the archive was opened are copied across
+        // along with their original CRC and sizes
+        DFextZipStreamP stream = DFHashTableLookup(storage->zipWritten,path);
+        DFextZipDirEntry *entry = DFHashTableLookup(storage->zipEntries,path);
+        DFextZipDirEntryP written;
+        if (stream != NULL)
+            written = DFextZipWriteStream(zipHandle,path,stream);
+        else
+            written = DFextZipCopyFile(zipHandle,storage->zipHandle,entry);
+
+        if (written == NULL) {
+            DFErrorFormat(error,"%s: Cannot create entry in zip file",path);
+            goto end;
+        }
+    }
+    ok = 1;
+
+end:
+    free(paths);
+    DFextZipClose(zipHandle);
+    return ok;
+}
+
+// Reopen the original archive after a failed save, leaving out any entries that had been deleted
+// before it was closed
+
+static void zipReopenArchive(DFStorage *storage, DFHashTable *kept)
+{
+    if (!zipOpenArchive(storage,NULL))
+        return;
+    for (int i = 0; i < storage->zipHandle->zipFileCount; i++) {
+        const char *fileName = storage->zipHandle->zipFileEntries[i].fileName;
+        if (DFHashTableLookup(kept,fileName) == NULL)
+            DFHashTableRemove(storage->zipEntries,fileName);
+    }
+}
+
+typedef struct {
+    const char **paths;
+    DFBuffer **contents;
+    DFextZipStreamP *streams;
+} ZipPendingBatch;
+
+static void zipCompressEntry(void *ctx, int index)
+{
+    ZipPendingBatch *batch = (ZipPendingBatch *)ctx;
+    DFBuffer *content = batch->contents[index];
+    DFextZipStreamP stream = DFextZipStreamNew();
+    if ((stream != NULL) &&
+        (!DFextZipStreamWrite(stream,content->data,(int)content->len) || !DFextZipStreamFinish(stream))) {
+        DFextZipStreamFree(stream);
+        stream = NULL;
+    }
+    batch->streams[index] = stream;
+}
+
+// Compress all the pending entries in parallel, and move them to zipWritten
+
+static int zipCompressPending(DFStorage *storage, DFError **error)
+{
+    ZipPendingBatch batch;
+    batch.paths = DFHashTableCopyKeys(storage->zipPending);
+    int count = 0;
+    while (batch.paths[count] != NULL)
+        count++;
+    batch.contents = (DFBuffer **)xcalloc(count+1,sizeof(DFBuffer *));
+    batch.streams = (DFextZipStreamP *)xcalloc(count+1,sizeof(DFextZipStreamP));
+    for (int i = 0; i < count; i++)
+        batch.contents[i] = DFHashTableLookup(storage->zipPending,batch.paths[i]);
+
+    DFRunParallel(count,storage->threads,zipCompressEntry,&batch);
+
+    int ok = 1;
+    for (int i = 0; i < count; i++) {
+        if (batch.streams[i] == NULL) {
+            if (ok)
+                DFErrorFormat(error,"%s: Cannot compress data",batch.paths[i]);
+            ok = 0;
+        }
+        else {
+            DFHashTableAdd(storage->zipWritten,batch.paths[i],batch.streams[i]);
+            DFHashTableRemove(storage->zipPending,batch.paths[i]);
+        }
+    }
+
+    free(batch.paths);
+    free(batch.contents);
+    free(batch.streams);
+    return ok;
+}
 
 static int zipSave(DFStorage *storage, DFError **error)
 {
-    return DFZip(storage->zipFilename,storage,error);
+    if ((storage->zipHandle != NULL) && !storage->modified)
+        return 1;
+
+    int ok = 0;
+    char *tempFilename = DFFormatString("%s.tmp",storage->zipFilename);
+    int hadArchive = (storage->zipHandle != NULL);
+    DFHashTable *kept = NULL;
+    char *errmsg = NULL;
+
+    if (!zipCompressPending(storage,error))
+        goto end;
+
+    // The entries which have not been modified are still copied from the original archive while
+    // the new one is being written, so we can only replace it once that has completed.
+    if (!zipWriteArchive(storage,tempFilename,error)) {
+        DFDeleteFile(tempFilename,NULL);
+        goto end;
+    }
+
+    // The original has to be closed before it can be replaced on Windows. If replacing it fails,
+    // it is still intact, so we go back to reading the unmodified entries from there.
+    kept = DFHashTableNew(NULL,NULL);
+    if (hadArchive) {
+        for (int i = 0; i < storage->zipHandle->zipFileCount; i++) {
+            const char *fileName = storage->zipHandle->zipFileEntries[i].fileName;
+            if (DFHashTableLookup(storage->zipEntries,fileName) != NULL)
+                DFHashTableAdd(kept,fileName,"");
+        }
+    }
+
+    zipCloseArchive(storage);
+    if (!DFReplaceFile(tempFilename,storage->zipFilename,&errmsg)) {
+        DFErrorFormat(error,"%s: %s",storage->zipFilename,errmsg);
+        DFDeleteFile(tempFilename,NULL);
+        if (hadArchive)
+            zipReopenArchive(storage,kept);
+        goto end;
+    }
+
+    // Everything we had in memory is now in the archive, so switch back to reading from there
+    DFHashTableRelease(storage->zipWritten);
+    storage->zipWritten = DFHashTableNew(NULL,(DFFreeFunction)DFextZipStreamFree);
+    storage->modified = 0;
+    ok = zipOpenArchive(storage,error);
+
+end:
+    DFHashTableRelease(kept);
+    free(errmsg);
+    free(tempFilename);
+    return ok;
 }
 
 static int zipRead(DFStorage *storage, const char *path, void **buf, size_t *nbytes, DFError **error)
 {
-    DFBuffer *buffer = DFHashTableLookup(storage->files,path);
-    if (buffer == NULL) {
+    DFBuffer *buffer = DFHashTableLookup(storage->zipPending,path);
+    if (buffer == NULL)
+        buffer = DFHashTableLookup(storage->cache,path);
+    if (buffer != NULL) {
+        *buf = xmalloc(buffer->len);
+        memcpy(*buf,buffer->data,buffer->len);
+        *nbytes = buffer->len;
+        return 1;
+    }
+
+    DFextZipStreamP stream = DFHashTableLookup(storage->zipWritten,path);
+    if (stream != NULL) {
+        *buf = DFextZipStreamRead(stream);
+        *nbytes = stream->entry.uncompressedSize;
+        if (*buf == NULL) {
+            DFErrorFormat(error,"Cannot read file in zip");
+            return 0;
+        }
+        return 1;
+    }
+
+    DFextZipDirEntry *entry = DFHashTableLookup(storage->zipEntries,path);
+    if (entry == NULL) {
         DFErrorSetPosix(error,ENOENT);
         return 0;
     }
 
-    *buf = xmalloc(buffer->len);
-    memcpy(*buf,buffer->data,buffer->len);
-    *nbytes = buffer->len;
+    // Stored entries can be copied straight out of a mapped archive, so there's no point caching them
+    const void *view = DFextZipViewFile(storage->zipHandle,entry);
+    if (view != NULL) {
+        *buf = xmalloc(entry->uncompressedSize);
+        memcpy(*buf,view,entry->uncompressedSize);
+        *nbytes = entry->uncompressedSize;
+        return 1;
+    }
+
+    unsigned char *data = DFextZipReadFile(storage->zipHandle,entry);
+    if (data == NULL) {
+        DFErrorFormat(error,"Cannot read file in zip");
+        return 0;
+    }
+
+    zipCacheAdd(storage,path,data,entry->uncompressedSize);
+    *buf = data;
+    *nbytes = entry->uncompressedSize;
+    return 1;
+}
 
+// Unlike zipRead, this does not add the contents to the cache, as it is intended for entries that
+// are too large to be held in memory at once.
+
+static int zipReadChunks(DFStorage *storage, const char *path, DFStorageReadFunction fun, void *ctx, DFError **error)
+{
+    DFBuffer *buffer = DFHashTableLookup(storage->zipPending,path);
+    if (buffer == NULL)
+        buffer = DFHashTableLookup(storage->cache,path);
+    if (buffer != NULL) {
+        for (size_t pos = 0; pos < buffer->len; pos += STORAGE_CHUNK_SIZE) {
+            size_t len = buffer->len - pos;
+            if (len > STORAGE_CHUNK_SIZE)
+                len = STORAGE_CHUNK_SIZE;
+            if (!fun(ctx,&buffer->data[pos],len)) {
+                DFErrorFormat(error,"Read cancelled");
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    DFextZipStreamP stream = DFHashTableLookup(storage->zipWritten,path);
+    if (stream != NULL) {
+        if (!DFextZipStreamReadChunks(stream,fun,ctx)) {
+            DFErrorFormat(error,"Cannot read file in zip");
+            return 0;
+        }
+        return 1;
+    }
+
+    DFextZipDirEntry *entry = DFHashTableLookup(storage->zipEntries,path);
+    if (entry == NULL) {
+        DFErrorSetPosix(error,ENOENT);
+        return 0;
+    }
+
+    if (!DFextZipReadFileChunks(storage->zipHandle,entry,fun,ctx)) {
+        DFErrorFormat(error,"Cannot read file in zip");
+        return 0;
+    }
     return 1;
 }
 
+static void zipAddWritten(DFStorage *storage, const char *path, DFextZipStreamP stream)
+{
+    DFHashTableRemove(storage->zipPending,path);
+    DFHashTableAdd(storage->zipWritten,path,stream);
+    zipCacheRemove(storage,path);
+    storage->modified = 1;
+}
+
 static int zipWrite(DFStorage *storage, const char *path, void *buf, size_t nbytes, DFError **error)
 {
+    // Entry sizes are stored as ints, and we don't write zip64 archives
+    if (nbytes > INT_MAX) {
+        DFErrorFormat(error,"%s: Too large for a zip entry",path);
+        return 0;
+    }
+
     DFBuffer *buffer = DFBufferNew();
     DFBufferAppendData(buffer,buf,nbytes);
-    DFHashTableAdd(storage->files,path,buffer);
+    DFHashTableRemove(storage->zipWritten,path);
+    DFHashTableAdd(storage->zipPending,path,buffer);
     DFBufferRelease(buffer);
+    zipCacheRemove(storage,path);
+    storage->modified = 1;
     return 1;
 }
 
 static int zipExists(DFStorage *storage, const char *path)
 {
-    return (DFHashTableLookup(storage->files,path) != NULL);
+    return ((DFHashTableLookup(storage->zipPending,path) != NULL) ||
+            (DFHashTableLookup(storage->zipWritten,path) != NULL) ||
+            (DFHashTableLookup(storage->zipEntries,path) != NULL));
 }
 
-static int zipDelete(DFStorage *storage, const char *path, DFError **error)
+static int zipSize(DFStorage *storage, const char *path, size_t *nbytes)
 {
-    DFHashTableRemove(storage->files,path);
+    DFBuffer *buffer = DFHashTableLookup(storage->zipPending,path);
+    if (buffer != NULL) {
+        *nbytes = buffer->len;
+        return 1;
+    }
+
+    DFextZipStreamP stream = DFHashTableLookup(storage->zipWritten,path);
+    if (stream != NULL) {
+        *nbytes = stream->entry.uncompressedSize;
+        return 1;
+    }
+
+    DFextZipDirEntry *entry = DFHashTableLookup(storage->zipEntries,path);
+    if (entry == NULL)
+        return 0;
+    *nbytes = entry->uncompressedSize;
     return 1;
 }
 
-static const char **zipList(DFStorage *storage, DFError **error)
+// The CRC and size of every entry are known without inflating it: those in the archive come from its
+// central directory, and written ones are computed as the data is compressed. Pending entries are
+// still in memory uncompressed, so their CRC is cheap to compute.
+
+static int zipChecksum(DFStorage *storage, const char *path, uint32_t *crc, size_t *nbytes)
 {
-    return DFHashTableCopyKeys(storage->files);
+    DFBuffer *buffer = DFHashTableLookup(storage->zipPending,path);
+    if (buffer != NULL) {
+        *crc = (uint32_t)DFextZipCrc32(0,buffer->data,buffer->len);
+        *nbytes = buffer->len;
+        return 1;
+    }
+
+    DFextZipStreamP stream = DFHashTableLookup(storage->zipWritten,path);
+    DFextZipDirEntry *entry = (stream != NULL) ? &stream->entry : DFHashTableLookup(storage->zipEntries,path);
+    if (entry == NULL)
+        return 0;
+    *crc = (uint32_t)entry->crc32;
+    *nbytes = entry->uncompressedSize;
+    return 1;
+}
+
+static int zipDelete(DFStorage *storage, const char *path, DFError **error)
+{
+    DFHashTableRemove(storage->zipPending,path);
+    DFHashTableRemove(storage->zipWritten,path);
+    DFHashTableRemove(storage->zipEntries,path);
+    zipCacheRemove(storage,path);
+    storage->modified = 1;
+    return 1;
 }
 
 static DFStorageOps zipOps = {
     .save = zipSave,
     .read = zipRead,
+    .readChunks = zipReadChunks,
     .write = zipWrite,
     .exists = zipExists,
+    .size = zipSize,
+    .checksum = zipChecksum,
     .delete = zipDelete,
     .list = zipList,
 };
@@ -347,6 +837,22 @@ DFStorage *DFStorageNewMemory(DFFileFormat format)
     return storage;
 }
 
+static DFStorage *DFStorageNewZip(const char *filename)
+{
+    DFStorage *storage = DFStorageNew(DFFileFormatFromFilename(filename),&zipOps);
+    storage->zipFilename = xstrdup(filename);
+    storage->zipWritten = DFHashTableNew(NULL,(DFFreeFunction)DFextZipStreamFree);
+    storage->zipPending = DFHashTableNew((DFCopyFunction)DFBufferRetain,(DFFreeFunction)DFBufferRelease);
+    storage->zipEntries = DFHashTableNew(NULL,NULL);
+    storage->cache = DFHashTableNew((DFCopyFunction)DFBufferRetain,(DFFreeFunction)DFBufferRelease);
+    storage->cacheOrder = DFArrayNew((DFCopyFunction)xstrdup,(DFFreeFunction)free);
+    storage->cacheLimit = ZIP_DEFAULT_CACHE_LIMIT;
+    storage->threads = DFProcessorCount();
+    if (storage->threads > ZIP_DEFAULT_THREADS)
+        storage->threads = ZIP_DEFAULT_THREADS;
+    return storage;
+}
+
 DFStorage *DFStorageCreateZip(const char *filename, DFError **error)
 {
     // Note that with the current implementation, the file doesn't actually get saved until we do a DFStorageSave.
@@ -355,10 +861,7 @@ DFStorage *DFStorageCreateZip(const char *filename, DFError **error)
         return NULL;
     }
 
-    DFStorage *storage = DFStorageNew(DFFileFormatFromFilename(filename),&zipOps);
-    storage->files = DFHashTableNew((DFCopyFunction)DFBufferRetain,(DFFreeFunction)DFBufferRelease);
-    storage->zipFilename = xstrdup(filename);
-    return storage;
+    return DFStorageNewZip(filename);
 }
 
 DFStorage *DFStorageOpenZip(const char *filename, DFError **error)
@@ -368,11 +871,8 @@ DFStorage *DFStorageOpenZip(const char *filename, DFError **error)
         return NULL;
     }
 
-    DFStorage *storage = DFStorageNew(DFFileFormatFromFilename(filename),&zipOps);
-    storage->files = DFHashTableNew((DFCopyFunction)DFBufferRetain,(DFFreeFunction)DFBufferRelease);
-    storage->zipFilename = xstrdup(filename);
-
-    if (!DFUnzip(filename,storage,error)) {
+    DFStorage *storage = DFStorageNewZip(filename);
+    if (!zipOpenArchive(storage,error)) {
         DFStorageRelease(storage);
         return NULL;
     }
@@ -391,6 +891,13 @@ void DFStorageRelease(DFStorage *storage)
     if ((storage == NULL) || (--storage->retainCount > 0))
         return;
 
+    if (storage->zipHandle != NULL)
+        DFextZipClose(storage->zipHandle);
+    DFHashTableRelease(storage->zipWritten);
+    DFHashTableRelease(storage->zipPending);
+    DFHashTableRelease(storage->zipEntries);
+    DFHashTableRelease(storage->cache);
+    DFArrayRelease(storage->cacheOrder);
     DFHashTableRelease(storage->files);
     free(storage->rootPath);
     free(storage->zipFilename);
@@ -402,6 +909,21 @@ DFFileFormat DFStorageFormat(DFStorage *storage)
     return storage->format;
 }
 
+void DFStorageSetCacheLimit(DFStorage *storage, size_t nbytes)
+{
+    // Only zip storage objects have a cache; for the others there is nothing to bound
+    if (storage->cache == NULL)
+        return;
+    storage->cacheLimit = nbytes;
+    zipCacheTrim(storage,nbytes);
+}
+
+void DFStorageSetThreads(DFStorage *storage, int threads)
+{
+    // Only zip storage objects compress entries when saving
+    storage->threads = (threads > 1) ? threads : 1;
+}
+
 int DFStorageSave(DFStorage *storage, DFError **error)
 {
     return storage->ops->save(storage,error);
@@ -415,6 +937,30 @@ int DFStorageRead(DFStorage *storage, const char *path, void **buf, size_t *nbyt
     return r;
 }
 
+// Passes the contents of a file to fun in pieces, stopping if it returns 0. Storage types which
+// cannot do better than reading the whole file pass it in a single call.
+
+int DFStorageReadChunks(DFStorage *storage, const char *path, DFStorageReadFunction fun, void *ctx, DFError **error)
+{
+    char *fixed = fixPath(path);
+    int r = 0;
+    if (storage->ops->readChunks != NULL) {
+        r = storage->ops->readChunks(storage,fixed,fun,ctx,error);
+    }
+    else {
+        void *buf = NULL;
+        size_t nbytes = 0;
+        if (storage->ops->read(storage,fixed,&buf,&nbytes,error)) {
+            r = fun(ctx,buf,nbytes);
+            if (!r)
+                DFErrorFormat(error,"Read cancelled");
+            free(buf);
+        }
+    }
+    free(fixed);
+    return r;
+}
+
 int DFStorageWrite(DFStorage *storage, const char *path, void *buf, size_t nbytes, DFError **error)
 {
     char *fixed = fixPath(path);
@@ -431,6 +977,51 @@ int DFStorageExists(DFStorage *storage, const char *path)
     return r;
 }
 
+// Gets the (uncompressed) size of a file, without reading it. Returns 0 if the file does not exist.
+
+int DFStorageSize(DFStorage *storage, const char *path, size_t *nbytes)
+{
+    char *fixed = fixPath(path);
+    int r = storage->ops->size(storage,fixed,nbytes);
+    free(fixed);
+    return r;
+}
+
+typedef struct {
+    unsigned long crc;
+    size_t nbytes;
+} ChecksumState;
+
+static int checksumChunk(void *ctx, const void *buf, size_t nbytes)
+{
+    ChecksumState *state = (ChecksumState *)ctx;
+    state->crc = DFextZipCrc32(state->crc,buf,nbytes);
+    state->nbytes += nbytes;
+    return 1;
+}
+
+// Gets the CRC-32 and (uncompressed) size of a file. Zip storage already records these, so the file
+// is not read; for other storage types, its contents are passed through in chunks.
+
+int DFStorageChecksum(DFStorage *storage, const char *path, uint32_t *crc, size_t *nbytes, DFError **error)
+{
+    char *fixed = fixPath(path);
+    int r = 0;
+    if (storage->ops->checksum != NULL) {
+        r = storage->ops->checksum(storage,fixed,crc,nbytes);
+        if (!r)
+            DFErrorSetPosix(error,ENOENT);
+    }
+    else {
+        ChecksumState state = { 0, 0 };
+        r = DFStorageReadChunks(storage,fixed,checksumChunk,&state,error);
+        *crc = (uint32_t)state.crc;
+        *nbytes = state.nbytes;
+    }
+    free(fixed);
+    return r;
+}
+
 int DFStorageDelete(DFStorage *storage, const char *path, DFError **error)
 {
     char *fixed = fixPath(path);
@@ -443,3 +1034,65 @@ const char **DFStorageList(DFStorage *storage, DFError **error)
 {
     return storage->ops->list(storage,error);
 }
+
+// Streams let a caller write the contents of a file piece by piece. For zip storage, the data is
+// compressed as it arrives, so the uncompressed contents never need to be held in memory at once.
+// Other storage types collect the data in a buffer, and write it out when the stream is closed.
+
+DFStorageStream *DFStorageStreamOpen(DFStorage *storage, const char *path, DFError **error)
+{
+    DFStorageStream *stream = (DFStorageStream *)xcalloc(1,sizeof(DFStorageStream));
+    stream->storage = DFStorageRetain(storage);
+    stream->path = fixPath(path);
+    stream->ok = 1;
+    if (storage->ops == &zipOps) {
+        stream->zipStream = DFextZipStreamNew();
+        if (stream->zipStream == NULL) {
+            DFErrorFormat(error,"Cannot compress data");
+            DFStorageRelease(stream->storage);
+            free(stream->path);
+            free(stream);
+            return NULL;
+        }
+    }
+    else {
+        stream->buffer = DFBufferNew();
+    }
+    return stream;
+}
+
+int DFStorageStreamWrite(DFStorageStream *stream, const void *buf, size_t nbytes)
+{
+    if (!stream->ok)
+        return 0;
+    if (stream->zipStream != NULL)
+        stream->ok = (nbytes <= INT_MAX) && DFextZipStreamWrite(stream->zipStream,buf,(int)nbytes);
+    else
+        DFBufferAppendData(stream->buffer,buf,nbytes);
+    return stream->ok;
+}
+
+int DFStorageStreamClose(DFStorageStream *stream, DFError **error)
+{
+    int ok = 0;
+    if (stream->zipStream != NULL) {
+        if (stream->ok && DFextZipStreamFinish(stream->zipStream)) {
+            zipAddWritten(stream->storage,stream->path,stream->zipStream);
+            stream->zipStream = NULL;
+            ok = 1;
+        }
+        else {
+            DFErrorFormat(error,"Cannot compress data");
+        }
+    }
+    else {
+        ok = stream->storage->ops->write(stream->storage,stream->path,stream->buffer->data,stream->buffer->len,error);
+    }
+
+    DFextZipStreamFree(stream->zipStream);
+    DFBufferRelease(stream->buffer);
+    DFStorageRelease(stream->storage);
+    free(stream->path);
+    free(stream);
+    return ok;
+}
@@ -21,6 +21,7 @@
 #include "DFCharacterSet.h"
 #include "DFCommon.h"
 #include "DFFilesystem.h"
+#include "DFTextScan.h"
 #include <assert.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -205,7 +206,15 @@ int DFStringHasSuffix(const char *str, const char *suffix)
 
 int DFStringIsWhitespace(const char *str)
 {
-    size_t pos = 0;
+    // Skip any ASCII whitespace in bulk; only non-ASCII characters (which may be whitespace, such
+    // as a non-breaking space) need decoding
+    size_t len = strlen(str);
+    size_t pos = DFScanWhitespace(str,len);
+    if (pos == len)
+        return 1;
+    if ((unsigned char)str[pos] < 0x80)
+        return 0;
+
     uint32_t ch;
     while ((ch = DFNextChar(str,&pos)) != 0) {
         if (!DFCharIsWhitespaceOrNewline(ch))
@@ -270,24 +279,16 @@ char *DFStringNormalizeWhitespace(const char *input)
 
     char *output = (char *)xmalloc(inputLen+1);
 
-    size_t start = 0;
-    while ((start < inputLen) && isspace(input[start]))
-        start++;
-    size_t end = inputLen;
-    while ((end > start) && isspace(input[end-1]))
-        end--;
-    int haveSpace = 0;
-    for (size_t pos = start; pos < end; pos++) {
-        if (isspace(input[pos])) {
-            if (!haveSpace) {
-                output[outputLen++] = ' ';
-                haveSpace = 1;
-            }
-        }
-        else {
-            output[outputLen++] = input[pos];
-            haveSpace = 0;
-        }
+    // Copy each run of non-whitespace characters, with a single space between them
+    size_t pos = DFScanWhitespace(input,inputLen);
+    while (pos < inputLen) {
+        size_t wordLen = DFScanNonWhitespace(&input[pos],inputLen - pos);
+        if (outputLen > 0)
+            output[outputLen++] = ' ';
+        memcpy(&output[outputLen],&input[pos],wordLen);
+        outputLen += wordLen;
+        pos += wordLen;
+        pos += DFScanWhitespace(&input[pos],inputLen - pos);
     }
 
     assert(outputLen <= inputLen);
@@ -550,8 +551,17 @@ char *DFQuote(const char *in)
     char *out = (char*)xmalloc(2*inlen+3);
     size_t outlen = 0;
     out[outlen++] = '"';
-    for (size_t i = 0; i < inlen; i++) {
-        char c = in[i];
+    size_t i = 0;
+    while (i < inlen) {
+        // Copy everything up to the next character that may need escaping in one go
+        size_t run = DFScanFind(&in[i],inlen - i,"\"\\",DF_SCAN_CONTROL);
+        memcpy(&out[outlen],&in[i],run);
+        outlen += run;
+        i += run;
+        if (i >= inlen)
+            break;
+
+        char c = in[i++];
         switch (c) {
             case '"':
                 out[outlen++] = '\\';
@@ -0,0 +1,482 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "DFPlatform.h"
+#include "DFTextScan.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define DF_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 code is compiled using a function attribute, so that the rest of the library can still run
+// on processors without it, and is only used if the processor reports support at runtime
+#if defined(DF_SCAN_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DF_SCAN_AVX2 1
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2"),noinline))
+#endif
+
+#if defined(__GNUC__)
+#define lowestBit(mask) ((size_t)__builtin_ctz(mask))
+#elif defined(_MSC_VER)
+#include <intrin.h>
+static size_t lowestBit(unsigned int mask)
+{
+    unsigned long index;
+    _BitScanForward(&index,mask);
+    return index;
+}
+#endif
+
+typedef struct {
+    size_t (*find)(const char *data, size_t len, const char *chars, int flags);
+    size_t (*whitespace)(const char *data, size_t len);
+    size_t (*nonWhitespace)(const char *data, size_t len);
+    size_t (*utf8)(const char *data, size_t len);
+} DFScanFunctions;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                             Scalar                                             //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int isWhitespaceByte(unsigned char c)
+{
+    return ((c == ' ') || ((c >= '\t') && (c <= '\r')));
+}
+
+static int isFindByte(unsigned char c, const char *chars, int flags)
+{
+    if ((c < 0x20) && (flags & DF_SCAN_CONTROL))
+        return 1;
+    if ((c >= 0x80) && (flags & DF_SCAN_NON_ASCII))
+        return 1;
+    return ((c == chars[0]) || (c == chars[1]) || (c == chars[2]) || (c == chars[3]));
+}
+
+static size_t scalarFind(const char *data, size_t len, const char *chars, int flags)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while ((pos < len) && !isFindByte(bytes[pos],chars,flags))
+        pos++;
+    return pos;
+}
+
+static size_t scalarWhitespace(const char *data, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while ((pos < len) && isWhitespaceByte(bytes[pos]))
+        pos++;
+    return pos;
+}
+
+static size_t scalarNonWhitespace(const char *data, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while ((pos < len) && !isWhitespaceByte(bytes[pos]))
+        pos++;
+    return pos;
+}
+
+// Returns the length of the valid UTF-8 sequence at the start of bytes, or 0 if it is not valid
+
+static size_t utf8SequenceLength(const unsigned char *bytes, size_t len)
+{
+    unsigned char c = bytes[0];
+    if (c < 0x80)
+        return 1;
+
+    size_t count;
+    unsigned char min2 = 0x80; // limits on the second byte, which exclude overlong encodings,
+    unsigned char max2 = 0xBF; // surrogates and values above 0x10FFFF
+    if ((c >= 0xC2) && (c <= 0xDF)) {
+        count = 2;
+    }
+    else if ((c >= 0xE0) && (c <= 0xEF)) {
+        count = 3;
+        if (c == 0xE0)
+            min2 = 0xA0;
+        else if (c == 0xED)
+            max2 = 0x9F;
+    }
+    else if ((c >= 0xF0) && (c <= 0xF4)) {
+        count = 4;
+        if (c == 0xF0)
+            min2 = 0x90;
+        else if (c == 0xF4)
+            max2 = 0x8F;
+    }
+    else {
+        return 0;
+    }
+
+    if ((count > len) || (bytes[1] < min2) || (bytes[1] > max2))
+        return 0;
+    for (size_t i = 2; i < count; i++) {
+        if ((bytes[i] & 0xC0) != 0x80)
+            return 0;
+    }
+    return count;
+}
+
+static size_t scalarUTF8(const char *data, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while (pos < len) {
+        size_t count = utf8SequenceLength(&bytes[pos],len - pos);
+        if (count == 0)
+            break;
+        pos += count;
+    }
+    return pos;
+}
+
+static const DFScanFunctions scalarFunctions = {
+    scalarFind,
+    scalarWhitespace,
+    scalarNonWhitespace,
+    scalarUTF8,
+};
+
+#ifdef DF_SCAN_SSE2
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                              SSE2                                              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The comparison instructions are signed, so bytes 0x80 and above compare as less than zero. This
+// is used to pick out non-ASCII bytes, and to exclude them from the control characters.
+
+static size_t sse2Find(const char *data, size_t len, const char *chars, int flags)
+{
+    __m128i c0 = _mm_set1_epi8(chars[0]);
+    __m128i c1 = _mm_set1_epi8(chars[1]);
+    __m128i c2 = _mm_set1_epi8(chars[2]);
+    __m128i c3 = _mm_set1_epi8(chars[3]);
+    __m128i zero = _mm_setzero_si128();
+    __m128i space = _mm_set1_epi8(0x20);
+    size_t pos = 0;
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&data[pos]);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v,c0),_mm_cmpeq_epi8(v,c1)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v,c2),_mm_cmpeq_epi8(v,c3)));
+        if (flags & DF_SCAN_CONTROL)
+            m = _mm_or_si128(m,_mm_andnot_si128(_mm_cmplt_epi8(v,zero),_mm_cmplt_epi8(v,space)));
+        if (flags & DF_SCAN_NON_ASCII)
+            m = _mm_or_si128(m,_mm_cmplt_epi8(v,zero));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + scalarFind(&data[pos],len - pos,chars,flags);
+}
+
+static __m128i sse2WhitespaceMask(__m128i v)
+{
+    __m128i controls = _mm_and_si128(_mm_cmpgt_epi8(v,_mm_set1_epi8('\t' - 1)),
+                                     _mm_cmplt_epi8(v,_mm_set1_epi8('\r' + 1)));
+    return _mm_or_si128(controls,_mm_cmpeq_epi8(v,_mm_set1_epi8(' ')));
+}
+
+static size_t sse2Whitespace(const char *data, size_t len)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&data[pos]);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(sse2WhitespaceMask(v)) ^ 0xFFFF;
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + scalarWhitespace(&data[pos],len - pos);
+}
+
+static size_t sse2NonWhitespace(const char *data, size_t len)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&data[pos]);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(sse2WhitespaceMask(v));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + scalarNonWhitespace(&data[pos],len - pos);
+}
+
+// Blocks of ASCII are skipped in one step; anything else is checked a sequence at a time, until
+// the next block of ASCII
+
+static size_t sse2UTF8(const char *data, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while (pos < len) {
+        if (pos + 16 <= len) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&data[pos]);
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(v);
+            if (mask == 0) {
+                pos += 16;
+                continue;
+            }
+            pos += lowestBit(mask);
+        }
+        size_t count = utf8SequenceLength(&bytes[pos],len - pos);
+        if (count == 0)
+            break;
+        pos += count;
+    }
+    return pos;
+}
+
+static const DFScanFunctions sse2Functions = {
+    sse2Find,
+    sse2Whitespace,
+    sse2NonWhitespace,
+    sse2UTF8,
+};
+
+#endif // DF_SCAN_SSE2
+
+#ifdef DF_SCAN_AVX2
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                              AVX2                                              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// These are the same as the SSE2 versions, but 32 bytes at a time. AVX2 has no signed less-than
+// comparison, so the operands of greater-than are swapped instead.
+//
+// Short runs are passed to the SSE2 versions: most text nodes are short, and using the 256-bit
+// registers only occasionally makes things slower, as the processor keeps powering them up and down.
+// The length check is done outside of the AVX2 functions, so that the compiler cannot move any
+// AVX2 instructions ahead of it.
+
+#define AVX2_MIN_LENGTH 1024
+
+TARGET_AVX2 static size_t avx2FindLong(const char *data, size_t len, const char *chars, int flags)
+{
+    __m256i c0 = _mm256_set1_epi8(chars[0]);
+    __m256i c1 = _mm256_set1_epi8(chars[1]);
+    __m256i c2 = _mm256_set1_epi8(chars[2]);
+    __m256i c3 = _mm256_set1_epi8(chars[3]);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i space = _mm256_set1_epi8(0x20);
+    size_t pos = 0;
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&data[pos]);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v,c0),_mm256_cmpeq_epi8(v,c1)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v,c2),_mm256_cmpeq_epi8(v,c3)));
+        if (flags & DF_SCAN_CONTROL)
+            m = _mm256_or_si256(m,_mm256_andnot_si256(_mm256_cmpgt_epi8(zero,v),_mm256_cmpgt_epi8(space,v)));
+        if (flags & DF_SCAN_NON_ASCII)
+            m = _mm256_or_si256(m,_mm256_cmpgt_epi8(zero,v));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(m);
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + sse2Find(&data[pos],len - pos,chars,flags);
+}
+
+TARGET_AVX2 static __m256i avx2WhitespaceMask(__m256i v)
+{
+    __m256i controls = _mm256_and_si256(_mm256_cmpgt_epi8(v,_mm256_set1_epi8('\t' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1),v));
+    return _mm256_or_si256(controls,_mm256_cmpeq_epi8(v,_mm256_set1_epi8(' ')));
+}
+
+TARGET_AVX2 static size_t avx2WhitespaceLong(const char *data, size_t len)
+{
+    size_t pos = 0;
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&data[pos]);
+        unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(avx2WhitespaceMask(v));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + sse2Whitespace(&data[pos],len - pos);
+}
+
+TARGET_AVX2 static size_t avx2NonWhitespaceLong(const char *data, size_t len)
+{
+    size_t pos = 0;
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&data[pos]);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(avx2WhitespaceMask(v));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+    }
+    return pos + sse2NonWhitespace(&data[pos],len - pos);
+}
+
+TARGET_AVX2 static size_t avx2UTF8Long(const char *data, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t pos = 0;
+    while (pos < len) {
+        if (pos + 32 <= len) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)&data[pos]);
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(v);
+            if (mask == 0) {
+                pos += 32;
+                continue;
+            }
+            pos += lowestBit(mask);
+        }
+        else {
+            return pos + sse2UTF8(&data[pos],len - pos);
+        }
+        size_t count = utf8SequenceLength(&bytes[pos],len - pos);
+        if (count == 0)
+            break;
+        pos += count;
+    }
+    return pos;
+}
+
+static size_t avx2Find(const char *data, size_t len, const char *chars, int flags)
+{
+    if (len < AVX2_MIN_LENGTH)
+        return sse2Find(data,len,chars,flags);
+    return avx2FindLong(data,len,chars,flags);
+}
+
+static size_t avx2Whitespace(const char *data, size_t len)
+{
+    if (len < AVX2_MIN_LENGTH)
+        return sse2Whitespace(data,len);
+    return avx2WhitespaceLong(data,len);
+}
+
+static size_t avx2NonWhitespace(const char *data, size_t len)
+{
+    if (len < AVX2_MIN_LENGTH)
+        return sse2NonWhitespace(data,len);
+    return avx2NonWhitespaceLong(data,len);
+}
+
+static size_t avx2UTF8(const char *data, size_t len)
+{
+    if (len < AVX2_MIN_LENGTH)
+        return sse2UTF8(data,len);
+    return avx2UTF8Long(data,len);
+}
+
+static const DFScanFunctions avx2Functions = {
+    avx2Find,
+    avx2Whitespace,
+    avx2NonWhitespace,
+    avx2UTF8,
+};
+
+#endif // DF_SCAN_AVX2
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                           DFTextScan                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Selected on first use. Two threads may both do the selection, but they will arrive at the same
+// result, so this needs no locking. The pointer is still accessed atomically where the compiler
+// supports it, so that thread sanitizers do not report the (harmless) race.
+static const DFScanFunctions *scanFunctions = NULL;
+
+#ifdef __GNUC__
+#define loadFunctions() __atomic_load_n(&scanFunctions,__ATOMIC_RELAXED)
+#define storeFunctions(f) __atomic_store_n(&scanFunctions,(f),__ATOMIC_RELAXED)
+#else
+#define loadFunctions() (scanFunctions)
+#define storeFunctions(f) (scanFunctions = (f))
+#endif
+
+static const DFScanFunctions *functionsForLevel(DFScanLevel level)
+{
+    switch (level) {
+        case DFScanLevelScalar:
+            return &scalarFunctions;
+#ifdef DF_SCAN_SSE2
+        case DFScanLevelSSE2:
+            return &sse2Functions;
+#endif
+#ifdef DF_SCAN_AVX2
+        case DFScanLevelAVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &avx2Functions : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static const DFScanFunctions *getFunctions(void)
+{
+    const DFScanFunctions *current = loadFunctions();
+    if (current != NULL)
+        return current;
+
+    const DFScanFunctions *functions = functionsForLevel(DFScanLevelAVX2);
+    if (functions == NULL)
+        functions = functionsForLevel(DFScanLevelSSE2);
+    if (functions == NULL)
+        functions = functionsForLevel(DFScanLevelScalar);
+    storeFunctions(functions);
+    return functions;
+}
+
+int DFScanSetLevel(DFScanLevel level)
+{
+    const DFScanFunctions *functions = functionsForLevel(level);
+    if (functions == NULL)
+        return 0;
+    storeFunctions(functions);
+    return 1;
+}
+
+size_t DFScanFind(const char *data, size_t len, const char *chars, int flags)
+{
+    // Unused entries repeat the first character, so that every character can always be compared
+    char padded[4];
+    size_t count = strlen(chars);
+    for (size_t i = 0; i < 4; i++)
+        padded[i] = (i < count) ? chars[i] : chars[0];
+    return getFunctions()->find(data,len,padded,flags);
+}
+
+size_t DFScanWhitespace(const char *data, size_t len)
+{
+    return getFunctions()->whitespace(data,len);
+}
+
+size_t DFScanNonWhitespace(const char *data, size_t len)
+{
+    return getFunctions()->nonWhitespace(data,len);
+}
+
+size_t DFScanUTF8(const char *data, size_t len)
+{
+    return getFunctions()->utf8(data,len);
+}
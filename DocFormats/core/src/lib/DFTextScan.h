@@ -0,0 +1,64 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "DFTypes.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                           DFTextScan                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Scanning functions for the inner loops of text processing, such as finding the next character
+// that needs escaping. Each examines a run of bytes and returns the length of its prefix that
+// contains none of the bytes being looked for; a return value of len means there are none.
+//
+// On x86, these use SSE2 or AVX2 instructions, depending on what the processor supports, so that
+// long runs of plain ASCII text are handled 16 or 32 bytes at a time.
+
+// Flags for DFScanFind, adding classes of bytes to stop at
+#define DF_SCAN_CONTROL   1 // bytes below 0x20
+#define DF_SCAN_NON_ASCII 2 // bytes 0x80 and above
+
+// Stop at any of the (between one and four) ASCII characters in chars, or any byte in the classes
+// given by flags.
+size_t DFScanFind(const char *data, size_t len, const char *chars, int flags);
+
+// Stop at the first byte which is not ASCII whitespace (space, tab, newline, vertical tab, form
+// feed or carriage return)
+size_t DFScanWhitespace(const char *data, size_t len);
+
+// Stop at the first byte which is ASCII whitespace
+size_t DFScanNonWhitespace(const char *data, size_t len);
+
+// Stop at the first byte that does not form part of a valid UTF-8 sequence (this excludes overlong
+// encodings, surrogates, and values above 0x10FFFF). A sequence truncated by the end of the data
+// is considered invalid.
+size_t DFScanUTF8(const char *data, size_t len);
+
+// Which implementation to use. By default this is the best one the processor supports; tests can
+// set a specific one, to check that they all behave the same. Returns 0 if the requested one is
+// not supported.
+typedef enum {
+    DFScanLevelScalar,
+    DFScanLevelSSE2,
+    DFScanLevelAVX2,
+} DFScanLevel;
+
+int DFScanSetLevel(DFScanLevel level);
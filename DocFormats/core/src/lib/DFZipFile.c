@@ -22,6 +22,7 @@
 #include "DFString.h"
 #include "DFCommon.h"
 #include "DFBuffer.h"
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,52 +37,115 @@ static int zipError(DFError **error, const char *format, ...)
     return 0;
 }
 
+// Entries are handled in batches, so that in parallel mode every thread has something to do, while
+// only a limited number of entries is held in memory at once.
+#define ZIP_BATCH_PER_THREAD 4
+
 int DFUnzip(const char *zipFilename, DFStorage *storage, DFError **error)
 {
-    unsigned char   *buf;
+    return DFUnzipParallel(zipFilename,storage,1,error);
+}
+
+
+
+int DFUnzipParallel(const char *zipFilename, DFStorage *storage, int threads, DFError **error)
+{
     DFextZipHandleP  zipHandle;
-    int              i;
+    int              ok = 0;
 
     zipHandle = DFextZipOpen(zipFilename);
     if (!zipHandle)
       return zipError(error,"Cannot open file");
 
-    for (i = 0; i < zipHandle->zipFileCount; i++) {
-        if ( (buf = DFextZipReadFile(zipHandle, &zipHandle->zipFileEntries[i])) == NULL)
-            return zipError(error, "Cannot read file in zip");
-
-        DFBuffer *content = DFBufferNew();
-        DFBufferAppendData(content, (void *)buf, zipHandle->zipFileEntries[i].uncompressedSize);
-        free(buf);
-
-        if (!DFBufferWriteToStorage(content, storage, zipHandle->zipFileEntries[i].fileName, error)) {
-            DFBufferRelease(content);
-            return zipError(error, "%s: %s", zipHandle->zipFileEntries[i].fileName, DFErrorMessage(error));
+    if (threads < 1)
+        threads = 1;
+    int batchSize = threads*ZIP_BATCH_PER_THREAD;
+
+    for (int first = 0; first < zipHandle->zipFileCount; first += batchSize) {
+        int count = zipHandle->zipFileCount - first;
+        if (count > batchSize)
+            count = batchSize;
+
+        unsigned char **bufs = DFextZipReadFiles(zipHandle,first,count,threads);
+        int failed = 0;
+        int i;
+        for (i = 0; i < count; i++) {
+            DFextZipDirEntry *entry = &zipHandle->zipFileEntries[first+i];
+            if (bufs[i] == NULL) {
+                zipError(error,"Cannot read file in zip");
+                failed = 1;
+                break;
+            }
+
+            // Storage objects are not thread-safe, so the results are written one at a time, in order
+            int written = DFStorageWrite(storage,entry->fileName,bufs[i],entry->uncompressedSize,error);
+            free(bufs[i]);
+            bufs[i] = NULL;
+            if (!written) {
+                zipError(error,"%s: %s",entry->fileName,DFErrorMessage(error));
+                failed = 1;
+                break;
+            }
         }
-        DFBufferRelease(content);
+        for (; i < count; i++)
+            free(bufs[i]);
+        free(bufs);
+
+        if (failed)
+            goto end;
     }
+    ok = 1;
 
+end:
     DFextZipClose(zipHandle);
-
-    return 1;
+    return ok;
 }
 
-static int zipAddFile(DFextZipHandleP zipHandle, const char *dest, DFBuffer *content, DFError **error)
+
+
+typedef struct {
+    DFBuffer **contents;
+    DFextZipStreamP *streams;
+} ZipBatch;
+
+
+
+static void compressEntry(void *ctx, int index)
 {
-    if (DFextZipWriteFile(zipHandle, dest, content->data, content->len) < 0)
-        return zipError(error,"%s: Cannot create entry in zip file",dest);
-    return 1;
+    ZipBatch *batch = (ZipBatch *)ctx;
+    DFBuffer *content = batch->contents[index];
+    DFextZipStreamP stream = (content->len <= INT_MAX) ? DFextZipStreamNew() : NULL;
+    if ((stream != NULL) &&
+        (!DFextZipStreamWrite(stream,content->data,(int)content->len) || !DFextZipStreamFinish(stream))) {
+        DFextZipStreamFree(stream);
+        stream = NULL;
+    }
+    batch->streams[index] = stream;
 }
 
 
 
 int DFZip(const char *zipFilename, DFStorage *storage, DFError **error)
+{
+    return DFZipParallel(zipFilename,storage,1,error);
+}
+
+
+
+int DFZipParallel(const char *zipFilename, DFStorage *storage, int threads, DFError **error)
 {
     const char **allPaths = NULL;
-    DFBuffer *content = NULL;
     int ok = 0;
     DFextZipHandleP zipHandle = NULL;
 
+    if (threads < 1)
+        threads = 1;
+    int batchSize = threads*ZIP_BATCH_PER_THREAD;
+    ZipBatch batch;
+    batch.contents = (DFBuffer **)xcalloc(batchSize,sizeof(DFBuffer *));
+    batch.streams = (DFextZipStreamP *)xcalloc(batchSize,sizeof(DFextZipStreamP));
+    int count = 0;
+
     allPaths = DFStorageList(storage,error);
     if (allPaths == NULL || !(zipHandle = DFextZipCreate(zipFilename)))
     {
@@ -89,25 +153,46 @@ int DFZip(const char *zipFilename, DFStorage *storage, DFError **error)
     }
     else
     {
-      for (int i = 0; allPaths[i]; i++) {
-          const char *path = allPaths[i];
-
-          DFBufferRelease(content);
-          content = DFBufferReadFromStorage(storage,path,error);
-          if (content == NULL) {
-              DFErrorFormat(error,"%s: %s",path,DFErrorMessage(error));
-              goto end;
+      // Every entry is compressed the same way regardless of the number of threads, and they are
+      // written in the order listed, so the output does not depend on the number of threads
+      for (int first = 0; allPaths[first]; first += count) {
+          for (count = 0; (count < batchSize) && allPaths[first+count]; count++) {
+              const char *path = allPaths[first+count];
+              batch.contents[count] = DFBufferReadFromStorage(storage,path,error);
+              if (batch.contents[count] == NULL) {
+                  DFErrorFormat(error,"%s: %s",path,DFErrorMessage(error));
+                  goto end;
+              }
           }
 
-          if (!zipAddFile(zipHandle, path, content, error))
-              goto end;
+          DFRunParallel(count,threads,compressEntry,&batch);
+
+          for (int i = 0; i < count; i++) {
+              const char *path = allPaths[first+i];
+              if ((batch.streams[i] == NULL) || (DFextZipWriteStream(zipHandle,path,batch.streams[i]) == NULL)) {
+                  zipError(error,"%s: Cannot create entry in zip file",path);
+                  goto end;
+              }
+          }
+
+          for (int i = 0; i < count; i++) {
+              DFBufferRelease(batch.contents[i]);
+              DFextZipStreamFree(batch.streams[i]);
+              batch.contents[i] = NULL;
+              batch.streams[i] = NULL;
+          }
       }
 
       ok = 1;
     }
 
 end:
-    DFBufferRelease(content);
+    for (int i = 0; i < batchSize; i++) {
+        DFBufferRelease(batch.contents[i]);
+        DFextZipStreamFree(batch.streams[i]);
+    }
+    free(batch.contents);
+    free(batch.streams);
     free(allPaths);
     if (zipHandle != NULL)
         DFextZipClose(zipHandle);
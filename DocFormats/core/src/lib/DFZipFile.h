@@ -22,3 +22,8 @@
 
 int DFUnzip(const char *zipFilename, DFStorage *storage, DFError **error);
 int DFZip(const char *zipFilename, DFStorage *storage, DFError **error);
+
+// Same as the above, but inflating or deflating up to the given number of entries concurrently.
+// The resulting storage contents or zip file are identical to those produced by a single thread.
+int DFUnzipParallel(const char *zipFilename, DFStorage *storage, int threads, DFError **error);
+int DFZipParallel(const char *zipFilename, DFStorage *storage, int threads, DFError **error);
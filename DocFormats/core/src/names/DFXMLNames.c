@@ -20,7 +20,9 @@
 #define TAGS_C
 #include "DFXMLNames.h"
 #include "DFXMLNamespaces.h"
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 const TagDecl PredefinedTags[PREDEFINED_TAG_COUNT] = {
     { 0, NULL },
@@ -3377,3 +3379,363 @@ const TagDecl PredefinedTags[PREDEFINED_TAG_COUNT] = {
     { NAMESPACE_XML, "lang" },
     { NAMESPACE_XML, "space" },
 };
+
+static uint32_t hashMix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint32_t hashString(uint32_t seed, const char *str)
+{
+    uint32_t h = 2166136261U ^ seed;
+    for (const unsigned char *c = (const unsigned char *)str; *c != 0; c++)
+        h = (h ^ *c) * 16777619U;
+    return h;
+}
+
+static uint32_t hashSlot(uint32_t h, uint32_t displacement, uint32_t slotCount)
+{
+    return hashMix(h ^ (displacement * 0x9e3779b9U)) & (slotCount - 1);
+}
+
+static const uint16_t TagDisplacements[1024] = {
+    1,0,1,13,12,31,4,29,4,0,4,16,0,0,0,0,
+    7,2,7,26,0,9,13,0,3,50,2,0,1,4,0,0,
+    10,4,4,1,2,10,3,13,20,3,8,0,7,0,1,0,
+    2,4,0,2,3,9,1,0,0,2,3,3,9,1,1,3,
+    2,0,1,7,4,0,1,2,3,5,1,2,5,0,1,0,
+    0,73,5,7,6,11,2,6,1,6,0,5,28,46,0,7,
+    3,19,0,0,3,7,5,4,7,6,0,4,0,0,0,4,
+    0,3,0,4,3,1,3,0,4,0,24,13,2,5,12,0,
+    8,2,17,15,15,14,0,0,8,0,0,3,15,2,7,0,
+    1,2,1,37,0,1,0,0,19,1,1,1,1,1,7,0,
+    4,7,0,12,0,7,18,0,14,23,1,25,0,0,0,0,
+    13,0,6,0,10,11,0,12,21,1,7,6,12,0,0,4,
+    26,10,4,0,4,38,0,3,6,17,8,24,9,3,9,0,
+    10,5,10,5,0,1,4,2,1,11,0,14,0,7,4,0,
+    8,0,0,8,2,3,0,13,0,3,2,17,0,3,0,0,
+    9,4,0,5,0,18,10,5,32,0,6,1,3,1,0,2,
+    0,1,12,11,3,4,18,3,11,22,7,0,13,12,3,0,
+    10,5,2,2,9,0,7,0,20,3,1,4,30,8,11,11,
+    0,31,11,2,6,20,0,0,10,4,12,3,19,0,23,5,
+    3,0,40,4,5,0,0,2,0,11,3,2,0,3,2,24,
+    0,1,0,9,17,0,9,0,8,1,12,3,3,0,4,1,
+    7,1,2,1,0,14,0,11,2,13,4,13,4,37,1,9,
+    4,5,0,7,0,2,6,0,1,0,0,10,0,0,8,12,
+    1,15,2,0,8,14,1,7,8,0,19,26,14,33,0,3,
+    13,2,6,55,7,0,0,2,0,3,4,7,5,12,5,1,
+    2,12,14,12,5,3,7,20,23,0,1,0,42,7,5,4,
+    2,8,0,6,16,21,4,8,4,0,13,0,55,1,12,32,
+    4,19,5,2,33,2,1,0,32,4,0,3,0,18,0,0,
+    7,0,7,0,0,1,0,13,1,9,9,0,2,0,13,5,
+    13,6,2,7,8,16,3,0,25,18,11,13,5,8,1,1,
+    19,7,14,15,1,0,0,0,17,29,5,0,0,1,13,26,
+    4,7,9,5,9,4,24,13,5,59,24,6,4,26,0,1,
+    12,0,43,4,11,0,6,2,0,2,7,12,3,8,0,0,
+    12,18,11,2,13,18,5,0,0,16,0,0,0,9,38,40,
+    19,12,2,2,1,0,2,0,9,28,0,3,2,24,3,12,
+    0,3,2,9,3,0,4,14,14,10,4,23,20,29,1,17,
+    0,2,4,9,19,4,3,14,3,8,0,7,42,5,8,0,
+    3,4,12,22,15,0,4,7,10,0,0,5,4,56,0,3,
+    2,19,2,8,4,6,58,4,4,2,2,0,6,12,28,9,
+    2,2,0,2,8,22,4,5,0,5,0,23,16,1,1,10,
+    8,3,2,4,0,1,7,30,1,14,3,17,15,11,71,6,
+    0,1,30,15,7,1,1,3,15,0,2,2,62,12,9,6,
+    4,12,17,1,35,20,13,6,0,40,9,1,17,14,18,4,
+    0,18,12,1,0,2,1,13,24,10,4,14,9,34,4,0,
+    0,18,10,0,18,11,3,29,38,38,4,0,0,63,1,12,
+    24,0,1,34,10,9,2,0,14,0,1,1,7,12,1,13,
+    31,6,14,2,12,2,12,2,13,0,67,45,17,4,2,2,
+    29,41,10,12,0,15,1,2,7,20,42,7,3,4,9,39,
+    12,39,0,35,35,10,0,0,8,54,2,61,0,9,25,15,
+    15,2,3,0,0,14,7,2,13,37,0,2,14,0,0,6,
+    59,5,12,17,0,16,1,7,13,0,11,23,0,0,5,17,
+    0,34,26,11,10,42,34,3,63,60,8,5,27,2,0,2,
+    33,0,0,2,10,7,0,8,5,8,5,0,9,35,2,24,
+    17,17,27,2,5,29,1,0,6,29,1,0,2,2,20,3,
+    25,16,0,32,5,5,13,0,12,16,0,18,1,48,56,16,
+    3,2,11,41,16,0,17,0,19,8,9,7,13,37,6,0,
+    20,3,0,31,0,1,10,72,36,15,11,11,0,0,12,14,
+    15,15,9,5,5,0,7,4,25,0,14,9,2,0,26,0,
+    3,8,28,9,14,36,5,2,3,3,0,3,1,5,7,6,
+    0,45,20,9,8,4,4,6,25,1,49,0,0,19,11,40,
+    32,4,7,14,1,0,3,27,1,2,2,17,55,12,12,14,
+    8,10,83,9,1,9,29,6,69,27,11,29,51,1,16,0,
+    9,31,12,30,41,4,1,1,4,11,15,35,9,14,25,0,
+    14,5,4,5,3,2,22,55,11,83,6,0,26,14,3,4,
+};
+
+static const uint16_t TagSlots[4096] = {
+    62,83,3163,2894,2075,858,312,1956,1745,2167,12,2313,528,1029,0,0,
+    0,605,327,857,2110,865,1198,517,676,1806,1596,2421,0,2636,1981,0,
+    982,73,0,3248,698,1362,1620,2460,1291,2511,2197,1004,920,309,1314,2908,
+    2844,0,1184,1397,3143,0,854,2293,2445,493,2552,2547,2118,2329,3056,197,
+    0,2528,3083,1349,0,0,662,842,0,1368,1652,399,892,3031,1699,1668,
+    435,0,2267,3273,2599,1174,1212,1807,1347,1434,539,2401,596,357,2512,0,
+    2136,2173,3166,0,3224,404,1038,2223,41,0,2082,2723,2235,0,19,432,
+    1719,3326,1798,1744,86,1618,1612,2813,3149,2315,0,666,1585,0,1898,870,
+    1020,2914,2524,1989,3129,811,1573,1299,161,0,3059,0,1666,555,2102,2473,
+    2698,0,3155,17,2210,1590,2024,537,2297,3039,937,1758,1867,1088,44,0,
+    2717,1494,0,1244,1251,0,1178,0,1917,1891,2265,1786,1930,2556,3343,2058,
+    3172,1372,1488,2693,2437,1572,772,833,0,3266,618,2439,0,82,129,0,
+    1014,2597,280,452,1690,3170,608,851,2394,992,1455,0,3092,107,746,2028,
+    30,0,0,0,1373,2156,939,0,2138,0,2951,1025,976,588,303,2918,
+    1024,0,1172,689,3185,2175,0,2497,1951,589,1387,469,2668,2803,656,0,
+    0,1965,3208,687,3198,0,1781,375,1487,1240,2557,2260,373,0,2770,2041,
+    2525,918,166,2056,3127,577,2860,1883,875,355,2692,2404,2361,759,2013,2729,
+    1261,0,3216,2017,1265,0,22,0,1809,0,2767,0,2893,0,3301,1183,
+    2007,1458,3229,3213,2021,0,2733,1519,682,0,3108,2339,0,0,3126,2150,
+    2444,2581,716,2312,1987,2019,3034,168,2587,630,1100,782,1984,0,566,66,
+    2079,0,1986,1000,2869,0,3272,3232,0,2669,403,2553,0,2196,753,2815,
+    2448,2854,803,457,1919,1562,2766,2108,25,225,1416,0,2763,1111,2859,3268,
+    628,2877,623,519,428,598,1760,654,1401,678,0,1124,2754,0,1784,2322,
+    3289,0,0,2890,2946,262,495,480,938,318,1644,227,231,1157,2129,0,
+    0,172,2258,0,1213,886,2217,1219,1342,1645,0,0,2519,0,1110,2081,
+    1979,2902,51,0,2287,704,867,724,0,1945,738,0,0,2248,2931,2236,
+    0,148,777,2662,1913,2349,2781,0,2036,2762,2674,981,2284,3315,126,0,
+    928,1063,413,1353,1441,2378,2950,2431,2949,901,2063,0,1955,0,2290,0,
+    2057,277,476,320,2303,3203,2642,791,525,3038,575,2579,96,520,3282,0,
+    388,2796,0,79,0,801,2966,794,3253,28,0,1499,1466,800,1345,1344,
+    944,0,644,0,0,1826,1089,3000,913,625,0,1090,3161,334,1102,2793,
+    1954,1639,3186,846,1837,606,0,0,1907,700,104,0,1862,2871,750,0,
+    2214,506,2164,3209,775,0,0,0,0,204,1780,1932,3340,0,90,0,
+    371,706,0,2670,3089,2576,2238,459,0,89,0,0,0,3238,194,1127,
+    882,747,1878,0,2364,0,2160,0,1598,0,1571,914,1011,3331,1243,2140,
+    224,454,581,1225,2375,735,492,0,1761,0,0,2443,0,0,1033,853,
+    989,1977,345,709,3084,0,1150,1279,486,884,0,1337,2040,1581,741,1077,
+    409,547,1636,688,0,3157,0,2299,1670,0,0,2014,0,3002,2240,2309,
+    2032,2759,2387,1034,0,2088,2270,2222,2415,2892,3307,715,1237,0,1587,2985,
+    1600,2861,2412,1136,0,0,1728,2704,0,3014,2833,2030,142,1682,2035,1993,
+    1916,0,1525,926,3073,2280,0,2141,346,1657,934,2039,1005,3106,1584,818,
+    1468,1894,2490,1079,1017,2126,85,0,2628,0,727,2459,1227,1627,0,2868,
+    1341,136,1190,2244,2342,792,0,629,230,0,2031,2211,670,1810,0,295,
+    3249,526,0,2749,572,0,2906,0,3323,2593,2995,2620,0,821,701,2279,
+    2681,567,1855,169,1413,3329,1317,95,868,0,0,2970,1943,916,0,2790,
+    2737,1504,1857,2953,1991,0,576,1998,0,222,888,0,3302,2292,0,1054,
+    2273,2049,0,3214,0,2943,993,3195,2144,1542,205,845,1976,0,1223,2469,
+    472,2199,1205,0,3207,1472,0,2589,0,0,0,1289,1933,0,1565,2621,
+    1319,1821,1238,54,1253,0,3328,2568,0,0,1738,0,385,229,1352,171,
+    1216,3117,0,2683,122,1501,3018,2538,908,2540,1731,2192,102,2317,3310,1241,
+    429,0,1324,2052,1457,2641,0,3234,0,2875,0,3070,2452,1770,298,2250,
+    2886,0,2542,2450,182,3309,1609,1478,1312,968,1202,1847,2960,0,2611,2239,
+    2828,1510,35,0,2492,1370,21,2695,0,14,1672,1568,1674,3335,0,2517,
+    0,1461,3158,1539,1548,353,1515,0,1535,0,1778,2043,852,337,1403,0,
+    0,503,2487,1885,1126,124,586,2756,1009,0,2396,962,2420,991,1290,0,
+    1443,0,2742,1882,876,569,177,311,652,1662,317,0,0,1558,2539,1708,
+    965,498,1648,2822,2137,1689,2616,1123,2917,2152,1858,708,88,2347,841,1912,
+    2701,1673,1697,1407,0,1006,624,1232,1538,3013,814,3135,1616,0,1729,2841,
+    2423,1595,3265,3082,3261,3189,2999,0,1860,1533,1886,0,3159,175,1343,2863,
+    1597,828,1752,2991,0,241,2715,0,2012,2441,2005,2414,2768,0,1166,0,
+    2103,2761,3175,603,0,0,11,1740,2153,2483,0,0,2929,1106,1549,0,
+    3080,1128,3320,2390,0,1201,1091,2154,167,0,825,3306,820,1154,544,2308,
+    0,1975,0,2207,2463,178,1425,366,2858,0,2027,0,2584,344,0,0,
+    693,2476,2319,855,3152,1092,0,1081,0,1348,1853,0,0,3332,2832,2237,
+    1815,2617,1583,0,2820,2688,423,1944,1301,1747,1426,2614,2624,354,1614,2357,
+    812,2566,2282,0,1179,240,755,1181,267,3194,1874,3279,3168,3346,2295,368,
+    3291,0,306,767,2994,919,0,1816,0,45,244,2696,0,2464,2776,3110,
+    2440,2997,2363,0,367,0,1742,31,3204,1735,3144,1534,1774,2026,2479,1877,
+    440,0,0,153,0,2955,2971,964,658,0,705,793,2667,1239,1814,474,
+    36,2821,2807,0,1359,0,0,1008,2567,1687,1429,0,2432,847,2979,2225,
+    3347,24,206,117,1022,2086,0,2823,3028,3241,2268,2352,2722,776,819,2987,
+    0,247,3148,729,721,545,977,2885,1366,1705,568,2127,877,3140,3300,985,
+    1978,955,604,2434,2246,2753,0,660,271,2975,0,278,808,2447,2612,0,
+    2380,2660,3180,0,692,1679,0,1785,1836,217,711,2543,0,2391,0,2713,
+    0,1890,0,2493,834,2939,2791,2513,1463,1222,300,3259,3112,0,2702,3128,
+    2230,181,798,2689,0,2736,3260,1058,930,2172,1200,2842,1952,381,304,3090,
+    1453,1192,0,2916,718,2595,1263,3254,2477,2657,2853,3243,285,1464,1435,0,
+    736,3228,752,1257,2661,1066,1929,1383,0,2541,0,0,1725,3314,0,2367,
+    739,1398,1593,1074,0,1402,2521,2673,1813,2381,1316,2006,0,2630,0,615,
+    213,1962,2481,0,712,0,1180,46,1414,185,672,323,514,2411,3290,198,
+    1328,2234,690,1087,866,958,898,100,2536,807,202,0,1643,1491,0,1791,
+    49,0,1495,2500,0,1637,0,3233,407,0,203,972,0,0,308,3286,
+    0,2256,1389,502,998,1528,2922,2106,3050,1713,1396,1042,379,2976,646,0,
+    0,912,183,848,2647,1309,259,1131,3188,2163,3231,761,956,1498,548,531,
+    0,3297,1204,0,610,717,0,2226,1338,2638,0,0,2055,2220,0,1030,
+    2344,2187,2337,2904,0,1994,0,508,1335,0,2725,1332,2346,0,0,133,
+    2752,0,826,1287,1026,0,1640,2430,1717,2909,2559,1271,0,1766,2527,861,
+    2119,0,1185,1966,252,430,1056,421,2418,1632,2936,1197,0,2980,1315,633,
+    0,3288,2332,0,488,1915,967,1775,0,2755,387,2829,1194,281,412,0,
+    2819,1475,2878,0,0,1019,0,3217,3227,0,1211,2185,93,1256,2071,0,
+    1096,2283,1437,3225,1642,1830,859,119,1132,2062,1653,2570,1946,787,1947,836,
+    442,445,2231,844,0,1115,3093,0,190,562,1669,0,984,2286,0,1393,
+    1285,754,1828,2259,587,1369,3118,2305,2964,0,2773,0,2809,549,2924,2484,
+    1659,1953,1298,536,2895,3036,2898,1055,1107,68,0,1734,1160,1763,2120,132,
+    1751,3107,3269,2789,507,2926,0,683,0,2148,1236,0,0,465,2413,2721,
+    0,0,2992,0,2817,75,1526,563,3281,0,150,0,0,1881,0,1221,
+    2996,2972,3138,1686,1428,565,1080,1215,0,0,2747,1579,1899,2335,1545,1085,
+    331,0,1601,0,1143,673,815,2623,3169,2626,2714,885,0,2326,2634,2656,
+    802,0,742,3303,0,881,947,0,2981,1078,2537,3292,3074,675,0,163,
+    0,2550,3285,0,1282,1509,2195,3009,960,1846,966,1419,2174,1948,2780,1608,
+    1693,1704,1053,1039,996,1804,329,1336,557,209,444,449,1893,769,3147,2327,
+    0,917,748,2472,77,2008,433,2206,2462,3077,1459,2760,0,2651,2930,1050,
+    1969,1647,0,1129,463,0,0,3222,1646,2812,3342,1365,2835,3176,1406,1844,
+    2105,890,0,599,2741,0,2983,2615,2480,0,1541,0,2467,1634,1604,0,
+    959,0,1554,0,2968,0,0,0,2194,1879,2501,2261,2101,38,1527,1958,
+    2294,942,0,2633,473,1331,518,0,2718,3296,301,2107,3336,2115,1169,0,
+    362,774,246,2204,2406,2738,61,3348,2799,3024,887,2371,0,2772,0,2546,
+    0,786,215,730,641,2643,663,560,2910,1015,0,2044,1511,1635,1306,0,
+    2802,1514,1484,2419,1928,948,2362,3115,3078,1530,1619,0,2529,0,781,290,
+    2649,234,2417,3124,0,69,1400,32,2731,527,2607,1716,1294,2215,0,647,
+    2896,0,1959,1592,0,0,0,1681,895,0,110,0,0,3178,1206,10,
+    0,236,0,2622,3037,2775,3276,0,883,681,3230,2112,3094,979,546,2134,
+    343,940,2544,1927,2732,1623,1082,1829,1140,0,643,671,1379,3111,1768,342,
+    3099,765,3263,1065,3218,1547,1996,0,275,1062,1564,2740,3125,731,2644,2903,
+    289,1800,1148,0,648,2264,0,0,57,155,2216,1599,995,1103,0,3190,
+    2400,1638,145,1903,1167,1852,2872,935,2818,2209,2654,2830,1939,1399,2947,1485,
+    804,2132,1330,1589,3280,911,0,201,1218,640,0,2640,523,1875,3337,390,
+    1570,2911,2242,3183,3308,891,2087,0,0,253,1438,243,2274,1278,2356,0,
+    0,0,154,3262,324,2422,160,0,417,1992,0,1288,501,1906,0,1195,
+    2677,1803,2711,1444,2919,2880,3066,1226,478,3236,0,2368,1101,3003,1141,0,
+    174,74,1295,1923,2353,2436,67,2499,778,0,1068,1749,1500,2457,2814,43,
+    2224,773,686,3250,2377,584,286,1726,0,0,2135,0,0,3067,2804,1556,
+    0,1773,2708,2184,614,2850,2948,1476,0,263,2228,1378,1308,2963,1888,1667,
+    0,2716,0,94,1260,386,1173,1300,1825,1621,1677,3116,1711,1427,2098,2047,
+    3221,0,0,2900,0,72,1156,2663,2757,1046,1171,2080,2923,0,653,0,
+    0,1442,668,2811,1086,0,2114,900,0,2372,551,3103,2324,0,0,0,
+    97,0,2219,1471,2001,1168,2604,806,3001,1714,414,0,987,843,1695,2606,
+    0,173,832,1764,762,1448,1246,2263,2453,2399,2424,0,0,3071,988,3081,
+    1360,455,975,1013,1540,2613,162,2288,0,0,2535,0,0,438,193,1822,
+    333,251,2386,250,505,415,620,0,2178,664,0,2941,2360,1771,2961,1149,
+    348,864,732,1358,2691,3022,590,1818,3030,0,1957,0,601,3097,1286,180,
+    2323,2025,2564,0,2298,1868,316,0,1812,592,0,837,2449,0,0,925,
+    0,0,3091,0,0,0,1138,1739,1450,2927,2428,1023,2376,384,2020,2899,
+    3256,2262,1064,0,467,0,535,235,1235,3057,1754,296,1037,860,933,2331,
+    1910,0,2090,2011,1269,1094,1071,0,827,2189,378,0,2957,0,0,1506,
+    65,462,0,2928,1069,1432,2117,2382,70,1520,92,829,1767,27,1617,2938,
+    2937,1133,157,532,0,1059,3191,2750,0,3278,1304,2739,515,1871,460,0,
+    3100,2266,2300,1866,2275,0,3277,0,1310,80,2710,192,932,1702,1155,0,
+    3313,2988,3201,3139,0,2665,2558,1787,2495,0,0,3096,1850,869,1921,1492,
+    1075,1153,0,397,3257,2751,0,3154,838,34,2072,931,2687,0,112,1941,
+    2426,1980,2779,2128,3171,0,3345,1375,734,1374,2070,0,1151,1563,840,593,
+    377,2503,1896,2834,0,23,0,3197,0,3205,3049,1995,2825,0,1207,322,
+    1404,2095,207,2188,1233,0,1258,214,0,195,2383,2398,0,0,0,0,
+    1113,3245,1776,0,1137,0,661,299,1364,2466,1936,1529,1303,1480,823,2161,
+    2113,1377,0,0,3160,1613,272,1187,1823,401,2632,2427,0,408,0,1712,
+    1259,3193,2728,2456,0,2285,0,347,416,0,1895,2586,1268,87,3150,1543,
+    0,1522,2251,1788,0,1870,2139,0,2000,1162,0,785,3052,2177,99,1439,
+    3255,994,326,1513,2915,1469,140,3237,703,499,941,210,1228,3098,325,0,
+    1553,2637,265,3316,0,380,756,370,797,237,1611,862,1479,789,0,2471,
+    2193,1421,1391,2186,1552,2783,383,3173,1851,2548,1940,1048,1371,0,0,165,
+    114,542,1382,559,1002,878,3352,1832,2956,2843,147,2580,1210,422,76,0,
+    1630,2962,2121,1737,0,1900,3010,245,856,131,3210,491,999,483,47,2712,
+    3167,2744,1724,2074,3025,1848,2563,2806,3275,0,3042,2857,3101,2977,0,0,
+    749,788,2155,1163,1566,1449,0,1743,951,616,293,0,199,2042,2029,1622,
+    238,2921,850,2470,2671,631,439,3156,637,2650,2726,0,1580,3095,1801,2560,
+    597,2291,2366,2745,3072,1367,0,2168,1452,3351,2920,170,3109,1250,1762,424,
+    2046,0,0,1649,699,0,0,3032,0,2002,0,418,0,813,405,248,
+    305,0,1845,144,3085,720,0,2465,2881,1302,3005,1794,1423,3007,2509,0,
+    0,2096,2015,2053,512,2278,0,725,2162,2545,0,573,1512,0,0,2727,
+    2455,2873,0,1629,481,434,2094,3069,0,2083,2824,3047,427,2358,2680,909,
+    1117,0,358,3130,0,1748,1264,3027,200,2004,0,291,1938,0,0,1412,
+    924,0,0,3132,2151,1270,310,450,2679,1582,0,2912,873,1125,2269,2719,
+    2506,0,2485,1411,600,1093,2351,713,0,2059,3113,1116,1914,0,1297,1097,
+    2856,2073,0,894,1390,2510,359,1544,0,2143,2345,2104,2596,0,2659,3026,
+    1255,1624,0,2311,352,220,1974,2482,335,2354,0,0,2870,0,2849,2990,
+    0,1723,78,0,2037,1502,0,0,456,2045,223,2454,443,3076,1656,1175,
+    146,1578,2359,595,489,3223,188,1084,3242,1405,822,2389,0,2551,0,3123,
+    1827,0,2016,2060,2064,0,2840,2435,372,0,0,1152,2583,0,2271,0,
+    1889,2765,2795,1440,2068,1410,2805,2882,3011,1433,907,835,268,2839,889,274,
+    1114,2572,186,208,0,3054,921,3102,1277,2645,0,3019,0,0,1422,3012,
+    1536,116,3271,0,0,2369,1060,0,1683,266,216,3122,936,1203,2227,1012,
+    521,1887,2233,441,554,1191,0,0,0,1843,2033,0,2276,3058,260,1524,
+    1660,1247,635,2585,0,2534,655,990,0,3088,2706,0,1249,0,288,0,
+    530,594,1908,232,3051,3043,1722,0,0,1073,0,983,677,3341,961,2159,
+    816,0,0,0,2864,674,849,0,3187,0,543,0,2694,58,1018,158,
+    1777,1208,2746,0,282,0,1188,2289,0,2944,3215,13,425,1949,0,2784,
+    795,0,0,0,0,0,997,1339,2306,0,2577,2748,906,685,1320,1186,
+    1772,3350,2475,0,3162,482,121,522,3264,634,1040,2837,2851,2145,0,257,
+    395,2523,458,2876,2438,1550,0,2451,1070,710,1756,0,130,0,0,2190,
+    338,626,0,1935,1876,1122,2077,1718,279,1384,389,3136,1838,0,2241,125,
+    1296,2350,0,1720,0,2986,3267,737,50,1819,2504,1715,0,0,42,3181,
+    1292,1707,2826,0,0,1351,2478,1982,2631,1462,2973,1709,2777,138,84,3294,
+    0,986,191,0,1392,1727,0,3196,1177,2061,564,109,0,1736,1224,0,
+    339,1577,1363,292,3239,0,0,1817,3199,0,2609,376,2176,2883,0,1970,
+    1795,1960,2699,1972,0,2314,2867,3299,1045,2085,2578,2302,2296,451,2575,1036,
+    2697,2602,105,963,1793,1963,622,1135,2831,2065,607,3086,0,2984,3079,1859,
+    2827,2255,949,2700,1701,2764,2502,0,490,970,0,0,0,1118,2549,540,
+    2133,915,128,1445,487,760,143,1321,1924,0,2416,0,1355,0,2639,0,
+    3219,2574,1678,1381,2707,1650,2588,3041,255,0,256,2664,2157,2703,0,2590,
+    810,0,0,863,1083,2958,2866,1802,1861,0,609,1467,0,2221,0,2338,
+    426,0,1327,2182,2554,0,0,2252,2009,2384,1041,2336,2092,2600,619,541,
+    2067,164,1493,0,3192,350,3349,176,2862,0,529,396,728,1665,2316,553,
+    2253,684,349,3068,0,831,1824,391,1560,779,3317,496,2038,1799,0,0,
+    0,37,1985,1061,0,1376,1139,108,1808,1628,2111,2933,1323,2678,56,2846,
+    2461,2247,0,1415,679,1490,2758,1016,3338,817,2974,578,0,0,2341,1902,
+    374,1044,2091,0,3048,0,2978,1676,18,0,1869,2530,0,3035,2935,52,
+    0,2592,2913,1811,1999,400,1182,552,0,3211,1229,15,2257,3251,1325,0,
+    0,2686,3325,3334,1134,3142,0,461,1276,3339,639,0,1098,2516,1968,1027,
+    659,945,2788,2158,0,341,2410,2498,141,1483,2889,3114,2433,2965,2078,1417,
+    0,283,719,1473,2605,2474,1721,971,270,2932,2425,0,1350,556,0,3295,
+    3274,3244,1517,0,0,1120,1465,33,0,3220,0,2373,0,2653,1477,880,
+    1884,1607,1841,0,874,159,2709,1049,2940,621,2333,2200,1790,0,3008,2925,
+    899,0,1559,1911,2084,1220,332,1164,1214,2328,1569,0,723,0,1447,39,
+    824,2281,3062,287,1051,3312,221,1144,1481,0,2050,3184,3145,1626,0,667,
+    2625,768,1675,179,137,2993,1746,790,2969,0,1741,2169,0,0,1119,1633,
+    2573,2666,696,2277,1262,3146,2816,1482,0,392,2048,0,0,3212,2520,3065,
+    189,879,1523,1436,1755,0,1664,364,1706,313,3133,0,466,0,219,1099,
+    1305,2888,1574,550,2610,538,611,3202,582,1655,3120,2508,2901,3226,1021,612,
+    3141,2646,330,0,2393,3055,533,571,2229,3121,0,0,1031,2801,0,0,
+    1531,534,2887,1326,0,2201,0,1104,2879,3021,657,0,1671,0,0,1796,
+    1409,1904,1230,319,2771,2165,1333,2066,0,2254,115,2619,218,2730,1394,745,
+    504,897,1792,1750,1047,0,2959,580,2370,365,1159,152,0,2180,1273,583,
+    1266,954,1234,2569,2845,2403,1112,127,91,2307,2989,3246,2018,2800,297,1388,
+    510,2608,2069,2891,16,1551,1313,0,0,0,363,2212,1267,149,1733,120,
+    0,2648,1147,904,927,1329,0,1797,0,1863,2442,2397,0,0,431,0,
+    1546,0,2109,0,0,561,26,632,1456,71,2629,419,1193,2130,2486,3063,
+    151,0,1231,1692,1931,2734,2778,2429,0,2782,1532,1446,1380,1284,2385,0,
+    1610,2945,2023,0,910,1424,0,447,1658,3305,2123,0,627,744,0,239,
+    1454,757,2515,1586,1146,0,1121,650,242,0,796,106,3182,1420,3134,1703,
+    264,2591,294,1937,3016,2334,3270,212,1685,0,1905,3020,3200,1035,261,2769,
+    0,613,3330,0,254,0,1340,1922,2797,1357,636,3319,2942,0,2076,1849,
+    943,2218,0,1158,1779,3327,1631,0,1052,929,602,0,0,1594,284,1654,
+    784,2786,0,1489,233,1474,3324,2785,1430,1680,3104,2191,2682,2125,1942,0,
+    1145,0,2388,2166,2321,2099,980,1694,3029,0,1307,2685,1805,2743,1356,0,
+    2676,1971,516,394,1710,2874,393,665,0,1408,2787,0,3283,1003,0,0,
+    448,2571,2446,651,1576,2555,0,500,1997,3333,0,1130,1176,1591,0,1161,
+    1245,2343,3119,1293,2310,3151,733,1967,1346,758,1248,3137,809,2565,118,3087,
+    1518,694,436,558,103,2998,905,3206,574,902,228,2409,3240,1567,0,410,
+    1252,1095,3044,1864,2205,2147,0,780,0,1625,513,302,0,2232,764,707,
+    0,585,276,1067,770,0,123,1561,2408,2836,1283,0,2724,2142,1497,1507,
+    29,957,871,464,1856,59,570,740,1322,2245,2954,411,60,1842,2468,702,
+    1032,1072,3064,2720,0,0,896,2518,0,1934,722,1783,3298,1769,1254,2348,
+    642,1385,2304,2458,953,2003,2907,369,2379,471,1431,446,1605,3293,1275,0,
+    2810,1789,1696,1496,64,479,0,314,2100,2122,0,2202,0,1001,950,3131,
+    1602,484,2208,743,3053,2652,398,1897,3287,2792,3040,2392,1782,0,0,1105,
+    0,2798,2171,1663,3060,2884,3033,1451,477,1926,2952,1274,2089,0,766,2774,
+    1925,591,0,2010,1272,0,475,1170,1318,63,2318,2505,763,1901,361,0,
+    81,420,2603,2655,3304,485,680,1732,726,2848,53,0,0,1508,2183,2395,
+    649,2514,351,315,1076,0,2374,1505,1386,1988,1730,2491,3023,98,3179,2675,
+    2243,101,2735,1641,0,3321,470,3075,0,0,524,1575,2093,0,2967,258,
+    156,1834,2146,0,2489,2838,0,1961,340,1334,783,1109,0,2507,1516,2022,
+    0,1872,0,249,2533,0,0,3105,509,697,2494,3322,0,134,1651,714,
+    2522,0,328,1165,1418,336,2601,1684,0,3017,1833,1831,273,3004,0,2684,
+    1199,3153,2562,2794,2365,1555,0,511,406,695,1688,187,2097,3311,946,669,
+    3247,1057,1486,0,2561,1470,0,0,111,2249,184,805,2301,2847,307,872,
+    2213,2320,3344,2124,1920,3177,2865,1854,2635,2330,830,0,437,3318,3252,0,
+    2116,1983,0,2532,0,1839,1354,0,1557,1043,2131,1196,1460,974,1361,2705,
+    2618,2852,0,3015,839,48,2658,1281,0,1892,1691,321,1142,1765,1759,1873,
+    1028,0,2051,113,978,2355,1753,497,1909,0,2407,3235,2672,1521,2982,2272,
+    135,1840,1395,2203,360,196,973,2526,1189,645,0,3165,638,2488,1588,1698,
+    0,923,2149,2198,2598,0,2897,1950,1990,3174,494,2531,3284,691,2181,0,
+    0,1865,269,382,1503,356,0,2170,2405,0,0,2402,1242,1603,2325,2582,
+    1820,40,3045,1537,1108,1007,952,799,0,2934,2855,1973,893,226,0,1880,
+    1918,2340,2179,1311,3061,3006,20,211,2690,751,2054,2594,0,139,969,0,
+    55,2808,0,468,1615,771,3164,1964,1209,1606,2496,2627,1757,0,1010,453,
+    1280,2905,402,1661,0,0,2034,1217,903,3258,3046,579,1700,617,922,1835,
+};
+
+Tag DFLookupPredefinedTag(unsigned int nsId, const char *localName)
+{
+    uint32_t h = hashMix(hashString(0,localName) ^ (nsId * 0x9e3779b9U));
+    uint32_t d = TagDisplacements[h & 1023];
+    Tag tag = TagSlots[hashSlot(h,d,4096)];
+    if ((tag == 0) || (PredefinedTags[tag].namespaceID != nsId) ||
+        strcmp(PredefinedTags[tag].localName,localName))
+        return 0;
+    return tag;
+}
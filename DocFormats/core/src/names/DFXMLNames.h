@@ -3378,4 +3378,7 @@ typedef unsigned int Tag;
 extern const TagDecl PredefinedTags[PREDEFINED_TAG_COUNT];
 #endif
 
+// Returns 0 if there is no predefined tag with the given namespace and local name
+Tag DFLookupPredefinedTag(unsigned int nsId, const char *localName);
+
 #endif
@@ -19,7 +19,9 @@
 
 #define NAMESPACE_C
 #include "DFXMLNamespaces.h"
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 const NamespaceDecl PredefinedNamespaces[PREDEFINED_NAMESPACE_COUNT] = {
     { NULL, NULL },
@@ -82,3 +84,53 @@ const NamespaceDecl PredefinedNamespaces[PREDEFINED_NAMESPACE_COUNT] = {
     { "http://www.uxproductivity.com/uxwrite/conversion", "conv" },
     { "http://www.uxproductivity.com/uxwrite/LaTeX", "latex" },
 };
+
+static uint32_t hashMix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint32_t hashString(uint32_t seed, const char *str)
+{
+    uint32_t h = 2166136261U ^ seed;
+    for (const unsigned char *c = (const unsigned char *)str; *c != 0; c++)
+        h = (h ^ *c) * 16777619U;
+    return h;
+}
+
+static uint32_t hashSlot(uint32_t h, uint32_t displacement, uint32_t slotCount)
+{
+    return hashMix(h ^ (displacement * 0x9e3779b9U)) & (slotCount - 1);
+}
+
+static const uint16_t NamespaceDisplacements[16] = {
+    4,0,1,0,0,8,2,0,9,0,2,3,0,1,1,0,
+};
+
+static const uint8_t NamespaceSlots[128] = {
+    36,0,28,33,16,1,0,35,22,0,46,0,55,2,25,0,
+    17,0,0,54,0,9,51,0,0,0,0,0,0,0,0,0,
+    0,0,12,6,31,0,0,0,0,0,34,26,38,0,15,0,
+    48,0,44,8,13,0,0,24,19,0,0,41,0,43,0,49,
+    39,0,0,30,0,0,0,0,0,0,0,0,27,21,0,14,
+    52,0,0,0,0,11,0,18,0,0,0,0,10,56,0,57,
+    53,40,0,23,32,0,20,47,4,7,0,45,0,37,50,3,
+    0,0,0,0,0,42,0,0,0,58,0,0,0,0,5,29,
+};
+
+NamespaceID DFLookupPredefinedNamespace(const char *URI)
+{
+    if (URI == NULL)
+        return NAMESPACE_NULL;
+    uint32_t h = hashMix(hashString(0,URI));
+    uint32_t d = NamespaceDisplacements[h & 15];
+    NamespaceID nsId = NamespaceSlots[hashSlot(h,d,128)];
+    if ((nsId == NAMESPACE_NULL) || strcmp(PredefinedNamespaces[nsId].namespaceURI,URI))
+        return NAMESPACE_NULL;
+    return nsId;
+}
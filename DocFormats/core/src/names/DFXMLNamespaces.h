@@ -94,4 +94,7 @@ typedef unsigned int NamespaceID;
 extern const NamespaceDecl PredefinedNamespaces[PREDEFINED_NAMESPACE_COUNT];
 #endif
 
+// Returns NAMESPACE_NULL if URI is not one of the predefined namespaces
+NamespaceID DFLookupPredefinedNamespace(const char *URI);
+
 #endif
@@ -58,7 +58,7 @@ static void nodeDetailToBuffer(DFNode *node, DFBuffer *output)
             DFBufferAppendString(output,"#cdata-section");
             break;
         case DOM_PROCESSING_INSTRUCTION:
-            DFBufferAppendString(output,node->target);
+            DFBufferAppendString(output,DFNodeName(node));
             break;
         default: {
             char *elementName = fullNameForTag(node->doc,node->tag);
@@ -155,7 +155,7 @@ static void DFRecordChanges(DFNode *parent1, Tag idAttr, DFHashTable *map)
                     break;
                 }
                 case DOM_PROCESSING_INSTRUCTION: {
-                    if (strcmp(child1->target,child2->target) ||
+                    if (strcmp(DFNodeName(child1),DFNodeName(child2)) ||
                         strcmp(child1->value,child2->value)) {
                         child1->changed = 1;
                     }
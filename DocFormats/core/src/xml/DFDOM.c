@@ -27,51 +27,72 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Initial arena size for each byte of source text, when parsing a document of known size. This is
+// about what the nodes, attribute arrays and strings of typical .docx parts take up.
+#define DF_ARENA_SIZE_FACTOR 6
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                                                                                //
 //                                           DFDocument                                           //
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Since sequence numbers are allocated consecutively, nodesBySeqNo is simply indexed by them. Entries
+// for nodes that have been destroyed, or which were not renumbered by DFDocumentReassignSeqNos, are
+// left as NULL.
+
+#define SEQNO_TABLE_MIN_ALLOC 16
+
 static void DFAssignSeqNo(DFDocument *doc, DFNode *node)
 {
     node->seqNo = doc->nextSeqNo++;
     node->doc = doc;
-    if (node != doc->docNode) {
-        unsigned int hash = node->seqNo % SEQNO_HASH_SIZE;
-        assert(node->seqNoHashNext == NULL);
-        node->seqNoHashNext = doc->seqNoHashBins[hash];
-        doc->seqNoHashBins[hash] = node;
+    if (node->seqNo >= doc->nodesBySeqNoAlloc) {
+        unsigned int oldAlloc = doc->nodesBySeqNoAlloc;
+        doc->nodesBySeqNoAlloc = (oldAlloc == 0) ? SEQNO_TABLE_MIN_ALLOC : 2*oldAlloc;
+        doc->nodesBySeqNo = (DFNode **)xrealloc(doc->nodesBySeqNo,doc->nodesBySeqNoAlloc*sizeof(DFNode *));
+        bzero(&doc->nodesBySeqNo[oldAlloc],(doc->nodesBySeqNoAlloc - oldAlloc)*sizeof(DFNode *));
     }
+    if (node != doc->docNode)
+        doc->nodesBySeqNo[node->seqNo] = node;
 }
 
-static DFNode *DocumentCreateNode(DFDocument *doc, Tag tag)
+static void DFRemoveSeqNo(DFDocument *doc, DFNode *node)
 {
-    if (doc->nodesCount == doc->nodesAlloc) {
-        doc->nodesAlloc *= 2;
-        doc->nodes = (DFNode **)xrealloc(doc->nodes,doc->nodesAlloc*sizeof(DFNode *));
-    }
+    if ((node->seqNo < doc->nodesBySeqNoAlloc) && (doc->nodesBySeqNo[node->seqNo] == node))
+        doc->nodesBySeqNo[node->seqNo] = NULL;
+}
 
-//    Node *node = NodeNew(tag);
+static DFNode *DocumentCreateNode(DFDocument *doc, Tag tag)
+{
     DFNode *node = DFAllocatorAlloc(doc->allocator,sizeof(DFNode));
     bzero(node,sizeof(DFNode));
     node->tag = tag;
-    doc->nodes[doc->nodesCount++] = node;
     DFAssignSeqNo(doc,node);
     return node;
 }
 
 DFDocument *DFDocumentNew(void)
+{
+    return DFDocumentNewWithSizeHint(0);
+}
+
+DFDocument *DFDocumentNewWithSizeHint(size_t sourceSize)
+{
+    size_t arenaSize = sourceSize*DF_ARENA_SIZE_FACTOR;
+    if (arenaSize > DF_ALLOCATOR_MAX_BLOCK_SIZE)
+        arenaSize = DF_ALLOCATOR_MAX_BLOCK_SIZE;
+
+    return DFDocumentNewWithAllocator(DFAllocatorNewWithSize(arenaSize,0));
+}
+
+DFDocument *DFDocumentNewWithAllocator(DFAllocator *allocator)
 {
     DFDocument *doc = (DFDocument *)xcalloc(1,sizeof(DFDocument));
     doc->retainCount = 1;
-    doc->allocator = DFAllocatorNew();
+    doc->allocator = allocator;
     doc->map = DFNameMapNew();
-    doc->nodesByIdAttr = DFHashTableNew2(NULL,NULL,997);
-
-    doc->nodesCount = 0;
-    doc->nodesAlloc = 1;
-    doc->nodes = (DFNode **)xmalloc(doc->nodesAlloc*sizeof(DFNode *));
+    doc->nodesByIdAttr = DFHashTableNew(NULL,NULL);
     doc->docNode = DocumentCreateNode(doc,DOM_DOCUMENT);
 
     return doc;
@@ -85,19 +106,6 @@ DFDocument *DFDocumentNewWithRoot(Tag rootTag)
     return doc;
 }
 
-static void DFClearSeqNoHash(DFDocument *doc)
-{
-    for (unsigned int hash = 0; hash < SEQNO_HASH_SIZE; hash++) {
-        DFNode *node = doc->seqNoHashBins[hash];
-        while (node != NULL) {
-            DFNode *nextNode = node->seqNoHashNext;
-            node->seqNoHashNext = NULL;
-            node = nextNode;
-        }
-        doc->seqNoHashBins[hash] = NULL;
-    }
-}
-
 DFDocument *DFDocumentRetain(DFDocument *doc)
 {
     if (doc == NULL)
@@ -114,10 +122,7 @@ void DFDocumentRelease(DFDocument *doc)
     doc->retainCount--;
     if (doc->retainCount == 0) {
         DFHashTableRelease(doc->nodesByIdAttr);
-        DFClearSeqNoHash(doc);
-        for (size_t i = 0; i < doc->nodesCount; i++)
-            free(doc->nodes[i]->attrs);
-        free(doc->nodes);
+        free(doc->nodesBySeqNo);
         DFNameMapFree(doc->map);
         DFAllocatorFree(doc->allocator);
         free(doc);
@@ -126,12 +131,7 @@ void DFDocumentRelease(DFDocument *doc)
 
 DFNode *DFNodeForSeqNo(DFDocument *doc, unsigned int seqNo)
 {
-    unsigned int hash = seqNo % SEQNO_HASH_SIZE;
-    for (DFNode *node = doc->seqNoHashBins[hash]; node != NULL; node = node->seqNoHashNext) {
-        if (node->seqNo == seqNo)
-            return node;
-    }
-    return NULL;
+    return (seqNo < doc->nextSeqNo) ? doc->nodesBySeqNo[seqNo] : NULL;
 }
 
 DFNode *DFElementForIdAttr(DFDocument *doc, const char *idAttr)
@@ -148,7 +148,7 @@ void DFDocumentReassignSeqNosRecursive(DFDocument *doc, DFNode *node)
 
 void DFDocumentReassignSeqNos(DFDocument *doc)
 {
-    DFClearSeqNoHash(doc);
+    bzero(doc->nodesBySeqNo,doc->nextSeqNo*sizeof(DFNode *));
     doc->nextSeqNo = 0;
     DFDocumentReassignSeqNosRecursive(doc,doc->docNode);
 }
@@ -172,6 +172,41 @@ char *DFCopyString(DFDocument *doc, const char *str)
     return DFCopyStringLen(doc,str,strlen(str));
 }
 
+static void DFRecycleString(DFDocument *doc, char *str)
+{
+    if (str != NULL)
+        DFAllocatorRecycle(doc->allocator,str,strlen(str)+1);
+}
+
+// A processing instruction's target is kept after the NUL which terminates its value, so that nodes
+// do not need a separate field for something only this node type uses
+
+static char *DFCopyPIValue(DFDocument *doc, const char *content, const char *target)
+{
+    size_t contentLen = strlen(content);
+    size_t targetLen = strlen(target);
+    char *copy = (char *)DFAllocatorAlloc(doc->allocator,contentLen+1+targetLen+1);
+    memcpy(copy,content,contentLen+1);
+    memcpy(&copy[contentLen+1],target,targetLen+1);
+    return copy;
+}
+
+static const char *DFPITarget(const char *value)
+{
+    return value + strlen(value) + 1;
+}
+
+static void DFRecycleValue(DFDocument *doc, Tag tag, char *value)
+{
+    if ((tag == DOM_PROCESSING_INSTRUCTION) && (value != NULL)) {
+        const char *target = DFPITarget(value);
+        DFAllocatorRecycle(doc->allocator,value,(target - value) + strlen(target) + 1);
+    }
+    else {
+        DFRecycleString(doc,value);
+    }
+}
+
 // Document methods
 
 DFNode *DFCreateElement(DFDocument *doc, Tag tag)
@@ -187,6 +222,13 @@ DFNode *DFCreateTextNode(DFDocument *doc, const char *data)
     return node;
 }
 
+DFNode *DFCreateTextNodeLen(DFDocument *doc, const char *data, size_t len)
+{
+    DFNode *node = DocumentCreateNode(doc,DOM_TEXT);
+    node->value = DFCopyStringLen(doc,data,len);
+    return node;
+}
+
 DFNode *DFCreateComment(DFDocument *doc, const char *data)
 {
     DFNode *node = DocumentCreateNode(doc,DOM_COMMENT);
@@ -204,8 +246,7 @@ DFNode *DFCreateCDATASection(DFDocument *doc, char *data)
 DFNode *DFCreateProcessingInstruction(DFDocument *doc, const char *target, const char *content)
 {
     DFNode *node = DocumentCreateNode(doc,DOM_PROCESSING_INSTRUCTION);
-    node->target = DFCopyString(doc,target);
-    node->value = DFCopyString(doc,content);
+    node->value = DFCopyPIValue(doc,content,target);
     return node;
 }
 
@@ -291,9 +332,44 @@ void DFRemoveNodeButKeepChildren(DFNode *node)
     DFRemoveNode(node);
 }
 
+static void DFRecycleNode(DFDocument *doc, DFNode *node)
+{
+    DFNode *next;
+    for (DFNode *child = node->first; child != NULL; child = next) {
+        next = child->next;
+        DFRecycleNode(doc,child);
+    }
+
+    for (unsigned int i = 0; i < node->attrsCount; i++) {
+        if ((node->attrs[i].tag == HTML_ID) &&
+            (DFHashTableLookup(doc->nodesByIdAttr,node->attrs[i].value) == node))
+            DFHashTableRemove(doc->nodesByIdAttr,node->attrs[i].value);
+        DFRecycleString(doc,node->attrs[i].value);
+    }
+    DFAllocatorRecycle(doc->allocator,node->attrs,node->attrsAlloc*sizeof(DFAttribute));
+    DFRecycleValue(doc,node->tag,node->value);
+
+    if (node == doc->root)
+        doc->root = NULL;
+    DFRemoveSeqNo(doc,node);
+    DFAllocatorRecycle(doc->allocator,node,sizeof(DFNode));
+}
+
+void DFDestroyNode(DFNode *node)
+{
+    assert(node != node->doc->docNode);
+    DFRemoveNode(node);
+    DFRecycleNode(node->doc,node);
+}
+
 void DFSetNodeValue(DFNode *node, const char *value)
 {
-    node->value = DFCopyString(node->doc,value);
+    char *oldValue = node->value;
+    if (node->tag == DOM_PROCESSING_INSTRUCTION)
+        node->value = DFCopyPIValue(node->doc,value,DFPITarget(oldValue));
+    else
+        node->value = DFCopyString(node->doc,value);
+    DFRecycleValue(node->doc,node->tag,oldValue);
 }
 
 // Element methods
@@ -317,6 +393,26 @@ const char *DFGetChildAttribute(DFNode *parent, Tag childTag, Tag attrTag)
     return DFGetAttribute(child,attrTag);
 }
 
+void DFReserveAttributes(DFNode *element, unsigned int count)
+{
+    if (count <= element->attrsAlloc)
+        return;
+
+    // If nothing else has been allocated since the array, it can simply be extended
+    DFAllocator *allocator = element->doc->allocator;
+    size_t oldSize = element->attrsAlloc*sizeof(DFAttribute);
+    size_t newSize = count*sizeof(DFAttribute);
+    if (!DFAllocatorExtend(allocator,element->attrs,oldSize,newSize)) {
+        DFAttribute *newAttrs = (DFAttribute *)DFAllocatorAlloc(allocator,newSize);
+        if (element->attrs != NULL) {
+            memcpy(newAttrs,element->attrs,element->attrsCount*sizeof(DFAttribute));
+            DFAllocatorRecycle(allocator,element->attrs,oldSize);
+        }
+        element->attrs = newAttrs;
+    }
+    element->attrsAlloc = count;
+}
+
 void DFSetAttribute(DFNode *element, Tag tag, const char *value)
 {
     if (value == NULL) {
@@ -331,19 +427,20 @@ void DFSetAttribute(DFNode *element, Tag tag, const char *value)
         DFHashTableAdd(element->doc->nodesByIdAttr,value,element);
     }
 
-    // Is there an existing attribute with this tag? If so, replace it
+    // Is there an existing attribute with this tag? If so, replace it. The old value is recycled
+    // only once the new one has been copied, in case they are the same string.
     for (unsigned int i = 0; i < element->attrsCount; i++) {
         if (element->attrs[i].tag == tag) {
+            char *oldValue = element->attrs[i].value;
             element->attrs[i].value = DFCopyString(element->doc,value);
+            DFRecycleString(element->doc,oldValue);
             return;
         }
     }
 
     // No existing attribute with this tag - add it
-    if (element->attrsCount == element->attrsAlloc) {
-        element->attrsAlloc = (element->attrsAlloc == 0) ? 8 : (2*element->attrsAlloc);
-        element->attrs = (DFAttribute *)xrealloc(element->attrs,element->attrsAlloc*sizeof(DFAttribute));
-    }
+    if (element->attrsCount == element->attrsAlloc)
+        DFReserveAttributes(element,(element->attrsAlloc == 0) ? 4 : (2*element->attrsAlloc));
 
     element->attrs[element->attrsCount].tag = tag;
     element->attrs[element->attrsCount].value = DFCopyString(element->doc,value);
@@ -375,6 +472,7 @@ void DFRemoveAttribute(DFNode *element, Tag tag)
 
     for (unsigned int i = 0; i < element->attrsCount; i++) {
         if (element->attrs[i].tag == tag) {
+            DFRecycleString(element->doc,element->attrs[i].value);
             if (i+1 < element->attrsCount) {
                 // Move the last attribute into this slot
                 element->attrs[i].tag = element->attrs[element->attrsCount-1].tag;
@@ -388,6 +486,8 @@ void DFRemoveAttribute(DFNode *element, Tag tag)
 
 void DFRemoveAllAttributes(DFNode *element)
 {
+    for (unsigned int i = 0; i < element->attrsCount; i++)
+        DFRecycleString(element->doc,element->attrs[i].value);
     element->attrsCount = 0;
 }
 
@@ -460,7 +560,7 @@ const char *DFNodeName(DFNode *node)
         case DOM_CDATA:
             return "#cdata-section";
         case DOM_PROCESSING_INSTRUCTION:
-            return node->target;
+            return DFPITarget(node->value);
         default:
             return DFTagName(node->doc,node->tag);
     }
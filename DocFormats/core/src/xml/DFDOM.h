@@ -80,7 +80,12 @@
  of those memory blocks itself for the DFNode objects. When a DFDocument object is freed, those
  blocks are simply released in one go, without the need to individually inspect each node to check
  its reference count. The same memory blocks are used to allocate strings for attribute values,
- which also get freed along with the document.
+ and the arrays holding the attributes of each element, which also get freed along with the document.
+
+ Nodes which are known to be no longer needed can be given back to the document with
+ DFDestroyNode(). Their memory, along with that of their attributes and text, is then reused for new
+ nodes and strings allocated in the same document, so that repeatedly removing and recreating parts
+ of the tree does not cause the document to keep growing.
 
  THe previous paragraph describes an implementation detail which you don't need to worry about
  when using documents. Just call DFDocumentNew() or DFDocumentNewWithRoot() to create a document,
@@ -116,24 +121,26 @@ typedef struct {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /** Documentation for DFNode */
+
+// The fields are ordered so that those used when walking the tree (tag, and the parent, child and
+// sibling links) share the first cache line of the node, and so that there is no padding between
+// them on 64-bit platforms. The target of a processing instruction is stored in the same block of
+// memory as its value, immediately after the latter's terminating NUL; use DFNodeName() to get it.
 struct DFNode {
     Tag tag;
+    unsigned int seqNo;
     DFNode *parent;
     DFNode *first;
     DFNode *last;
     DFNode *next;
     DFNode *prev;
-    unsigned int seqNo;
     struct DFDocument *doc;
-    void *js;
-    int changed;
-    int childrenChanged;
-    DFNode *seqNoHashNext;
+    char *value;
     DFAttribute *attrs;
     unsigned int attrsCount;
-    unsigned int attrsAlloc;
-    char *target;
-    char *value;
+    unsigned int attrsAlloc : 30;
+    unsigned int changed : 1;
+    unsigned int childrenChanged : 1;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -142,8 +149,6 @@ struct DFNode {
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define SEQNO_HASH_SIZE 3571
-
 /**
 
  The DFDocument class represents an XML or HTML document in memory which has either been parsed from
@@ -153,11 +158,9 @@ struct DFNode {
 struct DFDocument {
     size_t retainCount;
     struct DFAllocator *allocator;
-    DFNode *seqNoHashBins[SEQNO_HASH_SIZE];
+    DFNode **nodesBySeqNo;
+    unsigned int nodesBySeqNoAlloc;
     struct DFHashTable *nodesByIdAttr;
-    DFNode **nodes;
-    size_t nodesCount;
-    size_t nodesAlloc;
 
     struct DFNameMap *map;
     DFNode *docNode;
@@ -172,6 +175,16 @@ struct DFDocument {
  *
  */
 DFDocument *DFDocumentNew(void);
+/**
+ * Create a new DFDocument, which is about to be filled in by parsing sourceSize bytes of XML or
+ * HTML. The document's memory is allocated in blocks sized accordingly; 0 means the size is unknown.
+ */
+DFDocument *DFDocumentNewWithSizeHint(size_t sourceSize);
+/**
+ * Create a new DFDocument whose memory is obtained from allocator. The document takes ownership of
+ * the allocator, and frees it when the document is released.
+ */
+DFDocument *DFDocumentNewWithAllocator(struct DFAllocator *allocator);
 /**
  * Create a new DFDocument with a root element of rootTag type
  */
@@ -242,6 +255,10 @@ DFNode *DFCreateElement(DFDocument *doc, Tag tag);
  * Will this always be true?
  */
 DFNode *DFCreateTextNode(DFDocument *doc, const char *data);
+/**
+ * As DFCreateTextNode, but taking the first len bytes of data, which need not be null-terminated
+ */
+DFNode *DFCreateTextNodeLen(DFDocument *doc, const char *data, size_t len);
 /**
  * Create a DOM comment DFNode within the document with the data supplied
  *
@@ -303,10 +320,19 @@ void DFRemoveNode(DFNode *node);
  * node is can then be reused.
  */
 void DFRemoveNodeButKeepChildren(DFNode *node);
+/**
+ * Remove the node from its parent (if any), and give the memory used by it and all of its
+ * descendants back to the document, for reuse by nodes and strings created later.
+ *
+ * Only call this when nothing refers to these nodes any more, including any attribute values or
+ * text obtained from them.
+ */
+void DFDestroyNode(DFNode *node);
 /**
  * Copy the input value to node.
  *
- * If a node already has a value is it leaked?
+ * The memory used by the previous value is reused for later strings, so any pointer to it obtained
+ * before the call becomes invalid.
  */
 void DFSetNodeValue(DFNode *node, const char *value);
 
@@ -336,6 +362,11 @@ const char *DFGetChildAttribute(DFNode *parent, Tag childTag, Tag attrTag);
  *
  */
 void DFSetAttribute(DFNode *element, Tag tag, const char *value);
+/**
+ * Make room for the element to hold at least count attributes, without needing to allocate memory
+ * again as they are added. The parser uses this to allocate an array of exactly the right size.
+ */
+void DFReserveAttributes(DFNode *element, unsigned int count);
 /**
  * Set the elements tag attrbute to the variable formatted value.
  *
@@ -25,15 +25,16 @@
 #include <stdlib.h>
 #include <string.h>
 
-static void NameMap_staticInit();
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                                                                                //
 //                                         DFNameHashTable                                        //
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define HASH_TABLE_SIZE 983
+// The bins are allocated when the first entry is added, and doubled whenever there are more entries
+// than bins. Most documents only use predefined names, and never add any.
+
+#define NAME_HASH_TABLE_MIN_BINS 16
 
 typedef struct DFNameEntry {
     char *name;
@@ -45,7 +46,9 @@ typedef struct DFNameEntry {
 } DFNameEntry;
 
 typedef struct DFNameHashTable {
-    DFNameEntry *bins[HASH_TABLE_SIZE];
+    DFNameEntry **bins;
+    uint32_t binCount;
+    uint32_t count;
 } DFNameHashTable;
 
 static uint32_t DFNameHashTableHash(const char *name, const char *URI)
@@ -63,9 +66,11 @@ static uint32_t DFNameHashTableHash(const char *name, const char *URI)
 
 static const DFNameEntry *DFNameHashTableGet(DFNameHashTable *table, const char *name, const char *URI)
 {
+    if (table->count == 0)
+        return 0;
     if (URI == NULL)
         URI = "";;
-    uint32_t hash = DFNameHashTableHash(name,URI)%HASH_TABLE_SIZE;
+    uint32_t hash = DFNameHashTableHash(name,URI) & (table->binCount - 1);
     for (DFNameEntry *entry = table->bins[hash]; entry != NULL; entry = entry->next) {
         if (!strcmp(name,entry->name) && !strcmp(URI,entry->URI))
             return entry;
@@ -73,12 +78,34 @@ static const DFNameEntry *DFNameHashTableGet(DFNameHashTable *table, const char
     return 0;
 }
 
+static void DFNameHashTableGrow(DFNameHashTable *table)
+{
+    uint32_t oldCount = table->binCount;
+    DFNameEntry **oldBins = table->bins;
+    table->binCount = (oldCount == 0) ? NAME_HASH_TABLE_MIN_BINS : 2*oldCount;
+    table->bins = (DFNameEntry **)xcalloc(table->binCount,sizeof(DFNameEntry *));
+    for (uint32_t i = 0; i < oldCount; i++) {
+        DFNameEntry *entry = oldBins[i];
+        while (entry != NULL) {
+            DFNameEntry *next = entry->next;
+            uint32_t hash = DFNameHashTableHash(entry->name,entry->URI) & (table->binCount - 1);
+            entry->next = table->bins[hash];
+            table->bins[hash] = entry;
+            entry = next;
+        }
+    }
+    free(oldBins);
+}
+
 static void DFNameHashTableAdd(DFNameHashTable *table, const char *name, const char *URI,
                                Tag tag, unsigned int namespaceID)
 {
     if (URI == NULL)
         URI = "";;
-    uint32_t hash = DFNameHashTableHash(name,URI)%HASH_TABLE_SIZE;
+    if (table->count >= table->binCount)
+        DFNameHashTableGrow(table);
+    table->count++;
+    uint32_t hash = DFNameHashTableHash(name,URI) & (table->binCount - 1);
     DFNameEntry *entry = (DFNameEntry *)xmalloc(sizeof(DFNameEntry));
     entry->name = xstrdup(name);
     entry->URI = xstrdup(URI);
@@ -96,7 +123,7 @@ static DFNameHashTable *DFNameHashTableNew()
 
 static void DFNameHashTableFree(DFNameHashTable *table)
 {
-    for (uint32_t hash = 0; hash < HASH_TABLE_SIZE; hash++) {
+    for (uint32_t hash = 0; hash < table->binCount; hash++) {
         DFNameEntry *entry = table->bins[hash];
         while (entry != NULL) {
             DFNameEntry *next = entry->next;
@@ -106,6 +133,7 @@ static void DFNameHashTableFree(DFNameHashTable *table)
             entry = next;
         }
     }
+    free(table->bins);
     free(table);
 }
 
@@ -176,9 +204,6 @@ void DFTagInfoFree(DFTagInfo *info)
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-DFHashTable *defaultNamespacesByURI = NULL;
-DFNameHashTable *defaultTagsByNameURI = NULL;
-
 static void DFNameMapAddNamespace(DFNameMap *map, NamespaceID nsId, const char *URI, const char *prefix);
 
 
@@ -196,13 +221,12 @@ struct DFNameMap {
 DFNameMap *DFNameMapNew(void)
 {
     DFNameMap *map = (DFNameMap *)xcalloc(1,sizeof(DFNameMap));
-    map->namespacesByID = DFHashTableNew2(NULL,NULL,997);
-    map->namespacesByURI = DFHashTableNew2(NULL,(DFFreeFunction)DFNamespaceInfoFree,997);
-    map->tagsByID = DFHashTableNew2(NULL,(DFFreeFunction)DFTagInfoFree,997);
+    map->namespacesByID = DFHashTableNew(NULL,NULL);
+    map->namespacesByURI = DFHashTableNew(NULL,(DFFreeFunction)DFNamespaceInfoFree);
+    map->tagsByID = DFHashTableNew(NULL,(DFFreeFunction)DFTagInfoFree);
     map->nextNamespaceId = PREDEFINED_NAMESPACE_COUNT;
     map->nextTag = PREDEFINED_TAG_COUNT;
     map->localTagsByNameURI = DFNameHashTableNew();
-    NameMap_staticInit();
     return map;
 }
 
@@ -219,17 +243,17 @@ static NamespaceID NameMap_namespaceIDForURI(DFNameMap *map, const char *URI)
 {
     if (URI == NULL)
         return NAMESPACE_NULL;;
+    NamespaceID nsId = DFLookupPredefinedNamespace(URI);
+    if (nsId != NAMESPACE_NULL)
+        return nsId;
     DFNamespaceInfo *ns = DFHashTableLookup(map->namespacesByURI,(const char *)URI);
-    if (ns == NULL) {
-        ns = DFHashTableLookup(defaultNamespacesByURI,(const char *)URI);
-    }
     assert(ns != NULL);
     return ns->nsId;
 }
 
 static void DFNameMapAddNamespace(DFNameMap *map, NamespaceID nsId, const char *URI, const char *prefix)
 {
-    assert(DFHashTableLookup(defaultNamespacesByURI,(const char *)URI) == NULL);
+    assert(DFLookupPredefinedNamespace(URI) == NAMESPACE_NULL);
     assert(DFHashTableLookup(map->namespacesByURI,(const char *)URI) == NULL);
     DFNamespaceInfo *ns = DFNamespaceInfoNew(nsId,URI,prefix);
     if (nsId >= PREDEFINED_NAMESPACE_COUNT) {
@@ -240,11 +264,10 @@ static void DFNameMapAddNamespace(DFNameMap *map, NamespaceID nsId, const char *
 
 NamespaceID DFNameMapFoundNamespace(DFNameMap *map, const char *URI, const char *prefix)
 {
-    DFNamespaceInfo *existing;
-    existing = DFHashTableLookup(defaultNamespacesByURI,(const char *)URI);
-    if (existing != NULL)
-        return existing->nsId;
-    existing = DFHashTableLookup(map->namespacesByURI,(const char *)URI);
+    NamespaceID predefined = DFLookupPredefinedNamespace(URI);
+    if (predefined != NAMESPACE_NULL)
+        return predefined;
+    DFNamespaceInfo *existing = DFHashTableLookup(map->namespacesByURI,(const char *)URI);
     if (existing != NULL)
         return existing->nsId;;
     NamespaceID nsId = map->nextNamespaceId++;
@@ -275,12 +298,29 @@ const TagDecl *DFNameMapNameForTag(DFNameMap *map, Tag tag)
     return info->decl;
 }
 
+Tag DFNameMapTagCount(DFNameMap *map)
+{
+    return map->nextTag;
+}
+
+// Predefined tags with no namespace are found by both a NULL and an empty URI
+static Tag predefinedTagForName(const char *URI, const char *localName)
+{
+    if ((URI == NULL) || (URI[0] == '\0'))
+        return DFLookupPredefinedTag(NAMESPACE_NULL,localName);
+    NamespaceID nsId = DFLookupPredefinedNamespace(URI);
+    if (nsId == NAMESPACE_NULL)
+        return 0;
+    return DFLookupPredefinedTag(nsId,localName);
+}
+
 Tag DFNameMapTagForName(DFNameMap *map, const char *URI, const char *localName)
 {
-    const DFNameEntry *entry = DFNameHashTableGet(defaultTagsByNameURI,localName,URI);
-    if (entry == NULL)
-        entry = DFNameHashTableGet(map->localTagsByNameURI,localName,URI);
+    Tag predefined = predefinedTagForName(URI,localName);
+    if (predefined != 0)
+        return predefined;
 
+    const DFNameEntry *entry = DFNameHashTableGet(map->localTagsByNameURI,localName,URI);
     if (entry != NULL)
         return entry->tag;;
 
@@ -293,37 +333,16 @@ Tag DFNameMapTagForName(DFNameMap *map, const char *URI, const char *localName)
     return tag;
 }
 
-static void NameMap_staticInit()
-{
-    if (defaultNamespacesByURI != NULL)
-        return;
-    defaultNamespacesByURI = DFHashTableNew2(NULL,NULL,997);
-    defaultTagsByNameURI = DFNameHashTableNew();
-
-    for (NamespaceID nsId = 1; nsId < PREDEFINED_NAMESPACE_COUNT; nsId++) {
-        const NamespaceDecl *decl = &PredefinedNamespaces[nsId];
-
-        const char *key = (const char *)decl->namespaceURI;
-        assert(DFHashTableLookup(defaultNamespacesByURI,key) == NULL);
-        DFNamespaceInfo *ns = DFNamespaceInfoNew(nsId,decl->namespaceURI,decl->prefix);
-        DFHashTableAdd(defaultNamespacesByURI,key,ns);
-    }
-    for (Tag tag = MIN_ELEMENT_TAG; tag < PREDEFINED_TAG_COUNT; tag++) {
-        const TagDecl *tagDecl = &PredefinedTags[tag];
-        const NamespaceDecl *nsDecl = &PredefinedNamespaces[tagDecl->namespaceID];
-        DFNameHashTableAdd(defaultTagsByNameURI,
-                          tagDecl->localName,
-                          nsDecl->namespaceURI,
-                          tag,
-                          tagDecl->namespaceID);
-    }
-}
+// The builtin map is shared by all threads. Names not already in it are added on demand, so every
+// access to it (other than for predefined tags, which never change) must hold builtinLock.
 
 static DFNameMap *builtinMap = NULL;
+static DFMutex *builtinLock = NULL;
 
 static void initBuiltinMap(void)
 {
     builtinMap = DFNameMapNew();
+    builtinLock = DFMutexNew();
 }
 
 static DFNameMap *BuiltinMapGet(void)
@@ -335,10 +354,23 @@ static DFNameMap *BuiltinMapGet(void)
 
 const TagDecl *DFBuiltinMapNameForTag(Tag tag)
 {
-    return DFNameMapNameForTag(BuiltinMapGet(),tag);
+    if (tag < PREDEFINED_TAG_COUNT)
+        return &PredefinedTags[tag];
+    DFNameMap *map = BuiltinMapGet();
+    DFMutexLock(builtinLock);
+    const TagDecl *decl = DFNameMapNameForTag(map,tag);
+    DFMutexUnlock(builtinLock);
+    return decl;
 }
 
 Tag DFBuiltinMapTagForName(const char *URI, const char *localName)
 {
-    return DFNameMapTagForName(BuiltinMapGet(),URI,localName);
+    Tag predefined = predefinedTagForName(URI,localName);
+    if (predefined != 0)
+        return predefined;
+    DFNameMap *map = BuiltinMapGet();
+    DFMutexLock(builtinLock);
+    Tag tag = DFNameMapTagForName(map,URI,localName);
+    DFMutexUnlock(builtinLock);
+    return tag;
 }
@@ -37,6 +37,7 @@ const NamespaceDecl *DFNameMapNamespaceForID(DFNameMap *map, NamespaceID nsId);
 NamespaceID DFNameMapNamespaceCount(DFNameMap *map);
 
 const TagDecl *DFNameMapNameForTag(DFNameMap *map, Tag tag);
+Tag DFNameMapTagCount(DFNameMap *map);
 Tag DFNameMapTagForName(DFNameMap *map, const char *URI, const char *localName);
 
 const TagDecl *DFBuiltinMapNameForTag(Tag tag);
@@ -23,13 +23,15 @@
 #include "DFBuffer.h"
 #include "DFString.h"
 #include "DFCommon.h"
+#include "DFTextScan.h"
 #include <assert.h>
+#include <stdint.h>
 #include <libxml/tree.h>
-#include <libxml/xmlwriter.h>
+#include <stdio.h>
 #include <string.h>
 
-const xmlChar *INDENT =
-(const xmlChar *)"\n                                                                                "\
+static const char INDENT[] =
+"\n                                                                                "\
 "                                                                                "\
 "                                                                                "\
 "                                                                                ";
@@ -60,6 +62,20 @@ static void DFSAXSetup(xmlSAXHandler *handler);
 
 typedef struct DFSAXParser DFSAXParser;
 
+// libxml2 passes element and attribute names as strings from the parser's dictionary, in which each
+// distinct string is stored exactly once, for as long as the parse lasts. So a (localName, URI)
+// pointer pair identifies a name without looking at its characters, and the tag for it only has to
+// be found in the name map the first time it occurs.
+
+typedef struct {
+    const xmlChar *localName; // NULL for an unused slot
+    const xmlChar *URI;
+    Tag tag;
+    NamespaceID nsId;
+} TagCacheEntry;
+
+#define TAG_CACHE_MIN_SLOTS 32
+
 struct DFSAXParser {
     DFDocument *document;
     DFBuffer *warnings;
@@ -67,18 +83,36 @@ struct DFSAXParser {
     DFBuffer *fatalErrors;
     DFMarkupCompatibility *compatibility;
     unsigned int ignoreDepth;
+    DFBuffer *attrValue; // reused for each attribute, to avoid a malloc per value
+    TagCacheEntry *tagCache;
+    size_t tagCacheSlots; // always a power of two
+    size_t tagCacheCount;
 
     DFNode *parent; // not explicitly retained
 };
 
-DFSAXParser *DFSAXParserNew(void)
+// libxml2 must be initialised before parsers are used from multiple threads; older versions do not
+// do this safely on their own
+
+static void initLibXML(void)
 {
+    xmlInitParser();
+}
+
+DFSAXParser *DFSAXParserNew(size_t sourceSize)
+{
+    static DFOnce once = DF_ONCE_INIT;
+    DFInitOnce(&once,initLibXML);
+
     DFSAXParser *parser = (DFSAXParser *)xcalloc(1,sizeof(DFSAXParser));
-    parser->document = DFDocumentNew();
+    parser->document = DFDocumentNewWithSizeHint(sourceSize);
     parser->parent = parser->document->docNode;
     parser->warnings = DFBufferNew();
     parser->errors = DFBufferNew();
     parser->fatalErrors = DFBufferNew();
+    parser->attrValue = DFBufferNew();
+    parser->tagCacheSlots = TAG_CACHE_MIN_SLOTS;
+    parser->tagCache = (TagCacheEntry *)xcalloc(parser->tagCacheSlots,sizeof(TagCacheEntry));
     parser->compatibility = DFMarkupCompatibilityNew();
     return parser;
 }
@@ -89,6 +123,8 @@ void DFSAXParserFree(DFSAXParser *parser)
     DFBufferRelease(parser->warnings);
     DFBufferRelease(parser->errors);
     DFBufferRelease(parser->fatalErrors);
+    DFBufferRelease(parser->attrValue);
+    free(parser->tagCache);
     DFMarkupCompatibilityFree(parser->compatibility);
     free(parser);
 }
@@ -100,6 +136,55 @@ void DFSAXParserParse(DFSAXParser *parser, const void *data, size_t len)
     xmlSAXUserParseMemory(&handler,parser,data,(int)len);
 }
 
+static size_t tagCacheSlot(DFSAXParser *parser, const xmlChar *URI, const xmlChar *localName)
+{
+    // The low bits of the pointers are often the same, so fold the well-mixed high bits into them
+    uint64_t hash = ((uint64_t)(uintptr_t)localName * 0x9E3779B97F4A7C15ULL) ^
+                    ((uint64_t)(uintptr_t)URI * 0xC2B2AE3D27D4EB4FULL);
+    hash ^= hash >> 32;
+    size_t mask = parser->tagCacheSlots - 1;
+    size_t slot = (size_t)hash & mask;
+    for (;;) {
+        TagCacheEntry *entry = &parser->tagCache[slot];
+        if ((entry->localName == NULL) || ((entry->localName == localName) && (entry->URI == URI)))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+static void tagCacheGrow(DFSAXParser *parser)
+{
+    TagCacheEntry *oldCache = parser->tagCache;
+    size_t oldSlots = parser->tagCacheSlots;
+    parser->tagCacheSlots = 2*oldSlots;
+    parser->tagCache = (TagCacheEntry *)xcalloc(parser->tagCacheSlots,sizeof(TagCacheEntry));
+    for (size_t i = 0; i < oldSlots; i++) {
+        if (oldCache[i].localName != NULL)
+            parser->tagCache[tagCacheSlot(parser,oldCache[i].URI,oldCache[i].localName)] = oldCache[i];
+    }
+    free(oldCache);
+}
+
+static Tag lookupTag(DFSAXParser *parser, const xmlChar *URI, const xmlChar *localName, NamespaceID *nsId)
+{
+    TagCacheEntry *entry = &parser->tagCache[tagCacheSlot(parser,URI,localName)];
+    if (entry->localName == NULL) {
+        Tag tag = DFNameMapTagForName(parser->document->map,(const char *)URI,(const char *)localName);
+        const TagDecl *tagDecl = DFNameMapNameForTag(parser->document->map,tag);
+        if (2*(parser->tagCacheCount + 1) > parser->tagCacheSlots) {
+            tagCacheGrow(parser);
+            entry = &parser->tagCache[tagCacheSlot(parser,URI,localName)];
+        }
+        entry->localName = localName;
+        entry->URI = URI;
+        entry->tag = tag;
+        entry->nsId = tagDecl->namespaceID;
+        parser->tagCacheCount++;
+    }
+    *nsId = entry->nsId;
+    return entry->tag;
+}
+
 static void SAXStartElementNS(void *ctx, const xmlChar *localname,
                               const xmlChar *prefix, const xmlChar *URI,
                               int nb_namespaces, const xmlChar **namespaces,
@@ -118,11 +203,11 @@ static void SAXStartElementNS(void *ctx, const xmlChar *localname,
         DFNameMapFoundNamespace(parser->document->map,(const char *)nsURI,(const char *)nsPrefix);
     }
 
-    Tag tag = DFNameMapTagForName(parser->document->map,(const char *)URI,(const char *)localname);
+    NamespaceID nsId = 0;
+    Tag tag = lookupTag(parser,URI,localname,&nsId);
 
     if (parser->compatibility != NULL) {
-        const TagDecl *tagDecl = DFNameMapNameForTag(parser->document->map,tag);
-        MCAction action = DFMarkupCompatibilityLookup(parser->compatibility,tagDecl->namespaceID,tag,1);
+        MCAction action = DFMarkupCompatibilityLookup(parser->compatibility,nsId,tag,1);
         if (action == MCActionIgnore) {
             parser->ignoreDepth++;
             return;
@@ -134,6 +219,8 @@ static void SAXStartElementNS(void *ctx, const xmlChar *localname,
     }
 
     DFNode *element = DFCreateElement(parser->document,tag);
+    if (nb_attributes > 0)
+        DFReserveAttributes(element,(unsigned int)nb_attributes);
     for (int i = 0; i < nb_attributes; i++) {
         const xmlChar *attrLocalName = attributes[i*5+0];
         const xmlChar *attrURI = attributes[i*5+2];
@@ -141,11 +228,11 @@ static void SAXStartElementNS(void *ctx, const xmlChar *localname,
         const xmlChar *attrValueEnd = attributes[i*5+4];
         unsigned long attrValueLen = (unsigned long)(attrValueEnd - attrValueStart);
 
-        Tag attrTag = DFNameMapTagForName(parser->document->map,(const char *)attrURI,(const char *)attrLocalName);
-        const TagDecl *attrTagDecl = DFNameMapNameForTag(parser->document->map,attrTag);
-        char *attrValue = (char *)xmalloc(attrValueLen+1);
-        memcpy(attrValue,attrValueStart,attrValueLen);
-        attrValue[attrValueLen] = '\0';
+        NamespaceID attrNsId = 0;
+        Tag attrTag = lookupTag(parser,attrURI,attrLocalName,&attrNsId);
+        parser->attrValue->len = 0;
+        DFBufferAppendData(parser->attrValue,(const char *)attrValueStart,attrValueLen);
+        const char *attrValue = parser->attrValue->data;
         if (parser->compatibility != NULL) {
             switch (attrTag) {
                 case MC_IGNORABLE:
@@ -154,7 +241,7 @@ static void SAXStartElementNS(void *ctx, const xmlChar *localname,
                     DFMarkupCompatibilityProcessAttr(parser->compatibility,attrTag,attrValue,parser->document->map);
                     break;
                 default: {
-                    MCAction action = DFMarkupCompatibilityLookup(parser->compatibility,attrTagDecl->namespaceID,0,0);
+                    MCAction action = DFMarkupCompatibilityLookup(parser->compatibility,attrNsId,0,0);
                     if (action != MCActionIgnore)
                         DFSetAttribute(element,attrTag,attrValue);
                     break;
@@ -164,7 +251,6 @@ static void SAXStartElementNS(void *ctx, const xmlChar *localname,
         else {
             DFSetAttribute(element,attrTag,attrValue);
         }
-        free(attrValue);
     }
 
     DFAppendChild(parser->parent,element);
@@ -200,6 +286,10 @@ static void SAXStartElement(void *ctx, const xmlChar *fullname, const xmlChar **
     Tag tag = DFNameMapTagForName(parser->document->map,namespaceDecl->namespaceURI,(const char *)fullname);
     DFNode *element = DFCreateElement(parser->document,tag);
     if (atts != NULL) {
+        unsigned int count = 0;
+        while (atts[count*2] != NULL)
+            count++;
+        DFReserveAttributes(element,count);
         for (int i = 0; atts[i] != NULL; i += 2) {
             const xmlChar *name = atts[i];
             const xmlChar *value = atts[i+1];
@@ -321,16 +411,261 @@ static void DFSAXSetup(xmlSAXHandler *handler)
 
 void htmlSAXParseDoc(xmlChar * cur, const char * encoding, xmlSAXHandlerPtr sax, void * userData);
 
+// The serializer writes straight into a buffer, producing the same output as libxml's xmlTextWriter
+// did when it was used for this purpose. A start tag is left open until the element's first piece
+// of content is written, so that elements without any content can be closed with "/>".
+
+typedef struct {
+    const char *qname; // prefix:localName, or just localName for the null namespace
+    size_t qlen;
+    size_t localOffset; // offset of localName within qname
+    NamespaceID namespaceID;
+} SerializedName;
+
 typedef struct {
-    xmlTextWriterPtr writer;
     DFDocument *doc;
     NamespaceID defaultNS;
     int html;
     int indent;
+    DFBuffer *out;
+    DFStorageStream *stream; // if non-NULL, out is flushed to this whenever it gets large
+    int startTagOpen;
+    SerializedName *names;
+    Tag namesCount;
 } Serialization;
 
+// Amount of output to collect before flushing it to a storage stream
+#define SERIALIZE_FLUSH_SIZE 65536
+
 static void writeNode(Serialization *serialization, DFNode *node, int depth);
 
+static void writeData(Serialization *serialization, const char *data, size_t len)
+{
+    DFBufferAppendData(serialization->out,data,len);
+}
+
+static void writeString(Serialization *serialization, const char *str)
+{
+    DFBufferAppendData(serialization->out,str,strlen(str));
+}
+
+static void flushOutput(Serialization *serialization)
+{
+    if ((serialization->stream == NULL) || (serialization->out->len == 0))
+        return;
+    // A failed write is reported when the stream is closed
+    DFStorageStreamWrite(serialization->stream,serialization->out->data,serialization->out->len);
+    serialization->out->len = 0;
+    serialization->out->data[0] = '\0';
+}
+
+static void closeStartTag(Serialization *serialization)
+{
+    if (serialization->startTagOpen) {
+        writeData(serialization,">",1);
+        serialization->startTagOpen = 0;
+    }
+}
+
+static void writeIndent(Serialization *serialization, int depth)
+{
+    size_t len = 1+depth;
+    if (len > sizeof(INDENT)-1)
+        len = sizeof(INDENT)-1;
+    closeStartTag(serialization);
+    writeData(serialization,INDENT,len);
+}
+
+static const SerializedName *serializedName(Serialization *serialization, Tag tag)
+{
+    if (tag >= serialization->namesCount) {
+        Tag count = DFNameMapTagCount(serialization->doc->map);
+        serialization->names = (SerializedName *)xrealloc(serialization->names,count*sizeof(SerializedName));
+        bzero(&serialization->names[serialization->namesCount],(count - serialization->namesCount)*sizeof(SerializedName));
+        serialization->namesCount = count;
+    }
+
+    SerializedName *name = &serialization->names[tag];
+    if (name->qname == NULL) {
+        const TagDecl *tagDecl = DFNameMapNameForTag(serialization->doc->map,tag);
+        assert(tagDecl != NULL);
+        const NamespaceDecl *nsDecl = DFNameMapNamespaceForID(serialization->doc->map,tagDecl->namespaceID);
+        assert(nsDecl != NULL);
+
+        if (nsDecl->prefix != NULL) {
+            name->qname = DFFormatString("%s:%s",nsDecl->prefix,tagDecl->localName);
+            name->localOffset = strlen(nsDecl->prefix) + 1;
+        }
+        else {
+            name->qname = xstrdup(tagDecl->localName);
+            name->localOffset = 0;
+        }
+        name->qlen = strlen(name->qname);
+        name->namespaceID = tagDecl->namespaceID;
+    }
+    return name;
+}
+
+// Characters which need escaping in text (1) and in attribute values (2)
+
+static const unsigned char escapeClass[256] = {
+    ['\t'] = 2, ['\n'] = 2, ['\r'] = 3, ['"'] = 3, ['&'] = 3, ['<'] = 3, ['>'] = 3,
+};
+
+static const char *escapeEntity(unsigned char c)
+{
+    switch (c) {
+        case '\t': return "&#9;";
+        case '\n': return "&#10;";
+        case '\r': return "&#13;";
+        case '"':  return "&quot;";
+        case '&':  return "&amp;";
+        case '<':  return "&lt;";
+        default:   return "&gt;";
+    }
+}
+
+// Bytes which are not part of a valid UTF-8 sequence would make the output unreadable, so they are
+// replaced with U+FFFD. Returns NULL if str is already valid, which is almost always the case.
+
+static char *repairUTF8(const char *str, size_t *len)
+{
+    size_t valid = DFScanUTF8(str,*len);
+    if (valid == *len)
+        return NULL;
+
+    char *repaired = (char *)xmalloc(3*(*len)+1);
+    size_t outlen = 0;
+    size_t pos = 0;
+    while (pos < *len) {
+        memcpy(&repaired[outlen],&str[pos],valid);
+        outlen += valid;
+        pos += valid;
+        if (pos < *len) {
+            memcpy(&repaired[outlen],"\xEF\xBF\xBD",3);
+            outlen += 3;
+            pos++;
+            valid = DFScanUTF8(&str[pos],*len - pos);
+        }
+    }
+    repaired[outlen] = '\0';
+    *len = outlen;
+    return repaired;
+}
+
+// Runs of characters that need no escaping are found with DFScanFind, and copied in one go. The
+// scan also stops at control characters other than those which are escaped, which are skipped over.
+
+static void writeEscapedText(Serialization *serialization, const char *str)
+{
+    size_t len = strlen(str);
+    char *repaired = repairUTF8(str,&len);
+    if (repaired != NULL)
+        str = repaired;
+    size_t start = 0;
+    size_t pos = 0;
+    while ((pos += DFScanFind(&str[pos],len - pos,"<>&\"",DF_SCAN_CONTROL)) < len) {
+        unsigned char c = (unsigned char)str[pos];
+        if (escapeClass[c] & 1) {
+            writeData(serialization,&str[start],pos - start);
+            writeString(serialization,escapeEntity(c));
+            start = pos + 1;
+        }
+        pos++;
+    }
+    writeData(serialization,&str[start],len - start);
+    free(repaired);
+}
+
+static void writeCharRef(Serialization *serialization, uint32_t ch)
+{
+    char ref[16];
+    snprintf(ref,16,"&#x%X;",ch);
+    writeString(serialization,ref);
+}
+
+static int isXMLChar(uint32_t ch)
+{
+    return ((ch == 0x9) || (ch == 0xA) || (ch == 0xD) ||
+            ((ch >= 0x20) && (ch <= 0xD7FF)) ||
+            ((ch >= 0xE000) && (ch <= 0xFFFD)) ||
+            ((ch >= 0x10000) && (ch <= 0x10FFFF)));
+}
+
+// Writes a non-ASCII character as a character reference, returning the number of bytes consumed.
+// The string has already been through repairUTF8, so this only sees valid sequences; those for
+// characters which XML does not allow are written byte by byte.
+
+static int writeNonASCII(Serialization *serialization, const unsigned char *cur)
+{
+    uint32_t ch = 0;
+    int len = 1;
+    if (*cur < 0xC0) {
+        len = 1;
+    }
+    else if (*cur < 0xE0) {
+        ch = ((cur[0] & 0x1F) << 6) | (cur[1] & 0x3F);
+        len = 2;
+    }
+    else if ((*cur < 0xF0) && (cur[2] != '\0')) {
+        ch = ((cur[0] & 0x0F) << 12) | ((cur[1] & 0x3F) << 6) | (cur[2] & 0x3F);
+        len = 3;
+    }
+    else if ((*cur < 0xF8) && (cur[2] != '\0') && (cur[3] != '\0')) {
+        ch = ((cur[0] & 0x07) << 18) | ((cur[1] & 0x3F) << 12) | ((cur[2] & 0x3F) << 6) | (cur[3] & 0x3F);
+        len = 4;
+    }
+    if ((len == 1) || !isXMLChar(ch)) {
+        writeCharRef(serialization,*cur);
+        return 1;
+    }
+    writeCharRef(serialization,ch);
+    return len;
+}
+
+// Documents written with an XML declaration specify their encoding as UTF-8, so non-ASCII characters
+// can be written as they are. HTML documents have no such declaration, and so these are written as
+// character references.
+
+static void writeEscapedAttribute(Serialization *serialization, const char *str)
+{
+    int flags = DF_SCAN_CONTROL | (serialization->html ? DF_SCAN_NON_ASCII : 0);
+    size_t len = strlen(str);
+    char *repaired = repairUTF8(str,&len);
+    if (repaired != NULL)
+        str = repaired;
+    size_t start = 0;
+    size_t pos = 0;
+    while ((pos += DFScanFind(&str[pos],len - pos,"<>&\"",flags)) < len) {
+        const unsigned char *cur = (const unsigned char *)&str[pos];
+        if (escapeClass[*cur] & 2) {
+            writeData(serialization,&str[start],pos - start);
+            writeString(serialization,escapeEntity(*cur));
+            start = ++pos;
+        }
+        else if ((*cur >= 0x80) && serialization->html && (cur[1] != '\0')) {
+            writeData(serialization,&str[start],pos - start);
+            pos += writeNonASCII(serialization,cur);
+            start = pos;
+        }
+        else {
+            pos++;
+        }
+    }
+    writeData(serialization,&str[start],len - start);
+    free(repaired);
+}
+
+static void writeAttribute(Serialization *serialization, const char *name, size_t len, const char *value)
+{
+    writeData(serialization," ",1);
+    writeData(serialization,name,len);
+    writeData(serialization,"=\"",2);
+    if (value != NULL)
+        writeEscapedAttribute(serialization,value);
+    writeData(serialization,"\"",1);
+}
+
 static void findUsedNamespaces(DFDocument *doc, DFNode *node, char *used, NamespaceID count)
 {
     if (node->tag < MIN_ELEMENT_TAG)
@@ -365,12 +700,14 @@ static void writeNamespaceDeclarations(Serialization *serialization, DFNode *nod
     for (NamespaceID nsId = 1; nsId < count; nsId++) { // don't write null namespace
         if (used[nsId]) {
             const NamespaceDecl *nsDecl = DFNameMapNamespaceForID(serialization->doc->map,nsId);
-            const xmlChar *prefix = (const xmlChar *)nsDecl->prefix;
-            const xmlChar *URI = (const xmlChar *)nsDecl->namespaceURI;
-            if (nsId == serialization->defaultNS)
-                xmlTextWriterWriteAttribute(serialization->writer,(const xmlChar *)"xmlns",URI);
-            else
-                xmlTextWriterWriteAttributeNS(serialization->writer,(const xmlChar *)"xmlns",prefix,NULL,URI);
+            if (nsId == serialization->defaultNS) {
+                writeAttribute(serialization,"xmlns",5,nsDecl->namespaceURI);
+            }
+            else {
+                char *name = DFFormatString("xmlns:%s",nsDecl->prefix);
+                writeAttribute(serialization,name,strlen(name),nsDecl->namespaceURI);
+                free(name);
+            }
         }
     }
     free(used);
@@ -398,41 +735,33 @@ static void writeAttributes(Serialization *serialization, DFNode *element)
 
     for (unsigned int i = 0; i < element->attrsCount; i++) {
         Tag tag = attrs[i].tag;
+        const SerializedName *name = serializedName(serialization,tag);
 
-        const TagDecl *tagDecl = DFNameMapNameForTag(serialization->doc->map,tag);
-        assert(tagDecl != NULL);
-        const NamespaceDecl *nsDecl = DFNameMapNamespaceForID(serialization->doc->map,tagDecl->namespaceID);
-        assert(nsDecl != NULL);
-
-        const xmlChar *prefix = (const xmlChar *)nsDecl->prefix;
-        const xmlChar *localName = (const xmlChar *)tagDecl->localName;
-        const xmlChar *value = (const xmlChar *)attrs[i].value;
-
-        if (serialization->html && (tagDecl->namespaceID == NAMESPACE_HTML))
-            xmlTextWriterWriteAttribute(serialization->writer,localName,value);
+        if (serialization->html && (name->namespaceID == NAMESPACE_HTML))
+            writeAttribute(serialization,name->qname + name->localOffset,name->qlen - name->localOffset,attrs[i].value);
         else
-            xmlTextWriterWriteAttributeNS(serialization->writer,prefix,localName,NULL,value);
+            writeAttribute(serialization,name->qname,name->qlen,attrs[i].value);
     }
     free(attrs);
 }
 
 static void writeElement(Serialization *serialization, DFNode *element, int depth)
 {
-    const TagDecl *tagDecl = DFNameMapNameForTag(serialization->doc->map,element->tag);
-    assert(tagDecl != NULL);
-    const NamespaceDecl *nsDecl = DFNameMapNamespaceForID(serialization->doc->map,tagDecl->namespaceID);
-    assert(nsDecl != NULL);
-
-    const xmlChar *prefix = (const xmlChar *)nsDecl->prefix;
-    const xmlChar *localName = (const xmlChar *)tagDecl->localName;
+    const SerializedName *name = serializedName(serialization,element->tag);
+    const char *qname = name->qname;
+    size_t qlen = name->qlen;
+    if (serialization->html || (name->namespaceID == serialization->defaultNS)) {
+        qname += name->localOffset;
+        qlen -= name->localOffset;
+    }
 
     if (serialization->indent && (element->parent != element->doc->docNode))
-        xmlTextWriterWriteRawLen(serialization->writer,INDENT,1+depth);
+        writeIndent(serialization,depth);
 
-    if (serialization->html || (tagDecl->namespaceID == serialization->defaultNS))
-        xmlTextWriterStartElement(serialization->writer,localName);
-    else
-        xmlTextWriterStartElementNS(serialization->writer,prefix,localName,NULL);
+    closeStartTag(serialization);
+    writeData(serialization,"<",1);
+    writeData(serialization,qname,qlen);
+    serialization->startTagOpen = 1;
 
     if ((element->parent == serialization->doc->docNode) && !serialization->html)
         writeNamespaceDeclarations(serialization,element);
@@ -462,14 +791,24 @@ static void writeElement(Serialization *serialization, DFNode *element, int dept
     if (serialization->indent && (element->first != NULL) && !allChildrenText) {
         if ((element->first != element->last) ||
             (element->first->tag != DOM_TEXT))
-        xmlTextWriterWriteRawLen(serialization->writer,INDENT,1+depth);
+        writeIndent(serialization,depth);
     }
 
-    if (serialization->html && (element->first == NULL) && HTML_requiresCloseTag(element->tag)) {
-        xmlTextWriterWriteString(serialization->writer,(xmlChar *)"");
+    if (serialization->html && (element->first == NULL) && HTML_requiresCloseTag(element->tag))
+        closeStartTag(serialization);
+
+    if (serialization->startTagOpen) {
+        writeData(serialization,"/>",2);
+        serialization->startTagOpen = 0;
+    }
+    else {
+        writeData(serialization,"</",2);
+        writeData(serialization,qname,qlen);
+        writeData(serialization,">",1);
     }
 
-    xmlTextWriterEndElement(serialization->writer);
+    if (serialization->out->len >= SERIALIZE_FLUSH_SIZE)
+        flushOutput(serialization);
 }
 
 static void writeNode(Serialization *serialization, DFNode *node, int depth)
@@ -477,42 +816,57 @@ static void writeNode(Serialization *serialization, DFNode *node, int depth)
     switch (node->tag) {
         case DOM_DOCUMENT: {
             if (!serialization->html)
-                xmlTextWriterStartDocument(serialization->writer,"1.0","UTF-8","yes");
+                writeString(serialization,"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n");
             if (serialization->html)
-                xmlTextWriterWriteDTD(serialization->writer,(xmlChar *)"html",NULL,NULL,NULL);
-//            xmlTextWriterWriteDTD(writer,
-//                                  (xmlChar *)"html",
-//                                  (xmlChar *)"-//W3C//DTD XHTML 1.0 Strict//EN",
-//                                  (xmlChar *)"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd",
-//                                  NULL);
+                writeString(serialization,"<!DOCTYPE html>");
             for (DFNode *child = node->first; child != NULL; child = child->next)
                 writeNode(serialization,child,0);
-            xmlTextWriterEndDocument(serialization->writer);
+            writeData(serialization,"\n",1);
             break;
         }
         case DOM_TEXT: {
             if (serialization->indent && ((node->prev != NULL) || (node->next != NULL)))
-                xmlTextWriterWriteRawLen(serialization->writer,INDENT,1+depth);
-            if (serialization->html && (node->parent != NULL) && (node->parent->tag == HTML_STYLE)) {
-                xmlTextWriterWriteRaw(serialization->writer,(const xmlChar *)node->value);
-            }
-            else {
-                xmlTextWriterWriteString(serialization->writer,(const xmlChar *)node->value);
-            }
+                writeIndent(serialization,depth);
+            if (node->value == NULL)
+                break;
+            closeStartTag(serialization);
+            // Text outside of the root element, and the contents of HTML style elements, are written unescaped
+            if ((node->parent == serialization->doc->docNode) ||
+                (serialization->html && (node->parent != NULL) && (node->parent->tag == HTML_STYLE)))
+                writeString(serialization,node->value);
+            else
+                writeEscapedText(serialization,node->value);
             break;
         }
         case DOM_COMMENT: {
-            xmlTextWriterWriteComment(serialization->writer,(const xmlChar *)node->value);
+            closeStartTag(serialization);
+            writeData(serialization,"<!--",4);
+            if (node->value != NULL)
+                writeString(serialization,node->value);
+            writeData(serialization,"-->",3);
             break;
         }
         case DOM_CDATA: {
-            xmlTextWriterWriteCDATA(serialization->writer,(const xmlChar *)node->value);
+            closeStartTag(serialization);
+            writeData(serialization,"<![CDATA[",9);
+            if (node->value != NULL)
+                writeString(serialization,node->value);
+            writeData(serialization,"]]>",3);
             break;
         }
         case DOM_PROCESSING_INSTRUCTION: {
-            xmlTextWriterWritePI(serialization->writer,
-                                 (const xmlChar *)node->target,
-                                 (const xmlChar *)node->value);
+            // The name xml is reserved, and PIs using it are omitted
+            const char *target = DFNodeName(node);
+            if ((target[0] == '\0') || DFStringEqualsCI(target,"xml"))
+                break;
+            closeStartTag(serialization);
+            writeData(serialization,"<?",2);
+            writeString(serialization,target);
+            if (node->value != NULL) {
+                writeData(serialization," ",1);
+                writeString(serialization,node->value);
+            }
+            writeData(serialization,"?>",2);
             break;
         }
         default: {
@@ -525,27 +879,30 @@ static void writeNode(Serialization *serialization, DFNode *node, int depth)
     }
 }
 
-DFDocument *DFParseXMLString(const char *str, DFError **error)
+static DFDocument *parserResult(DFSAXParser *parser, DFError **error)
 {
-    DFSAXParser *parser = DFSAXParserNew();
-    DFSAXParserParse(parser,str,strlen(str));
     if (parser->fatalErrors->len > 0) {
         DFErrorFormat(error,"%s",parser->fatalErrors->data);
-        DFSAXParserFree(parser);
         return NULL;
     }
     else if (parser->errors->len > 0) {
         DFErrorFormat(error,"%s",parser->errors->data);
-        DFSAXParserFree(parser);
         return NULL;
     }
     else if (parser->document->root == NULL) {
         DFErrorFormat(error,"No root element");
-        DFSAXParserFree(parser);
         return NULL;
     }
 
-    DFDocument *result = DFDocumentRetain(parser->document);
+    return DFDocumentRetain(parser->document);
+}
+
+DFDocument *DFParseXMLString(const char *str, DFError **error)
+{
+    size_t len = strlen(str);
+    DFSAXParser *parser = DFSAXParserNew(len);
+    DFSAXParserParse(parser,str,len);
+    DFDocument *result = parserResult(parser,error);
     DFSAXParserFree(parser);
     return result;
 }
@@ -560,36 +917,62 @@ DFDocument *DFParseXMLFile(const char *filename, DFError **error)
     return doc;
 }
 
-DFDocument *DFParseXMLStorage(DFStorage *storage, const char *filename, DFError **error)
-{
-    DFBuffer *content = DFBufferReadFromStorage(storage,filename,error);
-    if (content == NULL)
-        return NULL;;
-    DFDocument *doc = DFParseXMLString(content->data,error);
-    DFBufferRelease(content);
-    return doc;
-}
+typedef struct {
+    DFSAXParser *parser;
+    xmlSAXHandler handler;
+    xmlParserCtxtPtr ctxt;
+} PushParse;
 
-static int StringBufferWrite(void *context, const char *buffer, int len)
+static int PushParseChunk(void *context, const void *buf, size_t nbytes)
 {
-    DFBuffer *buf = (DFBuffer *)context;
-    DFBufferAppendData(buf,buffer,len);
-    return len;
+    PushParse *push = (PushParse *)context;
+
+    // The context is created along with the first chunk, which libxml uses to detect the encoding
+    if (push->ctxt == NULL) {
+        push->ctxt = xmlCreatePushParserCtxt(&push->handler,push->parser,buf,(int)nbytes,NULL);
+        return (push->ctxt != NULL);
+    }
+
+    xmlParseChunk(push->ctxt,buf,(int)nbytes,0);
+
+    // There's no point in decompressing the rest of the file once the parse has failed
+    return (push->parser->fatalErrors->len == 0);
 }
 
-static int StringBufferClose(void *context)
+// The file is parsed as it is read (and, for zip storage, decompressed), so that its full text
+// never needs to be held in memory
+
+DFDocument *DFParseXMLStorage(DFStorage *storage, const char *filename, DFError **error)
 {
-    return 0;
+    size_t sourceSize = 0;
+    DFStorageSize(storage,filename,&sourceSize);
+
+    PushParse push;
+    push.parser = DFSAXParserNew(sourceSize);
+    push.ctxt = NULL;
+    DFSAXSetup(&push.handler);
+
+    DFDocument *doc = NULL;
+    int readOK = DFStorageReadChunks(storage,filename,PushParseChunk,&push,error);
+
+    // A parse error takes precedence over the cancelled read it causes
+    int parseFailed = (push.parser->fatalErrors->len > 0);
+
+    if (push.ctxt == NULL)
+        push.ctxt = xmlCreatePushParserCtxt(&push.handler,push.parser,NULL,0,NULL);
+    if (push.ctxt != NULL) {
+        xmlParseChunk(push.ctxt,NULL,0,1);
+        xmlFreeParserCtxt(push.ctxt);
+    }
+
+    if (readOK || parseFailed)
+        doc = parserResult(push.parser,error);
+    DFSAXParserFree(push.parser);
+    return doc;
 }
 
-void DFSerializeXMLBuffer(DFDocument *doc, NamespaceID defaultNS, int indent, DFBuffer *buf)
+static void serializeXML(DFDocument *doc, NamespaceID defaultNS, int indent, DFBuffer *out, DFStorageStream *stream)
 {
-    xmlOutputBufferPtr output = xmlOutputBufferCreateIO(StringBufferWrite,
-                                                        StringBufferClose,
-                                                        buf,
-                                                        NULL);
-    xmlTextWriterPtr writer = xmlNewTextWriter(output);
-
     int html = 0;
     for (DFNode *child = doc->docNode->first; child != NULL; child = child->next) {
         if (child->tag == HTML_HTML)
@@ -598,13 +981,23 @@ void DFSerializeXMLBuffer(DFDocument *doc, NamespaceID defaultNS, int indent, DF
 
     Serialization serialization;
     bzero(&serialization,sizeof(serialization));
-    serialization.writer = writer;
     serialization.doc = doc;
     serialization.defaultNS = defaultNS;
     serialization.html = html;
     serialization.indent = indent;
+    serialization.out = out;
+    serialization.stream = stream;
     writeNode(&serialization,doc->docNode,0);
-    xmlFreeTextWriter(writer);
+    flushOutput(&serialization);
+
+    for (Tag tag = 0; tag < serialization.namesCount; tag++)
+        free((char *)serialization.names[tag].qname);
+    free(serialization.names);
+}
+
+void DFSerializeXMLBuffer(DFDocument *doc, NamespaceID defaultNS, int indent, DFBuffer *buf)
+{
+    serializeXML(doc,defaultNS,indent,buf,NULL);
 }
 
 char *DFSerializeXMLString(DFDocument *doc, NamespaceID defaultNS, int indent)
@@ -629,11 +1022,13 @@ int DFSerializeXMLStorage(DFDocument *doc, NamespaceID defaultNS, int indent,
                           DFStorage *storage, const char *filename,
                           DFError **error)
 {
-    char *str = DFSerializeXMLString(doc,defaultNS,indent);
-    DFBuffer *content = DFBufferNew();
-    DFBufferAppendString(content,str);
-    int r = DFBufferWriteToStorage(content,storage,filename,error);
-    DFBufferRelease(content);
-    free(str);
-    return r;
+    // The serialized XML goes to the storage in pieces as it is produced, rather than being built
+    // up in a buffer first; for zip storage, it is compressed on the way
+    DFStorageStream *stream = DFStorageStreamOpen(storage,filename,error);
+    if (stream == NULL)
+        return 0;
+    DFBuffer *buf = DFBufferNew();
+    serializeXML(doc,defaultNS,indent,buf,stream);
+    DFBufferRelease(buf);
+    return DFStorageStreamClose(stream,error);
 }
@@ -22,6 +22,7 @@
 #include "DFString.h"
 #include "DFXML.h"
 #include "DFCommon.h"
+#include "DFHashTable.h"
 #include "DFUnitTest.h"
 #include <assert.h>
 #include <stdio.h>
@@ -355,6 +356,308 @@ void BDT_testRemove(int *indices, int count, DFBuffer *output)
     DFDocumentRelease(abstractDoc);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                           Stress test                                          //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static unsigned int stressRandom(unsigned int *state, unsigned int limit)
+{
+    *state = *state*1103515245 + 12345;
+    return (*state >> 8) % limit;
+}
+
+static DFNode *stressTextNode(DFDocument *doc, const char *prefix, int number)
+{
+    char text[32];
+    snprintf(text,32,"%s%d",prefix,number);
+    return DFCreateTextNode(doc,text);
+}
+
+// A body of paragraphs, with a hidden div (standing in for things like bookmarks) before every
+// tenth one, and another at the end (like a sectPr)
+static DFDocument *createStressConcrete(int paragraphs)
+{
+    DFDocument *doc = createHTMLDoc();
+    DFNode *body = doc->docNode->last->last;
+    for (int i = 0; i < paragraphs; i++) {
+        if (i%10 == 0) {
+            DFNode *div = DFCreateElement(doc,HTML_DIV);
+            DFAppendChild(div,stressTextNode(doc,"hidden",i));
+            DFAppendChild(body,div);
+        }
+        DFNode *p = DFCreateElement(doc,HTML_P);
+        DFAppendChild(p,stressTextNode(doc,"p",i));
+        DFAppendChild(body,p);
+    }
+    DFNode *div = DFCreateElement(doc,HTML_DIV);
+    DFAppendChild(div,DFCreateTextNode(doc,"end"));
+    DFAppendChild(body,div);
+    return doc;
+}
+
+// A body of paragraphs with a random number of hidden divs (often none, sometimes several in a row)
+// before each one and at the end
+static DFDocument *createRandomConcrete(int paragraphs, unsigned int seed)
+{
+    DFDocument *doc = createHTMLDoc();
+    DFNode *body = doc->docNode->last->last;
+    int hidden = 0;
+    for (int i = 0; i <= paragraphs; i++) {
+        while (stressRandom(&seed,3) == 0) {
+            DFNode *div = DFCreateElement(doc,HTML_DIV);
+            DFAppendChild(div,stressTextNode(doc,"hidden",hidden++));
+            DFAppendChild(body,div);
+        }
+        if (i < paragraphs) {
+            DFNode *p = DFCreateElement(doc,HTML_P);
+            DFAppendChild(p,stressTextNode(doc,"p",i));
+            DFAppendChild(body,p);
+        }
+    }
+    return doc;
+}
+
+// Apply a series of random moves, removals and insertions to the children of container
+static void randomEdits(DFNode *container, int edits, unsigned int seed)
+{
+    int count = 0;
+    for (DFNode *child = container->first; child != NULL; child = child->next)
+        count++;
+
+    DFNode **items = (DFNode **)xmalloc((count+edits)*sizeof(DFNode *));
+    DFNode *moving[8];
+    count = 0;
+    for (DFNode *child = container->first; child != NULL; child = child->next)
+        items[count++] = child;
+
+    for (int i = 0; i < edits; i++) {
+        switch (stressRandom(&seed,3)) {
+            case 0: {
+                if (count == 0)
+                    break;
+                int from = stressRandom(&seed,count);
+                int len = 1 + stressRandom(&seed,8);
+                if (len > count - from)
+                    len = count - from;
+                memcpy(moving,&items[from],len*sizeof(DFNode *));
+                memmove(&items[from],&items[from+len],(count-from-len)*sizeof(DFNode *));
+                int to = stressRandom(&seed,count-len+1);
+                memmove(&items[to+len],&items[to],(count-len-to)*sizeof(DFNode *));
+                memcpy(&items[to],moving,len*sizeof(DFNode *));
+                break;
+            }
+            case 1: {
+                if (count == 0)
+                    break;
+                int index = stressRandom(&seed,count);
+                memmove(&items[index],&items[index+1],(count-index-1)*sizeof(DFNode *));
+                count--;
+                break;
+            }
+            case 2: {
+                int index = stressRandom(&seed,count+1);
+                DFNode *h1 = DFCreateElement(container->doc,HTML_H1);
+                DFAppendChild(h1,stressTextNode(container->doc,"new",i));
+                memmove(&items[index+1],&items[index],(count-index)*sizeof(DFNode *));
+                items[index] = h1;
+                count++;
+                break;
+            }
+        }
+    }
+
+    while (container->first != NULL)
+        DFRemoveNode(container->first);
+    for (int i = 0; i < count; i++)
+        DFAppendChild(container,items[i]);
+    free(items);
+}
+
+// Check that the visible concrete nodes are in the same order as the abstract ones (which all have
+// ids at this point, including the new ones), and that none of the hidden nodes were lost
+static int stressResultMatches(DFNode *abstract, DFNode *concrete, int hiddenCount)
+{
+    DFNode *abs = abstract->first;
+    for (DFNode *con = concrete->first; con != NULL; con = con->next) {
+        if (con->tag != HTML_P) {
+            hiddenCount--;
+            continue;
+        }
+        const char *idval = (abs != NULL) ? DFGetAttribute(abs,HTML_ID) : NULL;
+        if ((idval == NULL) || !DFStringHasPrefix(idval,"x") || ((unsigned int)atoi(&idval[1]) != con->seqNo))
+            return 0;
+        abs = abs->next;
+    }
+    return (abs == NULL) && (hiddenCount == 0);
+}
+
+int BDT_testStress(int paragraphs, int edits, unsigned int seed, DFBuffer *output)
+{
+    DFDocument *concreteDoc = createStressConcrete(paragraphs);
+    DFDocument *abstractDoc = getAbstractDoc(concreteDoc);
+    DFNode *abstract = abstractDoc->docNode->first->first;
+    DFNode *concrete = concreteDoc->docNode->first->first;
+    int hiddenCount = paragraphs/10 + (paragraphs%10 != 0) + 1;
+    randomEdits(abstract,edits,seed);
+
+    TestContainerLens *containerLens = TestContainerLensNew(abstractDoc,concreteDoc);
+    double start = DFCurrentTime();
+    TestContainerLensPut(containerLens,abstract,concrete);
+    double elapsed = DFCurrentTime() - start;
+    TestContainerLensFree(containerLens);
+
+    int match = stressResultMatches(abstract,concrete,hiddenCount);
+    DFBufferFormat(output,"%d paragraphs, %d edits: put took %.3fs\n",paragraphs,edits,elapsed);
+    DFBufferFormat(output,"Match? %s\n",match ? "true" : "false");
+    DFDocumentRelease(concreteDoc);
+    DFDocumentRelease(abstractDoc);
+    return match;
+}
+
+// BDTContainerPut as it was before it was made linear. Each visible node searches backwards for
+// the hidden node it used to follow, which is quadratic, but simple enough to serve as a reference.
+static void referenceContainerPut(void *ctx, DFLens *theLens, DFNode *abstract, DFNode *concrete,
+                                  DFLookupConcreteFunction lookupConcrete)
+{
+    int count = 0;
+    for (DFNode *abs = abstract->first; abs != NULL; abs = abs->next)
+        count++;
+
+    DFNode **conChildren = (DFNode **)xmalloc(count*sizeof(DFNode*));
+    count = 0;
+    for (DFNode *abs = abstract->first; abs != NULL; abs = abs->next) {
+        DFNode *con = lookupConcrete(ctx,abs);
+        if (con != NULL)
+            conChildren[count++] = con;
+    }
+
+    DFHashTable *oldPrevHidden = DFHashTableNew(NULL,NULL);
+    for (int i = count-1; i >= 0; i--) {
+        DFNode *con = conChildren[i];
+        DFNode *prevHidden = con->prev;
+        while ((prevHidden != NULL) && theLens->isVisible(ctx,prevHidden))
+            prevHidden = prevHidden->prev;
+        DFHashTableAddInt(oldPrevHidden,con->seqNo,prevHidden);
+    }
+
+    DFHashTable *remaining = DFHashTableNew(NULL,NULL);
+    for (int i = 0; i < count; i++)
+        DFHashTableAddInt(remaining,conChildren[i]->seqNo,"");
+    DFNode *next;
+    for (DFNode *con = concrete->first; con != NULL; con = next) {
+        next = con->next;
+        if (theLens->isVisible(ctx,con) && (DFHashTableLookupInt(remaining,con->seqNo) == NULL))
+            DFRemoveNode(con);
+    }
+
+    DFNode *last = NULL;
+    if (concrete->last != NULL) {
+        last = concrete->last;
+        while ((last->prev != NULL) && !theLens->isVisible(ctx,last->prev))
+            last = last->prev;
+    }
+
+    for (int i = count-1; i >= 0; i--) {
+        DFNode *newNext = (i+1 < count) ? conChildren[i+1] : last;
+        DFInsertBefore(concrete,conChildren[i],newNext);
+    }
+
+    for (DFNode *con = concrete->first; con != NULL; con = next) {
+        next = con->next;
+        if (!theLens->isVisible(ctx,con))
+            continue;
+        DFNode *prevHidden = DFHashTableLookupInt(oldPrevHidden,con->seqNo);
+        if (prevHidden == NULL)
+            continue;
+        DFNode *insertionPoint = con->next;
+        DFNode *actual = con->prev;
+        int blockedByPrev = 0;
+        int found = 0;
+        for (;;) {
+            if (!blockedByPrev)
+                insertionPoint = (actual == NULL) ? concrete->first : actual->next;
+            if ((actual != NULL) && theLens->isVisible(ctx,actual))
+                blockedByPrev = 1;
+            if (actual == prevHidden) {
+                found = 1;
+                break;
+            }
+            if (actual == NULL)
+                break;
+            actual = actual->prev;
+        }
+        if (found)
+            DFInsertBefore(concrete,con,insertionPoint);
+    }
+
+    free(conChildren);
+    DFHashTableRelease(oldPrevHidden);
+    DFHashTableRelease(remaining);
+}
+
+static char *childListing(DFNode *container)
+{
+    DFBuffer *buf = DFBufferNew();
+    for (DFNode *child = container->first; child != NULL; child = child->next) {
+        char *text = DFNodeTextToString(child);
+        DFBufferFormat(buf,"%s\n",text);
+        free(text);
+    }
+    char *result = xstrdup(buf->data);
+    DFBufferRelease(buf);
+    return result;
+}
+
+// Apply the same random edits to two copies of a body with randomly placed hidden nodes, put one
+// with BDTContainerPut and the other with the reference implementation, and check that all of the
+// children, hidden ones included, end up in the same order
+int BDT_testCompare(int paragraphs, int edits, unsigned int seed, DFBuffer *output)
+{
+    char *listings[2];
+    for (int reference = 0; reference < 2; reference++) {
+        DFDocument *concreteDoc = createRandomConcrete(paragraphs,seed);
+        DFDocument *abstractDoc = getAbstractDoc(concreteDoc);
+        DFNode *abstract = abstractDoc->docNode->first->first;
+        DFNode *concrete = concreteDoc->docNode->first->first;
+        randomEdits(abstract,edits,seed);
+
+        TestContainerLens *containerLens = TestContainerLensNew(abstractDoc,concreteDoc);
+        if (reference)
+            referenceContainerPut(containerLens->itemLens,&lensItem,abstract,concrete,(DFLookupConcreteFunction)ItemToConcrete);
+        else
+            TestContainerLensPut(containerLens,abstract,concrete);
+        TestContainerLensFree(containerLens);
+
+        listings[reference] = childListing(concrete);
+        DFDocumentRelease(concreteDoc);
+        DFDocumentRelease(abstractDoc);
+    }
+
+    int match = !strcmp(listings[0],listings[1]);
+    if (!match) {
+        DFBufferFormat(output,"%d paragraphs, %d edits, seed %u\n",paragraphs,edits,seed);
+        DFBufferFormat(output,"BDTContainerPut:\n%s\nReference:\n%s\n",listings[0],listings[1]);
+    }
+    free(listings[0]);
+    free(listings[1]);
+    return match;
+}
+
+int BDT_Stress(int argc, const char **argv)
+{
+    int paragraphs = (argc >= 1) ? atoi(argv[0]) : 100000;
+    int edits = (argc >= 2) ? atoi(argv[1]) : 1000;
+    unsigned int seed = (argc >= 3) ? (unsigned int)atoi(argv[2]) : 1;
+
+    DFBuffer *output = DFBufferNew();
+    int match = BDT_testStress(paragraphs,edits,seed,output);
+    printf("%s",output->data);
+    DFBufferRelease(output);
+    return match;
+}
+
 int BDT_Test(int argc, const char **argv)
 {
     if (argc < 3) {
@@ -407,10 +710,35 @@ static void test_remove(void)
     free(indices);
 }
 
+static void test_stress(void)
+{
+    DFBuffer *output = DFBufferNew();
+    utassert(BDT_testStress(2000,200,1,output),"Order after put does not match");
+    DFBufferRelease(output);
+}
+
+static void test_compare(void)
+{
+    DFBuffer *output = DFBufferNew();
+    unsigned int state = 1;
+    int ok = 1;
+    for (unsigned int seed = 1; ok && (seed <= 2000); seed++) {
+        int paragraphs = stressRandom(&state,40);
+        int edits = 1 + stressRandom(&state,20);
+        ok = BDT_testCompare(paragraphs,edits,seed,output);
+    }
+    if (ok)
+        ok = BDT_testCompare(2000,200,1,output);
+    utassert(ok,output->data);
+    DFBufferRelease(output);
+}
+
 TestGroup BDTTests = {
     "core.bdt", {
         { "move", DataTest, test_move },
         { "remove", DataTest, test_remove },
+        { "stress", PlainTest, test_stress },
+        { "compare", PlainTest, test_compare },
         { NULL, PlainTest, NULL }
     }
 };
@@ -21,4 +21,7 @@
 
 void BDT_testMove(int count, int from, int to, DFBuffer *output);
 void BDT_testRemove(int *indices, int count, DFBuffer *output);
+int BDT_testStress(int paragraphs, int edits, unsigned int seed, DFBuffer *output);
+int BDT_testCompare(int paragraphs, int edits, unsigned int seed, DFBuffer *output);
 int BDT_Test(int argc, const char **argv);
+int BDT_Stress(int argc, const char **argv);
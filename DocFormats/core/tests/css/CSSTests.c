@@ -20,7 +20,9 @@
 #include "DFHashTable.h"
 #include "DFBuffer.h"
 #include "CSSSheet.h"
+#include "CSSProperties.h"
 #include "DFCommon.h"
+#include "DFString.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -66,10 +68,91 @@ static void test_parse(void)
     CSSSheetRelease(styleSheet);
 }
 
+static void test_properties(void)
+{
+    // CSSPropertyIDForName relies on the names being sorted
+    int ok = 1;
+    for (int id = CSSPropertyUnknown+2; id < CSSPropertyCount; id++) {
+        if (strcmp(CSSPropertyNameForID(id-1),CSSPropertyNameForID(id)) >= 0)
+            ok = 0;
+        if (CSSPropertyIDForName(CSSPropertyNameForID(id)) != id)
+            ok = 0;
+    }
+    utassert(ok,"property names not sorted");
+    utassert(CSSPropertyIDForName("no-such-property") == CSSPropertyUnknown,"unknown property found");
+
+    // Predefined and other properties can be mixed, and accessed either way
+    CSSProperties *properties = CSSPropertiesNewWithString("font-weight: bold; -other: x; margin: 1pt");
+    utassert(CSSGetBold(properties),"font-weight not set");
+    utassert(DFStringEquals(CSSGet(properties,"-other"),"x"),"-other not set");
+    utassert(DFStringEquals(CSSGetID(properties,CSSPropertyMarginTop),"1pt"),"margin not expanded");
+    CSSPut(properties,"font-weight",CSSGet(properties,"font-weight"));
+    utassert(DFStringEquals(CSSGet(properties,"font-weight"),"bold"),"value lost when replaced by itself");
+
+    const char **names = CSSPropertiesCopyNames(properties);
+    int count = 0;
+    while (names[count] != NULL)
+        count++;
+    free(names);
+    utassert(count == 6,"wrong number of names");
+
+    char *text = CSSPropertiesCopyDescription(properties);
+    utassert(DFStringEquals(text,"-other: x; font-weight: bold; margin: 1pt"),"wrong description");
+    free(text);
+
+    CSSPutID(properties,CSSPropertyFontWeight,NULL);
+    CSSPut(properties,"-other",NULL);
+    CSSPut(properties,"margin-top",NULL);
+    CSSPut(properties,"margin-bottom",NULL);
+    CSSPut(properties,"margin-left",NULL);
+    utassert(!CSSPropertiesIsEmpty(properties),"properties empty too soon");
+    CSSPut(properties,"margin-right",NULL);
+    utassert(CSSPropertiesIsEmpty(properties),"properties not empty");
+    CSSPropertiesRelease(properties);
+}
+
+static void test_flattenedStyle(void)
+{
+    CSSSheet *sheet = CSSSheetNew();
+    CSSSheetUpdateFromCSSText(sheet,
+        "p.Parent { font-size: 12pt }\n"
+        "p.Child { -uxwrite-parent: \"p.Parent\"; color: red }\n");
+    CSSStyle *parent = CSSSheetLookupSelector(sheet,"p.Parent",0,0);
+    CSSStyle *child = CSSSheetLookupSelector(sheet,"p.Child",0,0);
+
+    CSSStyle *flattened = CSSSheetFlattenedStyle(sheet,child);
+    utassert(DFStringEquals(CSSGet(CSSStyleRule(flattened),"font-size"),"12pt"),"property not inherited");
+    CSSStyle *again = CSSSheetFlattenedStyle(sheet,child);
+    utassert(again == flattened,"flattened style not cached");
+    CSSStyleRelease(again);
+    CSSStyleRelease(flattened);
+
+    // Changing an ancestor, more than once, must be reflected in the result
+    for (int i = 0; i < 2; i++) {
+        const char *size = (i == 0) ? "14pt" : "16pt";
+        CSSPut(CSSStyleRule(parent),"font-size",size);
+        flattened = CSSSheetFlattenedStyle(sheet,child);
+        utassert(DFStringEquals(CSSGet(CSSStyleRule(flattened),"font-size"),size),"stale flattened style");
+        CSSStyleRelease(flattened);
+    }
+
+    // As must adding a parent that was previously missing
+    CSSStyleSetParent(parent,"p.Grandparent");
+    CSSStyle *grandparent = CSSSheetLookupSelector(sheet,"p.Grandparent",1,0);
+    CSSPut(CSSStyleRule(grandparent),"font-style","italic");
+    flattened = CSSSheetFlattenedStyle(sheet,child);
+    utassert(DFStringEquals(CSSGet(CSSStyleRule(flattened),"font-style"),"italic"),"new ancestor not used");
+    CSSStyleRelease(flattened);
+
+    CSSSheetRelease(sheet);
+}
+
 TestGroup CSSTests = {
     "core.css", {
         { "setHeadingNumbering", DataTest, test_setHeadingNumbering },
         { "parse", DataTest, test_parse },
+        { "properties", PlainTest, test_properties },
+        { "flattenedStyle", PlainTest, test_flattenedStyle },
         { NULL, PlainTest, NULL }
     }
 };
@@ -15,16 +15,496 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include "DFPlatform.h"
 #include "DFUnitTest.h"
+#include "DFAllocator.h"
+#include "DFAtom.h"
+#include "DFHashTable.h"
+#include "DFCommon.h"
+#include "DFFilesystem.h"
+#include "DFBuffer.h"
+#include "DFZipFile.h"
+#include "DFTextScan.h"
+#include <DocFormats/DFStorage.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 static void test_sample(void)
 {
 }
 
+static int storageContains(DFStorage *storage, const char *path, const char *expected)
+{
+    void *buf = NULL;
+    size_t nbytes = 0;
+    if (!DFStorageRead(storage,path,&buf,&nbytes,NULL))
+        return 0;
+    int r = ((nbytes == strlen(expected)) && !memcmp(buf,expected,nbytes));
+    free(buf);
+    return r;
+}
+
+static void test_DFAllocator(void)
+{
+    DFAllocator *alc = DFAllocatorNewWithSize(1024,4096);
+    DFAllocatorStats stats;
+
+    void *small = DFAllocatorAlloc(alc,100);
+    DFAllocatorAlloc(alc,3000);
+    DFAllocatorGetStats(alc,&stats);
+    utassert(stats.blockCount == 2,"large allocation not given its own block");
+    utassert(stats.usedBytes == 104 + 3000,"wrong used byte count");
+    utassert(stats.wastedBytes == 0,"space in first block wasted");
+
+    DFAllocatorRecycle(alc,small,100);
+    DFAllocatorGetStats(alc,&stats);
+    utassert(stats.recycledBytes == 104,"wrong recycled byte count");
+    utassert(DFAllocatorAlloc(alc,97) == small,"recycled memory not reused");
+
+    for (int i = 0; i < 100; i++)
+        DFAllocatorAlloc(alc,1000);
+    DFAllocatorGetStats(alc,&stats);
+    utassert(stats.totalBytes <= 1024 + 3000 + 100*4096,"block size not capped");
+    utassert(stats.recycledBytes == 0,"wrong recycled byte count");
+    utassert(stats.usedBytes == 104 + 3000 + 100*1000,"wrong used byte count");
+
+    // Only the most recent allocation can be extended, and only within its block
+    char *last = (char *)DFAllocatorAlloc(alc,16);
+    utassert(DFAllocatorExtend(alc,last,16,64),"last allocation not extended");
+    char *after = (char *)DFAllocatorAlloc(alc,8);
+    utassert(after == last + 64,"allocation overlaps extended memory");
+    utassert(!DFAllocatorExtend(alc,last,64,128),"earlier allocation extended");
+    utassert(!DFAllocatorExtend(alc,after,8,4096),"allocation extended past end of block");
+
+    DFAllocatorFree(alc);
+}
+
+static void test_DFHashTable(void)
+{
+    DFHashTable *table = DFHashTableNew((DFCopyFunction)xstrdup,free);
+    char key[40];
+    char value[40];
+
+    // Enough entries to make the table grow several times, with every other one removed
+    for (int i = 0; i < 10000; i++) {
+        snprintf(key,40,"key%d",i);
+        snprintf(value,40,"value%d",i);
+        DFHashTableAdd(table,key,value);
+    }
+    for (int i = 0; i < 10000; i += 2) {
+        snprintf(key,40,"key%d",i);
+        DFHashTableRemove(table,key);
+    }
+    utassert(DFHashTableCount(table) == 5000,"wrong count after removal");
+
+    int ok = 1;
+    for (int i = 0; i < 10000; i++) {
+        snprintf(key,40,"key%d",i);
+        snprintf(value,40,"value%d",i);
+        const char *found = DFHashTableLookup(table,key);
+        if ((i % 2 == 0) ? (found != NULL) : ((found == NULL) || strcmp(found,value)))
+            ok = 0;
+    }
+    utassert(ok,"incorrect lookup result");
+
+    const char **keys = DFHashTableCopyKeys(table);
+    int keyCount = 0;
+    while (keys[keyCount] != NULL)
+        keyCount++;
+    free(keys);
+    utassert(keyCount == 5000,"wrong number of keys copied");
+    DFHashTableRelease(table);
+
+    // Integer keys
+    table = DFHashTableNew(NULL,NULL);
+    for (int i = -1000; i < 1000; i++)
+        DFHashTableAddInt(table,i,(void *)(intptr_t)(i + 2000));
+    DFHashTableRemoveInt(table,0);
+    ok = (DFHashTableLookupInt(table,0) == NULL);
+    for (int i = 1; i < 1000; i++) {
+        if ((DFHashTableLookupInt(table,i) != (void *)(intptr_t)(i + 2000)) ||
+            (DFHashTableLookupInt(table,-i) != (void *)(intptr_t)(2000 - i)))
+            ok = 0;
+    }
+    utassert(ok,"incorrect integer key lookup result");
+    utassert(DFHashTableCount(table) == 1999,"wrong count for integer keys");
+    utassert(DFHashTableLookup(table,"5") == NULL,"integer key found as string");
+
+    DFHashTableAddInt(table,1,NULL);
+    DFHashTable *copy = DFHashTableCopy(table);
+    utassert(DFHashTableCount(copy) == 1999,"wrong count for copy");
+    utassert(DFHashTableLookupInt(copy,-5) == (void *)(intptr_t)1995,"integer key not copied");
+    DFHashTableRelease(copy);
+    DFHashTableRelease(table);
+}
+
+#define ATOM_TEST_COUNT 2000
+
+typedef struct {
+    const char *atoms[4][ATOM_TEST_COUNT];
+} AtomTestResults;
+
+static void internAtoms(void *ctx, int index)
+{
+    AtomTestResults *results = (AtomTestResults *)ctx;
+    char str[40];
+    for (int i = 0; i < ATOM_TEST_COUNT; i++) {
+        snprintf(str,40,"atom-test-%d",i);
+        results->atoms[index][i] = DFAtomGet(str);
+    }
+}
+
+// Repeatedly takes and drops references to the same atom, which nothing else holds, so that its
+// count keeps going to zero while other threads are retaining it
+static void churnAtom(void *ctx, int index)
+{
+    int *failures = (int *)ctx;
+    for (int i = 0; i < 20000; i++) {
+        const char *atom = DFAtomGet("atom-test-churn");
+        DFAtomRetain(atom);
+        if (strcmp(atom,"atom-test-churn"))
+            failures[index]++;
+        DFAtomRelease(atom);
+        DFAtomRelease(atom);
+    }
+}
+
+static void test_DFAtom(void)
+{
+    const char *atom = DFAtomGet("atom-test");
+    char *copy = xstrdup("atom-test");
+    const char *other = DFAtomGet(copy);
+    utassert(other == atom,"same string gave a different atom");
+    DFAtomRelease(other);
+    other = DFAtomFind(copy);
+    utassert(other == atom,"atom not found");
+    DFAtomRelease(other);
+    other = DFAtomGetLen("atom-test-extra",9);
+    utassert(other == atom,"prefix gave a different atom");
+    DFAtomRelease(other);
+    utassert(!strcmp(atom,"atom-test"),"wrong atom string");
+    free(copy);
+    utassert(DFAtomFind("atom-test-never-added") == NULL,"atom found before being added");
+
+    // Threads adding the same strings at the same time must all get the same atoms, including while
+    // the table is growing
+    AtomTestResults *results = (AtomTestResults *)xcalloc(1,sizeof(AtomTestResults));
+    DFRunParallel(4,4,internAtoms,results);
+    int ok = 1;
+    for (int t = 1; t < 4; t++) {
+        for (int i = 0; i < ATOM_TEST_COUNT; i++) {
+            if (results->atoms[t][i] != results->atoms[0][i])
+                ok = 0;
+        }
+    }
+    utassert(ok,"threads got different atoms");
+
+    // Once the last reference is released, the string is removed from the table, and the others
+    // (which may have been moved to fill the gap) are still found
+    for (int t = 0; t < 4; t++) {
+        for (int i = 0; i < ATOM_TEST_COUNT; i += (t < 3) ? 1 : 2)
+            DFAtomRelease(results->atoms[t][i]);
+    }
+    char str[40];
+    for (int i = 0; i < ATOM_TEST_COUNT; i++) {
+        snprintf(str,40,"atom-test-%d",i);
+        const char *found = DFAtomFind(str);
+        if ((i % 2 == 0) ? (found != NULL) : (found != results->atoms[0][i]))
+            ok = 0;
+        DFAtomRelease(found);
+    }
+    utassert(ok,"released atoms not removed");
+    for (int i = 1; i < ATOM_TEST_COUNT; i += 2)
+        DFAtomRelease(results->atoms[3][i]);
+    free(results);
+
+    int failures[4] = { 0, 0, 0, 0 };
+    DFRunParallel(4,4,churnAtom,failures);
+    utassert(failures[0] + failures[1] + failures[2] + failures[3] == 0,"wrong string for atom");
+    utassert(DFAtomFind("atom-test-churn") == NULL,"atom not released after concurrent use");
+
+    // Tables with atom keys can be accessed with either atoms or ordinary strings, and keep their
+    // keys in the atom table for as long as they contain them
+    DFHashTable *table = DFHashTableNewWithAtomKeys((DFCopyFunction)xstrdup,free);
+    DFHashTableAdd(table,"atom-test","value");
+    DFHashTableAdd(table,"atom-test-key","value");
+    utassert(!strcmp(DFHashTableLookupAtom(table,atom),"value"),"value not found by atom");
+    utassert(DFHashTableLookup(table,"atom-test-never-added") == NULL,"missing key found");
+    DFHashTable *tableCopy = DFHashTableCopy(table);
+    DFHashTableRemoveAtom(table,atom);
+    utassert(DFHashTableLookup(table,"atom-test") == NULL,"value not removed");
+    utassert(!strcmp(DFHashTableLookup(tableCopy,"atom-test"),"value"),"value not copied");
+    DFHashTableRemove(table,"atom-test-key");
+    other = DFAtomFind("atom-test-key");
+    utassert(other != NULL,"key released while still in a copy of the table");
+    DFAtomRelease(other);
+    DFHashTableRelease(tableCopy);
+    utassert(DFAtomFind("atom-test-key") == NULL,"key not released with the table");
+
+    // Adding an atom retains it, rather than the table getting its own reference from the atom table
+    other = DFAtomGet("atom-test-added");
+    DFHashTableAddAtom(table,other,"value");
+    DFAtomRelease(other);
+    utassert(!strcmp(DFHashTableLookup(table,"atom-test-added"),"value"),"value not found after adding atom");
+    DFHashTableRemove(table,"atom-test-added");
+    utassert(DFAtomFind("atom-test-added") == NULL,"added atom not released");
+    DFHashTableRelease(table);
+    DFAtomRelease(atom);
+    utassert(DFAtomFind("atom-test") == NULL,"atom not released");
+}
+
+// Compares the checksum of a file with that computed from the expected contents in memory storage
+static int storageChecksumMatches(DFStorage *storage, const char *path, const char *expected)
+{
+    DFStorage *mem = DFStorageNewMemory(DFFileFormatUnknown);
+    DFStorageWrite(mem,path,(void *)expected,strlen(expected),NULL);
+    uint32_t crc = 0;
+    uint32_t expectedCrc = 0;
+    size_t nbytes = 0;
+    size_t expectedBytes = 0;
+    int r = (DFStorageChecksum(storage,path,&crc,&nbytes,NULL) &&
+             DFStorageChecksum(mem,path,&expectedCrc,&expectedBytes,NULL) &&
+             (crc == expectedCrc) && (nbytes == expectedBytes) && (expectedCrc != 0));
+    DFStorageRelease(mem);
+    return r;
+}
+
+static void test_DFStorageZip(void)
+{
+    const char *filename = "dftest-storage.zip";
+    DFDeleteFile(filename,NULL);
+
+    DFStorage *storage = DFStorageCreateZip(filename,NULL);
+    utassert(storage != NULL,"cannot create zip storage");
+    DFStorageWrite(storage,"one.xml","<one/>",6,NULL);
+    DFStorageWrite(storage,"dir/two.xml","<two/>",6,NULL);
+    utassert(DFStorageSave(storage,NULL),"cannot save new zip storage");
+    DFStorageRelease(storage);
+
+    // Entries are read on demand from the archive, and writes take precedence over them
+    storage = DFStorageOpenZip(filename,NULL);
+    utassert(storage != NULL,"cannot open zip storage");
+    DFStorageSetCacheLimit(storage,0);
+    utassert(storageContains(storage,"one.xml","<one/>"),"one.xml not read from archive");
+    utassert(DFStorageExists(storage,"dir/two.xml"),"dir/two.xml missing");
+    DFStorageWrite(storage,"one.xml","<changed/>",10,NULL);
+    DFStorageWrite(storage,"three.xml","<three/>",8,NULL);
+    utassert(storageContains(storage,"one.xml","<changed/>"),"one.xml not updated");
+    utassert(storageChecksumMatches(storage,"one.xml","<changed/>"),"wrong checksum for written entry");
+    utassert(storageChecksumMatches(storage,"dir/two.xml","<two/>"),"wrong checksum for archive entry");
+    utassert(DFStorageSave(storage,NULL),"cannot save modified zip storage");
+    utassert(storageContains(storage,"three.xml","<three/>"),"three.xml not read after save");
+    DFStorageRelease(storage);
+
+    storage = DFStorageOpenZip(filename,NULL);
+    utassert(storage != NULL,"cannot reopen zip storage");
+    DFStorageDelete(storage,"dir/two.xml",NULL);
+    utassert(!DFStorageExists(storage,"dir/two.xml"),"dir/two.xml not deleted");
+    utassert(storageContains(storage,"one.xml","<changed/>"),"one.xml not saved");
+    utassert(storageContains(storage,"three.xml","<three/>"),"three.xml not saved");
+    DFStorageRelease(storage);
+
+    // If the archive can't be replaced (here because a directory is in the way), saving fails
+    // and leaves no temporary file behind
+    DFDeleteFile(filename,NULL);
+    storage = DFStorageCreateZip(filename,NULL);
+    DFStorageWrite(storage,"one.xml","<one/>",6,NULL);
+    DFCreateDirectory("dftest-storage.zip/dir",1,NULL);
+    utassert(!DFStorageSave(storage,NULL),"saved over a directory");
+    utassert(!DFFileExists("dftest-storage.zip.tmp"),"temporary file left behind");
+    utassert(storageContains(storage,"one.xml","<one/>"),"written entry lost after failed save");
+    DFStorageRelease(storage);
+
+    DFDeleteFile(filename,NULL);
+}
+
+typedef struct {
+    const char *expected;
+    size_t len;
+    size_t pos;
+    int chunks;
+} ChunkCheck;
+
+static int checkChunk(void *ctx, const void *buf, size_t nbytes)
+{
+    ChunkCheck *check = (ChunkCheck *)ctx;
+    if ((check->pos + nbytes > check->len) || memcmp(&check->expected[check->pos],buf,nbytes))
+        return 0;
+    check->pos += nbytes;
+    check->chunks++;
+    return 1;
+}
+
+static int storageContainsChunked(DFStorage *storage, const char *path, const char *expected, size_t len)
+{
+    ChunkCheck check = { expected, len, 0, 0 };
+    return DFStorageReadChunks(storage,path,checkChunk,&check,NULL) && (check.pos == len) && (check.chunks > 1);
+}
+
+static void test_DFStorageReadChunks(void)
+{
+    const char *filename = "dftest-chunks.zip";
+    DFDeleteFile(filename,NULL);
+
+    // Enough data to need several chunks, but not so repetitive that it compresses to nothing
+    size_t len = 1000000;
+    char *data = (char *)xmalloc(len);
+    unsigned int seed = 1;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed*1103515245 + 12345;
+        data[i] = 'a' + (seed >> 16) % 8;
+    }
+
+    DFStorage *storage = DFStorageCreateZip(filename,NULL);
+    utassert(storage != NULL,"cannot create zip storage");
+    DFStorageWrite(storage,"data.txt",data,len,NULL);
+    utassert(storageContainsChunked(storage,"data.txt",data,len),"written entry not read in chunks");
+    utassert(DFStorageSave(storage,NULL),"cannot save zip storage");
+    DFStorageRelease(storage);
+
+    storage = DFStorageOpenZip(filename,NULL);
+    utassert(storage != NULL,"cannot open zip storage");
+    utassert(storageContainsChunked(storage,"data.txt",data,len),"archive entry not read in chunks");
+    utassert(!DFStorageReadChunks(storage,"missing.txt",checkChunk,NULL,NULL),"missing entry read");
+    DFStorageRelease(storage);
+
+    free(data);
+    DFDeleteFile(filename,NULL);
+}
+
+static void fillStorage(DFStorage *storage)
+{
+    // Entries of various sizes, compressible but not trivially so
+    unsigned int seed = 1;
+    for (int entry = 0; entry < 20; entry++) {
+        size_t len = 1000*entry*entry;
+        char *data = (char *)xmalloc(len+1);
+        for (size_t i = 0; i < len; i++) {
+            seed = seed*1103515245 + 12345;
+            data[i] = 'a' + (seed >> 16) % 8;
+        }
+        char path[32];
+        snprintf(path,32,"entry%d.txt",entry);
+        DFStorageWrite(storage,path,data,len,NULL);
+        free(data);
+    }
+}
+
+static int filesEqual(const char *filename1, const char *filename2)
+{
+    DFBuffer *buffer1 = DFBufferReadFromFile(filename1,NULL);
+    DFBuffer *buffer2 = DFBufferReadFromFile(filename2,NULL);
+    int equal = ((buffer1 != NULL) && (buffer2 != NULL) && (buffer1->len == buffer2->len) &&
+                 !memcmp(buffer1->data,buffer2->data,buffer1->len));
+    DFBufferRelease(buffer1);
+    DFBufferRelease(buffer2);
+    return equal;
+}
+
+// Zip files must come out the same no matter how many threads compress their entries
+
+static void test_DFZipThreads(void)
+{
+    const char *filenames[2] = { "dftest-threads1.zip", "dftest-threads4.zip" };
+    int threads[2] = { 1, 4 };
+
+    DFStorage *mem = DFStorageNewMemory(DFFileFormatUnknown);
+    fillStorage(mem);
+    for (int i = 0; i < 2; i++) {
+        DFDeleteFile(filenames[i],NULL);
+        utassert(DFZipParallel(filenames[i],mem,threads[i],NULL),"DFZipParallel failed");
+    }
+    DFStorageRelease(mem);
+    utassert(filesEqual(filenames[0],filenames[1]),"DFZipParallel output depends on thread count");
+
+    for (int i = 0; i < 2; i++) {
+        DFDeleteFile(filenames[i],NULL);
+        DFStorage *storage = DFStorageCreateZip(filenames[i],NULL);
+        DFStorageSetThreads(storage,threads[i]);
+        fillStorage(storage);
+        utassert(DFStorageSave(storage,NULL),"cannot save zip storage");
+        DFStorageRelease(storage);
+    }
+    utassert(filesEqual(filenames[0],filenames[1]),"Zip storage output depends on thread count");
+
+    for (int i = 0; i < 2; i++)
+        DFDeleteFile(filenames[i],NULL);
+}
+
+// Every implementation of the scanning functions is checked against the scalar one, with data
+// covering each class of byte, at every alignment and length up to a few vector widths
+
+static void test_DFTextScan(void)
+{
+    static const char *samples[] = {
+        "plain ascii text",
+        "  \t\n\r\v\fwhitespace \t  ",
+        "<a href=\"x\">&amp;</a>\x01\x1f",
+        "quote \" and \\ backslash",
+        "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80",
+        "bad \xc0\xaf \xed\xa0\x80 \xf4\x90\x80\x80 \xe2\x82",
+    };
+    size_t nsamples = sizeof(samples)/sizeof(samples[0]);
+
+    char data[160];
+    unsigned int seed = 1;
+    for (int round = 0; round < 200; round++) {
+        size_t len = 0;
+        while (1) {
+            seed = seed*1103515245 + 12345;
+            const char *sample = samples[(seed >> 16) % nsamples];
+            size_t count = strlen(sample);
+            if (len + count > sizeof(data))
+                break;
+            memcpy(&data[len],sample,count);
+            len += count;
+        }
+
+        for (size_t start = 0; start < 40; start++) {
+            const char *str = &data[start];
+            size_t n = len - start - (seed >> 20) % 8;
+            DFScanSetLevel(DFScanLevelScalar);
+            size_t find1 = DFScanFind(str,n,"<>&\"",DF_SCAN_CONTROL);
+            size_t find2 = DFScanFind(str,n,"\\",DF_SCAN_CONTROL | DF_SCAN_NON_ASCII);
+            size_t white = DFScanWhitespace(str,n);
+            size_t nonWhite = DFScanNonWhitespace(str,n);
+            size_t utf8 = DFScanUTF8(str,n);
+
+            for (DFScanLevel level = DFScanLevelSSE2; level <= DFScanLevelAVX2; level++) {
+                if (!DFScanSetLevel(level))
+                    continue;
+                utassert(DFScanFind(str,n,"<>&\"",DF_SCAN_CONTROL) == find1,"DFScanFind (escape)");
+                utassert(DFScanFind(str,n,"\\",DF_SCAN_CONTROL | DF_SCAN_NON_ASCII) == find2,"DFScanFind (quote)");
+                utassert(DFScanWhitespace(str,n) == white,"DFScanWhitespace");
+                utassert(DFScanNonWhitespace(str,n) == nonWhite,"DFScanNonWhitespace");
+                utassert(DFScanUTF8(str,n) == utf8,"DFScanUTF8");
+            }
+        }
+    }
+
+    DFScanSetLevel(DFScanLevelScalar);
+    utassert(DFScanUTF8("caf\xc3\xa9",5) == 5,"valid UTF-8 rejected");
+    utassert(DFScanUTF8("ab\xc0\xaf",4) == 2,"overlong UTF-8 accepted");
+    utassert(DFScanUTF8("ab\xed\xa0\x80",5) == 2,"surrogate accepted");
+    utassert(DFScanUTF8("ab\xe2\x82",4) == 2,"truncated UTF-8 accepted");
+
+    // Restore the best implementation available
+    if (!DFScanSetLevel(DFScanLevelAVX2) && !DFScanSetLevel(DFScanLevelSSE2))
+        DFScanSetLevel(DFScanLevelScalar);
+}
+
 TestGroup LibTests = {
     "core.lib", {
         { "sample", PlainTest, test_sample },
+        { "DFAllocator", PlainTest, test_DFAllocator },
+        { "DFHashTable", PlainTest, test_DFHashTable },
+        { "DFAtom", PlainTest, test_DFAtom },
+        { "DFStorageZip", PlainTest, test_DFStorageZip },
+        { "DFStorageReadChunks", PlainTest, test_DFStorageReadChunks },
+        { "DFZipThreads", PlainTest, test_DFZipThreads },
+        { "DFTextScan", PlainTest, test_DFTextScan },
         { NULL, PlainTest, NULL }
     }
 };
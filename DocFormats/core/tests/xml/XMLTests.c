@@ -15,16 +15,302 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include "DFPlatform.h"
 #include "DFUnitTest.h"
+#include "XMLTests.h"
+#include "DFDOM.h"
+#include "DFXML.h"
+#include "DFBuffer.h"
+#include "DFString.h"
+#include "DFNameMap.h"
+#include "DFCommon.h"
+#include <stdio.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 static void test_sample(void)
 {
 }
 
+static void test_DFDestroyNode(void)
+{
+    DFDocument *doc = DFDocumentNewWithRoot(HTML_BODY);
+    DFNode *p = DFCreateChildElement(doc->root,HTML_P);
+    DFSetAttribute(p,HTML_ID,"para");
+    DFSetAttribute(p,HTML_CLASS,"Normal");
+    DFNode *text = DFCreateChildTextNode(p,"Hello");
+    unsigned int pSeqNo = p->seqNo;
+    unsigned int textSeqNo = text->seqNo;
+
+    DFDestroyNode(p);
+    utassert(doc->root->first == NULL,"destroyed node still in tree");
+    utassert(DFElementForIdAttr(doc,"para") == NULL,"destroyed node still found by id");
+    utassert(DFNodeForSeqNo(doc,pSeqNo) == NULL,"destroyed node still found by seqNo");
+    utassert(DFNodeForSeqNo(doc,textSeqNo) == NULL,"destroyed child still found by seqNo");
+
+    // Replacing the destroyed nodes should reuse their memory
+    DFNode *newText = DFCreateTextNode(doc,"World");
+    DFNode *newP = DFCreateChildElement(doc->root,HTML_P);
+    utassert((newP == text) || (newP == p),"node memory not reused");
+    utassert((newText == text) || (newText == p),"node memory not reused");
+    DFAppendChild(newP,newText);
+    DFSetAttribute(newP,HTML_ID,"para2");
+    for (int i = 0; i < 20; i++)
+        DFFormatAttribute(newP,HTML_CLASS,"class%d",i);
+    DFSetNodeValue(newText,"Replaced");
+
+    utassert(DFElementForIdAttr(doc,"para2") == newP,"new node not found by id");
+    utassert(DFNodeForSeqNo(doc,newP->seqNo) == newP,"new node not found by seqNo");
+    utexpect(DFGetAttribute(newP,HTML_CLASS),"class19");
+    utexpect(newText->value,"Replaced");
+
+    DFDocumentRelease(doc);
+}
+
+static void test_DFNodeForSeqNo(void)
+{
+    DFDocument *doc = DFDocumentNewWithRoot(HTML_BODY);
+    DFNode *detached = DFCreateElement(doc,HTML_DIV);
+    DFNode *nodes[200];
+    for (int i = 0; i < 200; i++)
+        nodes[i] = DFCreateChildElement(doc->root,HTML_P);
+
+    int ok = 1;
+    for (int i = 0; i < 200; i++) {
+        if (DFNodeForSeqNo(doc,nodes[i]->seqNo) != nodes[i])
+            ok = 0;
+    }
+    utassert(ok,"node not found by seqNo");
+    utassert(DFNodeForSeqNo(doc,doc->nextSeqNo) == NULL,"unassigned seqNo found");
+
+    // Only nodes in the tree are renumbered; the rest can no longer be found
+    unsigned int detachedSeqNo = detached->seqNo;
+    DFDocumentReassignSeqNos(doc);
+    for (int i = 0; i < 200; i++) {
+        if (DFNodeForSeqNo(doc,nodes[i]->seqNo) != nodes[i])
+            ok = 0;
+    }
+    utassert(ok,"node not found by seqNo after renumbering");
+    utassert(DFNodeForSeqNo(doc,detachedSeqNo) != detached,"detached node found after renumbering");
+    utassert(DFNodeForSeqNo(doc,doc->nextSeqNo) == NULL,"stale seqNo found after renumbering");
+
+    DFDocumentRelease(doc);
+}
+
+static void test_processingInstruction(void)
+{
+    DFDocument *doc = DFDocumentNewWithRoot(HTML_BODY);
+    DFNode *pi = DFCreateProcessingInstruction(doc,"target","some content");
+    DFAppendChild(doc->root,pi);
+    utassert(!strcmp(DFNodeName(pi),"target"),"wrong target");
+    utassert(!strcmp(pi->value,"some content"),"wrong content");
+
+    // Changing the content must keep the target
+    DFSetNodeValue(pi,"x");
+    utassert(!strcmp(DFNodeName(pi),"target"),"target lost after changing content");
+    utassert(!strcmp(pi->value,"x"),"content not changed");
+
+    char *str = DFSerializeXMLString(doc,NAMESPACE_NULL,0);
+    utassert(strstr(str,"<?target x?>") != NULL,"instruction not serialized");
+    free(str);
+
+    DFDestroyNode(pi);
+    DFDocumentRelease(doc);
+}
+
+// Invalid UTF-8 in text and attribute values comes out as U+FFFD, so the output can be parsed again
+static void test_serializeInvalidUTF8(void)
+{
+    DFDocument *doc = DFDocumentNewWithRoot(HTML_BODY);
+    DFNode *p = DFCreateChildElement(doc->root,HTML_P);
+    DFSetAttribute(p,HTML_TITLE,"a\xC3" "b");
+    DFAppendChild(p,DFCreateTextNode(doc,"caf\xC3\xA9 \xFF<\xE2\x82"));
+
+    char *str = DFSerializeXMLString(doc,NAMESPACE_NULL,0);
+    utassert(strstr(str,"title=\"a\xEF\xBF\xBD" "b\"") != NULL,"attribute not repaired");
+    utassert(strstr(str,">caf\xC3\xA9 \xEF\xBF\xBD&lt;\xEF\xBF\xBD\xEF\xBF\xBD</") != NULL,"text not repaired");
+    free(str);
+    DFDocumentRelease(doc);
+}
+
+// Enough distinct names for the parser's tag cache to grow several times, with each one used twice
+static void test_parseManyNames(void)
+{
+    DFBuffer *xml = DFBufferNew();
+    DFBufferFormat(xml,"<t:root xmlns:t=\"urn:test\" xmlns:x=\"urn:other\">");
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 1000; i++)
+            DFBufferFormat(xml,"<t:e%d a%d=\"%d\" x:a%d=\"x%d\"/>",i,i,i,i,i);
+    }
+    DFBufferFormat(xml,"</t:root>");
+
+    DFDocument *doc = DFParseXMLString(xml->data,NULL);
+    DFBufferRelease(xml);
+    utassert(doc != NULL,"parse failed");
+
+    int ok = 1;
+    int count = 0;
+    for (DFNode *child = doc->root->first; child != NULL; child = child->next) {
+        int i = count++ % 1000;
+        char name[20];
+        char value[20];
+        snprintf(name,20,"e%d",i);
+        if (child->tag != DFNameMapTagForName(doc->map,"urn:test",name))
+            ok = 0;
+
+        snprintf(name,20,"a%d",i);
+        snprintf(value,20,"%d",i);
+        const char *attr = DFGetAttribute(child,DFNameMapTagForName(doc->map,NULL,name));
+        if ((attr == NULL) || strcmp(attr,value))
+            ok = 0;
+
+        snprintf(value,20,"x%d",i);
+        attr = DFGetAttribute(child,DFNameMapTagForName(doc->map,"urn:other",name));
+        if ((attr == NULL) || strcmp(attr,value))
+            ok = 0;
+    }
+    utassert(count == 2000,"wrong number of elements");
+    utassert(ok,"wrong element or attribute names");
+    DFDocumentRelease(doc);
+}
+
+static void test_predefinedLookup(void)
+{
+    int ok = 1;
+    for (NamespaceID nsId = 1; nsId < PREDEFINED_NAMESPACE_COUNT; nsId++) {
+        if (DFLookupPredefinedNamespace(PredefinedNamespaces[nsId].namespaceURI) != nsId)
+            ok = 0;
+    }
+    utassert(ok,"predefined namespace not found");
+    utassert(DFLookupPredefinedNamespace(NULL) == NAMESPACE_NULL,"NULL URI found");
+    utassert(DFLookupPredefinedNamespace("urn:test") == NAMESPACE_NULL,"unknown URI found");
+
+    for (Tag tag = MIN_ELEMENT_TAG; tag < PREDEFINED_TAG_COUNT; tag++) {
+        const TagDecl *decl = &PredefinedTags[tag];
+        if (DFLookupPredefinedTag(decl->namespaceID,decl->localName) != tag)
+            ok = 0;
+        const char *URI = PredefinedNamespaces[decl->namespaceID].namespaceURI;
+        if (DFBuiltinMapTagForName(URI,decl->localName) != tag)
+            ok = 0;
+    }
+    utassert(ok,"predefined tag not found");
+    utassert(DFLookupPredefinedTag(NAMESPACE_HTML,"nonexistent") == 0,"unknown name found");
+    utassert(DFLookupPredefinedTag(NAMESPACE_WORD,"html") == 0,"name found in wrong namespace");
+    utassert(DFBuiltinMapTagForName("","b") == NULL_B,"empty URI not treated as no namespace");
+}
+
+// A synthetic document with a mix of elements, attributes and text, for timing parsing and walking
+char *XML_benchmarkDocument(int paragraphs)
+{
+    DFBuffer *xml = DFBufferNew();
+    DFBufferFormat(xml,"<html xmlns=\"http://www.w3.org/1999/xhtml\"><body>");
+    for (int i = 0; i < paragraphs; i++) {
+        DFBufferFormat(xml,"<p class=\"style%d\" id=\"p%d\">Paragraph %d, with ",i%20,i,i);
+        DFBufferFormat(xml,"<b>bold</b> and <span style=\"color: red\">coloured %d</span> text</p>",i);
+    }
+    DFBufferFormat(xml,"</body></html>");
+    char *result = xstrdup(xml->data);
+    DFBufferRelease(xml);
+    return result;
+}
+
+// Parse xml the given number of times, walking the tree with DFNextNode and DFNodeTextToBuffer after
+// each parse, and report the best rate for each in nodes per second. Returns the number of nodes,
+// or 0 if parsing failed or the walks did not all visit the same number of nodes.
+int XML_testBenchmark(const char *xml, int iterations, DFBuffer *output)
+{
+    double bestParse = 0;
+    double bestWalk = 0;
+    int nodeCount = 0;
+    for (int i = 0; i < iterations; i++) {
+        DFError *error = NULL;
+        double start = DFCurrentTime();
+        DFDocument *doc = DFParseXMLString(xml,&error);
+        double parseTime = DFCurrentTime() - start;
+        if (doc == NULL) {
+            DFBufferFormat(output,"Parse failed: %s\n",DFErrorMessage(&error));
+            DFErrorRelease(error);
+            return 0;
+        }
+
+        DFBuffer *text = DFBufferNew();
+        start = DFCurrentTime();
+        int count = 0;
+        for (DFNode *node = doc->docNode; node != NULL; node = DFNextNode(node))
+            count++;
+        DFNodeTextToBuffer(doc->docNode,text);
+        double walkTime = DFCurrentTime() - start;
+        DFBufferRelease(text);
+        DFDocumentRelease(doc);
+
+        if ((i > 0) && (count != nodeCount)) {
+            DFBufferFormat(output,"Walk %d visited %d nodes, not %d\n",i,count,nodeCount);
+            return 0;
+        }
+        nodeCount = count;
+        if ((i == 0) || (parseTime < bestParse))
+            bestParse = parseTime;
+        if ((i == 0) || (walkTime < bestWalk))
+            bestWalk = walkTime;
+    }
+
+    DFBufferFormat(output,"%d nodes, best of %d runs\n",nodeCount,iterations);
+    DFBufferFormat(output,"parse: %.3fs, %.2f Mnodes/s\n",bestParse,(bestParse > 0) ? nodeCount/bestParse/1e6 : 0.0);
+    DFBufferFormat(output,"walk:  %.3fs, %.2f Mnodes/s\n",bestWalk,(bestWalk > 0) ? nodeCount/bestWalk/1e6 : 0.0);
+    return nodeCount;
+}
+
+int XML_Benchmark(int argc, const char **argv)
+{
+    int paragraphs = 100000;
+    char *xml = NULL;
+    if ((argc >= 1) && (strspn(argv[0],"0123456789") != strlen(argv[0]))) {
+        DFError *error = NULL;
+        xml = DFStringReadFromFile(argv[0],&error);
+        if (xml == NULL) {
+            printf("%s: %s\n",argv[0],DFErrorMessage(&error));
+            DFErrorRelease(error);
+            return 0;
+        }
+    }
+    else {
+        if (argc >= 1)
+            paragraphs = atoi(argv[0]);
+        xml = XML_benchmarkDocument(paragraphs);
+    }
+    int iterations = (argc >= 2) ? atoi(argv[1]) : 5;
+    if (iterations < 1)
+        iterations = 1;
+
+    DFBuffer *output = DFBufferNew();
+    int nodeCount = XML_testBenchmark(xml,iterations,output);
+    printf("%s",output->data);
+    DFBufferRelease(output);
+    free(xml);
+    return nodeCount;
+}
+
+static void test_benchmark(void)
+{
+    // Document, html, body, and 8 nodes per paragraph
+    char *xml = XML_benchmarkDocument(100);
+    DFBuffer *output = DFBufferNew();
+    utassert(XML_testBenchmark(xml,2,output) == 3 + 8*100,"Wrong number of nodes walked");
+    DFBufferRelease(output);
+    free(xml);
+}
+
 TestGroup XMLTests = {
     "core.xml", {
         { "sample", PlainTest, test_sample },
+        { "DFDestroyNode", PlainTest, test_DFDestroyNode },
+        { "DFNodeForSeqNo", PlainTest, test_DFNodeForSeqNo },
+        { "processingInstruction", PlainTest, test_processingInstruction },
+        { "serializeInvalidUTF8", PlainTest, test_serializeInvalidUTF8 },
+        { "parseManyNames", PlainTest, test_parseManyNames },
+        { "predefinedLookup", PlainTest, test_predefinedLookup },
+        { "benchmark", PlainTest, test_benchmark },
         { NULL, PlainTest, NULL }
     }
 };
@@ -218,7 +218,7 @@ static void inlineToLaTeX(LaTeXConverter *conv, DFBuffer *output, DFNode *node)
             const char *style = DFGetAttribute(node,HTML_STYLE);
             if (style != NULL) {
                 CSSProperties *properties = CSSPropertiesNewWithString(style);
-                htmlWidth = DFStrDup(CSSGet(properties,"width"));
+                htmlWidth = DFStrDup(CSSGetID(properties,CSSPropertyWidth));
                 CSSPropertiesRelease(properties);
             }
 
@@ -527,10 +527,10 @@ static void containerChildrenToLaTeX(LaTeXConverter *conv, DFBuffer *output, DFN
 static void addGeometry(LaTeXConverter *conv, DFBuffer *output)
 {
     CSSProperties *properties = CSSSheetBodyProperties(conv->styleSheet);
-    const char *cssMarginLeft = CSSGet(properties,"margin-left");
-    const char *cssMarginRight = CSSGet(properties,"margin-right");
-    const char *cssMarginTop = CSSGet(properties,"margin-top");
-    const char *cssMarginBottom = CSSGet(properties,"margin-bottom");
+    const char *cssMarginLeft = CSSGetID(properties,CSSPropertyMarginLeft);
+    const char *cssMarginRight = CSSGetID(properties,CSSPropertyMarginRight);
+    const char *cssMarginTop = CSSGetID(properties,CSSPropertyMarginTop);
+    const char *cssMarginBottom = CSSGetID(properties,CSSPropertyMarginBottom);
 
     CSSLength marginLeft = CSSLengthFromString(cssMarginLeft);
     CSSLength marginRight = CSSLengthFromString(cssMarginRight);
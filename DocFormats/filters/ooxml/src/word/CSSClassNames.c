@@ -56,7 +56,7 @@ static void ensureStylesReferencedFromNode(DFNode *node, CSSSheet *styleSheet)
                 CSSStyle *style = CSSSheetLookupElement(styleSheet,"span","Hyperlink",0,0);
                 if (style == NULL) {
                     style = CSSSheetLookupElement(styleSheet,"span","Hyperlink",1,0);
-                    CSSPut(CSSStyleRule(style),"color","#0000FF");
+                    CSSPutID(CSSStyleRule(style),CSSPropertyColor,"#0000FF");
                     CSSSetUnderline(CSSStyleRule(style),1);
 
                     CSSStyle *parent = CSSSheetDefaultStyleForFamily(styleSheet,StyleFamilyCharacter);
@@ -86,10 +86,10 @@ static void ensureStylesReferencedFromNode(DFNode *node, CSSSheet *styleSheet)
                 // have to explicitly copy these properties over.
 
                 if (changed) {
-                    CSSPut(CSSStyleCell(grid),"padding-left",CSSGet(CSSStyleCell(dflt),"padding-left"));
-                    CSSPut(CSSStyleCell(grid),"padding-right",CSSGet(CSSStyleCell(dflt),"padding-right"));
-                    CSSPut(CSSStyleCell(grid),"padding-top",CSSGet(CSSStyleCell(dflt),"padding-top"));
-                    CSSPut(CSSStyleCell(grid),"padding-bottom",CSSGet(CSSStyleCell(dflt),"padding-bottom"));
+                    CSSPutID(CSSStyleCell(grid),CSSPropertyPaddingLeft,CSSGetID(CSSStyleCell(dflt),CSSPropertyPaddingLeft));
+                    CSSPutID(CSSStyleCell(grid),CSSPropertyPaddingRight,CSSGetID(CSSStyleCell(dflt),CSSPropertyPaddingRight));
+                    CSSPutID(CSSStyleCell(grid),CSSPropertyPaddingTop,CSSGetID(CSSStyleCell(dflt),CSSPropertyPaddingTop));
+                    CSSPutID(CSSStyleCell(grid),CSSPropertyPaddingBottom,CSSGetID(CSSStyleCell(dflt),CSSPropertyPaddingBottom));
                 }
             }
             break;
@@ -139,10 +139,10 @@ static void addHTMLDefaults(CSSStyle *style, CSSStyle *parent)
         }
 
         CSSProperties *properties = CSSStyleRule(style);
-        if ((CSSGet(properties,"font-weight") == NULL) && ((parent == NULL) || (CSSGet(CSSStyleRule(parent),"font-weight") == NULL)))
-            CSSPut(properties,"font-weight",fontWeight);
-        if ((CSSGet(properties,"font-size") == NULL) && ((parent == NULL) || (CSSGet(CSSStyleRule(parent),"font-size") == NULL)))
-            CSSPut(properties,"font-size",fontSize);
+        if ((CSSGetID(properties,CSSPropertyFontWeight) == NULL) && ((parent == NULL) || (CSSGetID(CSSStyleRule(parent),CSSPropertyFontWeight) == NULL)))
+            CSSPutID(properties,CSSPropertyFontWeight,fontWeight);
+        if ((CSSGetID(properties,CSSPropertyFontSize) == NULL) && ((parent == NULL) || (CSSGetID(CSSStyleRule(parent),CSSPropertyFontSize) == NULL)))
+            CSSPutID(properties,CSSPropertyFontSize,fontSize);
         // FIXME: This likely differs between languages
         // FIXME: Not covered by tests
         char *styleNext = CSSStyleCopyNext(style);
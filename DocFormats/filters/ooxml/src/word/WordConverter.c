@@ -199,11 +199,11 @@ static void Word_mergeRunsRecursive(DFNode *node)
             if (nodesEqual(currentRPr,nextRPr)) {
                 while (next->first != NULL) {
                     if (next->first->tag == WORD_RPR)
-                        DFRemoveNode(next->first);
+                        DFDestroyNode(next->first);
                     else
                         DFAppendChild(current,next->first);
                 }
-                DFRemoveNode(next);
+                DFDestroyNode(next);
                 continue;
             }
         }
@@ -294,8 +294,8 @@ static void Word_preProcessHTML(WordConverter *word, DFNode *node)
                     style = CSSSheetLookupElement(word->styleSheet,"figcaption",className,0,0);
 
                 CSSProperties *before = CSSStyleBefore(style);
-                if (CSSGet(before,"content") != NULL)
-                    Word_addContentParts(child,CSSGet(before,"content"),caption);
+                if (CSSGetID(before,CSSPropertyContent) != NULL)
+                    Word_addContentParts(child,CSSGetID(before,CSSPropertyContent),caption);
 
                 child->tag = HTML_P;
                 DFSetAttribute(child,HTML_CLASS,"Caption");
@@ -510,9 +510,9 @@ static void Word_postProcessHTML(WordConverter *conv, DFNode *node)
                     char *beforeText = extractPrefix(child,counterName);
                     if (beforeText != NULL) {
                         CSSStyle *style = CSSSheetLookupElement(conv->styleSheet,DFNodeName(child),NULL,1,0);
-                        if (CSSGet(CSSStyleBefore(style),"content") == NULL) {
-                            CSSPut(CSSStyleRule(style),"counter-increment",counterName);
-                            CSSPut(CSSStyleBefore(style),"content",beforeText);
+                        if (CSSGetID(CSSStyleBefore(style),CSSPropertyContent) == NULL) {
+                            CSSPutID(CSSStyleRule(style),CSSPropertyCounterIncrement,counterName);
+                            CSSPutID(CSSStyleBefore(style),CSSPropertyContent,beforeText);
                         }
                     }
                     free(beforeText);
@@ -803,10 +803,10 @@ static void addMissingDefaultStyles(WordConverter *converter)
     if (CSSSheetDefaultStyleForFamily(converter->styleSheet,StyleFamilyTable) == NULL) {
         CSSStyle *style = CSSSheetLookupElement(converter->styleSheet,"table","Normal_Table",1,0);
         CSSStyleSetDisplayName(style,"Normal Table");
-        CSSPut(CSSStyleCell(style),"padding-left","5.4pt");
-        CSSPut(CSSStyleCell(style),"padding-right","5.4pt");
-        CSSPut(CSSStyleCell(style),"padding-top","0pt");
-        CSSPut(CSSStyleCell(style),"padding-bottom","0pt");
+        CSSPutID(CSSStyleCell(style),CSSPropertyPaddingLeft,"5.4pt");
+        CSSPutID(CSSStyleCell(style),CSSPropertyPaddingRight,"5.4pt");
+        CSSPutID(CSSStyleCell(style),CSSPropertyPaddingTop,"0pt");
+        CSSPutID(CSSStyleCell(style),CSSPropertyPaddingBottom,"0pt");
         CSSSheetSetDefaultStyle(converter->styleSheet,style,StyleFamilyTable);
     }
 }
@@ -857,14 +857,14 @@ int WordConverterPut(DFDocument *html, DFStorage *abstractStorage, WordPackage *
     CSSProperties *page = (pageStyle != NULL) ? CSSPropertiesRetain(CSSStyleRule(pageStyle)) : CSSPropertiesNew();
     CSSProperties *body = (bodyStyle != NULL) ? CSSPropertiesRetain(CSSStyleRule(bodyStyle)) : CSSPropertiesNew();
 
-    if (CSSGet(body,"margin-left") == NULL)
-        CSSPut(body,"margin-left","10%");
-    if (CSSGet(body,"margin-right") == NULL)
-        CSSPut(body,"margin-right","10%");
-    if (CSSGet(body,"margin-top") == NULL)
-        CSSPut(body,"margin-top","10%");
-    if (CSSGet(body,"margin-bottom") == NULL)
-        CSSPut(body,"margin-bottom","10%");
+    if (CSSGetID(body,CSSPropertyMarginLeft) == NULL)
+        CSSPutID(body,CSSPropertyMarginLeft,"10%");
+    if (CSSGetID(body,CSSPropertyMarginRight) == NULL)
+        CSSPutID(body,CSSPropertyMarginRight,"10%");
+    if (CSSGetID(body,CSSPropertyMarginTop) == NULL)
+        CSSPutID(body,CSSPropertyMarginTop,"10%");
+    if (CSSGetID(body,CSSPropertyMarginBottom) == NULL)
+        CSSPutID(body,CSSPropertyMarginBottom,"10%");
 
     WordSectionUpdateFromCSSPage(converter->mainSection,page,body);
 
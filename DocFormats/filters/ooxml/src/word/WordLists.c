@@ -112,14 +112,14 @@ static ListDimensions cssPropertiesIndent(CSSProperties *properties)
     result.textIndentPct = 0;
     result.totalPct = 0;
 
-    if (CSSGet(properties,"margin-left") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(properties,"margin-left"));
+    if (CSSGetID(properties,CSSPropertyMarginLeft) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyMarginLeft));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             result.marginLeftPct = length.value;
     }
 
-    if (CSSGet(properties,"text-indent") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(properties,"text-indent"));
+    if (CSSGetID(properties,CSSPropertyTextIndent) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyTextIndent));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             result.textIndentPct = length.value;
     }
@@ -162,8 +162,8 @@ double listDesiredIndent(WordConverter *conv, const char *numId, const char *ilv
     listProperties(conv,numId,ilvl,properties);
     double result = 0.0;
 
-    if (CSSGet(properties,"margin-left") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(properties,"margin-left"));
+    if (CSSGetID(properties,CSSPropertyMarginLeft) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyMarginLeft));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             result += length.value;
     }
@@ -192,25 +192,25 @@ static void adjustMarginLeft(DFNode *element, double adjustPct, int noTextIndent
     CSSProperties *properties = CSSPropertiesNewWithString(cssText);
 
     double oldMarginLeft = 0;
-    if (CSSGet(properties,"margin-left") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(properties,"margin-left"));
+    if (CSSGetID(properties,CSSPropertyMarginLeft) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyMarginLeft));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             oldMarginLeft = length.value;
 
-        if (CSSGet(properties,"width") != NULL) {
-            CSSLength length = CSSLengthFromString(CSSGet(properties,"width"));
+        if (CSSGetID(properties,CSSPropertyWidth) != NULL) {
+            CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyWidth));
             if (CSSLengthIsValid(length) && (length.units == UnitsPct)) {
                 double oldWidth = length.value;
                 double newWidth = oldWidth + oldMarginLeft;
                 char buf[100];
-                CSSPut(properties,"width",DFFormatDoublePct(buf,100,newWidth));
+                CSSPutID(properties,CSSPropertyWidth,DFFormatDoublePct(buf,100,newWidth));
             }
         }
     }
 
     double oldTextIndent = 0;
-    if (CSSGet(properties,"text-indent") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(properties,"text-indent"));
+    if (CSSGetID(properties,CSSPropertyTextIndent) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(properties,CSSPropertyTextIndent));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             oldTextIndent = length.value;
     }
@@ -222,24 +222,24 @@ static void adjustMarginLeft(DFNode *element, double adjustPct, int noTextIndent
         newMarginLeft = 0;
     if (fabs(newMarginLeft) >= 0.01) {
         char buf[100];
-        CSSPut(properties,"margin-left",DFFormatDoublePct(buf,100,newMarginLeft));
+        CSSPutID(properties,CSSPropertyMarginLeft,DFFormatDoublePct(buf,100,newMarginLeft));
     }
     else {
-        CSSPut(properties,"margin-left",NULL);
+        CSSPutID(properties,CSSPropertyMarginLeft,NULL);
     }
 
     if (noTextIndent) {
-        CSSPut(properties,"text-indent",NULL);
+        CSSPutID(properties,CSSPropertyTextIndent,NULL);
     }
     else if (newTextIndent < -newMarginLeft) {
         // Don't allow negative text-indent
         newTextIndent = -newMarginLeft;
         if (fabs(newTextIndent) >= 0.01) {
             char buf[100];
-            CSSPut(properties,"text-indent",DFFormatDoublePct(buf,100,newTextIndent));
+            CSSPutID(properties,CSSPropertyTextIndent,DFFormatDoublePct(buf,100,newTextIndent));
         }
         else {
-            CSSPut(properties,"text-indent",NULL);
+            CSSPutID(properties,CSSPropertyTextIndent,NULL);
         }
     }
 
@@ -338,8 +338,6 @@ static void Word_fixListSingle(WordConverter *conv, DFNode *node)
 
             const char *numIdStr = DFGetAttribute(elem,WORD_NUMID);
             const char *ilvlStr = DFGetAttribute(elem,WORD_ILVL);
-            DFRemoveAttribute(elem,WORD_NUMID);
-            DFRemoveAttribute(elem,WORD_ILVL);
 
             // A numId of 0 means that there is no numbering applied to this paragraph
             if ((numIdStr != NULL) && (atoi(numIdStr) == 0)) {
@@ -404,6 +402,10 @@ static void Word_fixListSingle(WordConverter *conv, DFNode *node)
                     ListStackPushFrame(&stack,element,numId,ilvl,dimensions);
                 }
             }
+
+            // Removing the attributes frees their values, so this has to wait until we're done with them
+            DFRemoveAttribute(elem,WORD_NUMID);
+            DFRemoveAttribute(elem,WORD_ILVL);
         }
 
         if (stack.top != NULL) {
@@ -454,8 +456,8 @@ static void Word_flattenList(WordConverter *word, DFNode *list, int ilvl, DFNode
     const char *type = (list->tag == HTML_OL) ? "decimal" : "disc";
     const char *cssText = DFGetAttribute(list,HTML_STYLE);
     CSSProperties *properties = CSSPropertiesNewWithString(cssText);
-    if (CSSGet(properties,"list-style-type") != NULL)
-        type = CSSGet(properties,"list-style-type");
+    if (CSSGetID(properties,CSSPropertyListStyleType) != NULL)
+        type = CSSGetID(properties,CSSPropertyListStyleType);
 
     DFFormatAttribute(list,CONV_LISTNUM,"%u",list->seqNo);
     DFFormatAttribute(list,CONV_ILVL,"%d",ilvl);
@@ -83,7 +83,7 @@ static int twipsFromMarginValue(WordSection *section, const char *value)
 void WordSectionUpdateFromCSSPage(WordSection *section, CSSProperties *page, CSSProperties *body)
 {
     // FIXME: not covered by tests
-    const char *size = CSSGet(page,"size");
+    const char *size = CSSGetID(page,CSSPropertySize);
     if (DFStringEqualsCI(size,"A4 portrait")) {
         section->pageWidth = A4_WIDTH_TWIPS;
         section->pageHeight = A4_HEIGHT_TWIPS;
@@ -105,8 +105,8 @@ void WordSectionUpdateFromCSSPage(WordSection *section, CSSProperties *page, CSS
         section->pageHeight = A4_HEIGHT_TWIPS;
     }
 
-    section->leftMargin = twipsFromMarginValue(section,CSSGet(body,"margin-left"));
-    section->rightMargin = twipsFromMarginValue(section,CSSGet(body,"margin-right"));
-    section->topMargin = twipsFromMarginValue(section,CSSGet(body,"margin-top"));
-    section->bottomMargin = twipsFromMarginValue(section,CSSGet(body,"margin-bottom"));
+    section->leftMargin = twipsFromMarginValue(section,CSSGetID(body,CSSPropertyMarginLeft));
+    section->rightMargin = twipsFromMarginValue(section,CSSGetID(body,CSSPropertyMarginRight));
+    section->topMargin = twipsFromMarginValue(section,CSSGetID(body,CSSPropertyMarginTop));
+    section->bottomMargin = twipsFromMarginValue(section,CSSGetID(body,CSSPropertyMarginBottom));
 }
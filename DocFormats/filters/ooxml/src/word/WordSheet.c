@@ -19,6 +19,7 @@
 #include "DFDOM.h"
 #include "CSSSelector.h"
 #include "DFString.h"
+#include "DFAtom.h"
 #include "Word.h"
 #include "DFCommon.h"
 #include "DFPlatform.h"
@@ -69,11 +70,13 @@ static WordStyle *WordStyleNew(DFNode *element, const char *type, const char *st
     style->element = element;
     style->type = (type != NULL) ? xstrdup(type) : NULL;
     style->styleId = (styleId != NULL) ? xstrdup(styleId) : NULL;
-    style->ident = WordSheetIdentForType(style->type,style->styleId);
+    char *ident = WordSheetIdentForType(style->type,style->styleId);
+    style->ident = DFAtomGet(ident);
+    free(ident);
     style->basedOn = DFStrDup(DFGetChildAttribute(style->element,WORD_BASEDON,WORD_VAL));
     DFNode *pPr = DFChildWithTag(style->element,WORD_PPR);
     style->outlineLvl = DFStrDup(DFGetChildAttribute(pPr,WORD_OUTLINELVL,WORD_VAL));
-    style->name = xstrdup(name);
+    style->name = DFAtomGet(name);
 
     return style;
 }
@@ -92,14 +95,21 @@ static void WordStyleRelease(WordStyle *style)
 
     free(style->type);
     free(style->styleId);
-    free(style->selector);
-    free(style->ident);
+    DFAtomRelease(style->selector);
+    DFAtomRelease(style->ident);
     free(style->basedOn);
     free(style->outlineLvl);
-    free(style->name);
+    DFAtomRelease(style->name);
     free(style);
 }
 
+static void WordStyleSetSelector(WordStyle *style, const char *selector)
+{
+    const char *old = style->selector;
+    style->selector = (selector != NULL) ? DFAtomGet(selector) : NULL;
+    DFAtomRelease(old);
+}
+
 int WordStyleIsProtected(WordStyle *style)
 {
     return (!strcmp(style->name,WordStyleNameFootnoteReference) ||
@@ -127,9 +137,9 @@ WordSheet *WordSheetNew(DFDocument *doc)
 {
     WordSheet *sheet = (WordSheet *)xcalloc(1,sizeof(WordSheet));
 
-    sheet->stylesByIdent = DFHashTableNew((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
-    sheet->stylesByName = DFHashTableNew((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
-    sheet->stylesBySelector = DFHashTableNew((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
+    sheet->stylesByIdent = DFHashTableNewWithAtomKeys((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
+    sheet->stylesByName = DFHashTableNewWithAtomKeys((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
+    sheet->stylesBySelector = DFHashTableNewWithAtomKeys((DFCopyFunction)WordStyleRetain,(DFFreeFunction)WordStyleRelease);
     sheet->doc = DFDocumentRetain(doc);
     if (sheet->doc == NULL)
         sheet->doc = DFDocumentNewWithRoot(WORD_STYLES);;
@@ -142,8 +152,8 @@ WordSheet *WordSheetNew(DFDocument *doc)
             const char *name = DFGetChildAttribute(child,WORD_NAME,WORD_VAL);
             if ((type != NULL) && (styleId != NULL) && (name != NULL)) {
                 WordStyle *style = WordStyleNew(child,type,styleId,name);
-                DFHashTableAdd(sheet->stylesByIdent,style->ident,style);
-                DFHashTableAdd(sheet->stylesByName,style->name,style);
+                DFHashTableAddAtom(sheet->stylesByIdent,style->ident,style);
+                DFHashTableAddAtom(sheet->stylesByName,style->name,style);
                 WordStyleRelease(style);
             }
         }
@@ -211,10 +221,10 @@ WordStyle *WordSheetAddStyle(WordSheet *sheet, const char *type, const char *sty
     DFSetAttribute(nameNode,WORD_VAL,name);
 
     WordStyle *style = WordStyleNew(element,type,styleId,name);
-    style->selector = xstrdup(selector);
-    DFHashTableAdd(sheet->stylesByIdent,style->ident,style);
-    DFHashTableAdd(sheet->stylesByName,style->name,style);
-    DFHashTableAdd(sheet->stylesBySelector,style->selector,style);
+    WordStyleSetSelector(style,selector);
+    DFHashTableAddAtom(sheet->stylesByIdent,style->ident,style);
+    DFHashTableAddAtom(sheet->stylesByName,style->name,style);
+    DFHashTableAddAtom(sheet->stylesBySelector,style->selector,style);
     WordStyleRelease(style);
     return style;
 }
@@ -223,10 +233,10 @@ void WordSheetRemoveStyle(WordSheet *sheet, WordStyle *style)
 {
     WordStyleRetain(style);
     DFRemoveNode(style->element);
-    DFHashTableRemove(sheet->stylesByIdent,style->ident);
-    DFHashTableRemove(sheet->stylesByName,style->name);
+    DFHashTableRemoveAtom(sheet->stylesByIdent,style->ident);
+    DFHashTableRemoveAtom(sheet->stylesByName,style->name);
     if (style->selector != NULL)
-        DFHashTableRemove(sheet->stylesBySelector,style->selector);
+        DFHashTableRemoveAtom(sheet->stylesBySelector,style->selector);
     WordStyleRelease(style);
 }
 
@@ -270,9 +280,9 @@ static void determineSelectors(WordSheet *sheet)
 
         // Compute inherited properties
         WordStyle *ancestor = style;
-        DFHashTable *visited = DFHashTableNew((DFCopyFunction)xstrdup,free);
-        while ((ancestor != NULL) && (DFHashTableLookup(visited,ancestor->ident) == NULL)) {
-            DFHashTableAdd(visited,ancestor->ident,"");
+        DFHashTable *visited = DFHashTableNewWithAtomKeys(NULL,NULL);
+        while ((ancestor != NULL) && (DFHashTableLookupAtom(visited,ancestor->ident) == NULL)) {
+            DFHashTableAddAtom(visited,ancestor->ident,"");
 
             if (outlineLvl == NULL)
                 outlineLvl = ancestor->outlineLvl;
@@ -285,38 +295,42 @@ static void determineSelectors(WordSheet *sheet)
         DFHashTableRelease(visited);
 
         char *name = (style->name != NULL) ? WordStyleNameToClassName(style->name) : WordStyleNameToClassName(style->styleId);
+        char *selector = NULL;
 
         if (DFStringEquals(style->type,"paragraph")) {
             if ((outlineLvl != NULL) && (atoi(outlineLvl) >= 0) && (atoi(outlineLvl) <= 5)) {
                 int headingLevel = atoi(outlineLvl) + 1;
                 switch (headingLevel) {
-                    case 1: style->selector = CSSMakeSelector("h1",name); break;
-                    case 2: style->selector = CSSMakeSelector("h2",name); break;
-                    case 3: style->selector = CSSMakeSelector("h3",name); break;
-                    case 4: style->selector = CSSMakeSelector("h4",name); break;
-                    case 5: style->selector = CSSMakeSelector("h5",name); break;
-                    case 6: style->selector = CSSMakeSelector("h6",name); break;
-                    default: style->selector = CSSMakeSelector("p",name); break;
+                    case 1: selector = CSSMakeSelector("h1",name); break;
+                    case 2: selector = CSSMakeSelector("h2",name); break;
+                    case 3: selector = CSSMakeSelector("h3",name); break;
+                    case 4: selector = CSSMakeSelector("h4",name); break;
+                    case 5: selector = CSSMakeSelector("h5",name); break;
+                    case 6: selector = CSSMakeSelector("h6",name); break;
+                    default: selector = CSSMakeSelector("p",name); break;
                 }
             }
             else if (DFStringEquals(style->styleId,"Caption")) {
-                style->selector = CSSMakeSelector("caption",NULL);
+                selector = CSSMakeSelector("caption",NULL);
             }
             else if (DFStringEquals(style->styleId,"Figure")) {
-                style->selector = CSSMakeSelector("figure",NULL);
+                selector = CSSMakeSelector("figure",NULL);
             }
             else {
-                style->selector = CSSMakeSelector("p",name);
+                selector = CSSMakeSelector("p",name);
             }
         }
         else if (DFStringEquals(style->type,"character")) {
-            style->selector = CSSMakeSelector("span",name);
+            selector = CSSMakeSelector("span",name);
         }
         else if (DFStringEquals(style->type,"table")) {
-            style->selector = CSSMakeSelector("table",name);
+            selector = CSSMakeSelector("table",name);
+        }
+        if (selector != NULL) {
+            WordStyleSetSelector(style,selector);
+            DFHashTableAddAtom(sheet->stylesBySelector,style->selector,style);
         }
-        if (style->selector != NULL)
-            DFHashTableAdd(sheet->stylesBySelector,style->selector,style);
+        free(selector);
         free(name);
     }
     free(allIdents);
@@ -324,8 +338,9 @@ static void determineSelectors(WordSheet *sheet)
 
 static void setupNoteReferenceStyle(WordStyle *style)
 {
-    free(style->selector);
-    style->selector = CSSMakeSelector("span",style->styleId);
+    char *selector = CSSMakeSelector("span",style->styleId);
+    WordStyleSetSelector(style,selector);
+    free(selector);
     // FIXME: Set basedOn
     DFNode *rPr = DFCreateChildElement(style->element,WORD_RPR);
     DFNode *vertAlign = DFCreateChildElement(rPr,WORD_VERTALIGN);
@@ -334,8 +349,9 @@ static void setupNoteReferenceStyle(WordStyle *style)
 
 static void setupNoteTextStyle(WordStyle *style)
 {
-    free(style->selector);
-    style->selector = CSSMakeSelector("p",style->styleId);
+    char *selector = CSSMakeSelector("p",style->styleId);
+    WordStyleSetSelector(style,selector);
+    free(selector);
     // FIXME: Set basedOn
 }
 
@@ -36,11 +36,11 @@ struct WordStyle {
     DFNode *element;
     char *type;
     char *styleId;
-    char *selector;
-    char *ident;
+    const char *selector; // selector, ident and name are atoms (see DFAtom.h)
+    const char *ident;
     char *basedOn;
     char *outlineLvl;
-    char *name;
+    const char *name;
 };
 
 int WordStyleIsProtected(WordStyle *style);
@@ -174,9 +174,9 @@ static void WordGetStyle(DFNode *concrete, CSSStyle *style, WordConverter *conve
     const char *name = WordSheetStyleIdForSelector(converter->styles,style->selector);
     if ((family == StyleFamilyParagraph) && DFStringEquals(name,"ListParagraph")) {
         CSSProperties *properties = CSSStyleRule(style);
-        const char *wordMarginLeft = CSSGet(properties,"margin-left");
-        CSSPut(properties,"-word-margin-left",wordMarginLeft);
-        CSSPut(properties,"margin-left",NULL);
+        const char *wordMarginLeft = CSSGetID(properties,CSSPropertyMarginLeft);
+        CSSPutID(properties,CSSPropertyWordMarginLeft,wordMarginLeft);
+        CSSPutID(properties,CSSPropertyMarginLeft,NULL);
     }
 
     DFNode *pPr = DFChildWithTag(concrete,WORD_PPR);
@@ -193,9 +193,9 @@ static void WordGetStyle(DFNode *concrete, CSSStyle *style, WordConverter *conve
             case HTML_FIGURE:
             case HTML_TABLE: {
                 char *counterIncrement = DFFormatString("%s 0",style->elementName);
-                CSSPut(CSSStyleRule(style),"counter-reset","null");
-                CSSPut(CSSStyleRule(style),"counter-increment",counterIncrement);
-                CSSPut(CSSStyleBefore(style),"content","none");
+                CSSPutID(CSSStyleRule(style),CSSPropertyCounterReset,"null");
+                CSSPutID(CSSStyleRule(style),CSSPropertyCounterIncrement,counterIncrement);
+                CSSPutID(CSSStyleBefore(style),CSSPropertyContent,"none");
                 free(counterIncrement);
             }
         }
@@ -207,10 +207,10 @@ static void WordPutStyle(DFNode *concrete, CSSStyle *style, WordConverter *conve
     // If we find a style with a counter-increment value of "<elementname> 0", this means that it's
     // an explicitly unnumbered paragraph. So we set the numbering id to 0, so word doesn't increment
     // the corresponding counter when encountering this style
-    if (CSSGet(CSSStyleRule(style),"counter-increment") != NULL) {
+    if (CSSGetID(CSSStyleRule(style),CSSPropertyCounterIncrement) != NULL) {
         char *zeroIncrement = DFFormatString("%s 0",style->elementName);
-        if (DFStringEquals(CSSGet(CSSStyleRule(style),"counter-increment"),zeroIncrement))
-            CSSPut(CSSStyleRule(style),"-word-numId","0");
+        if (DFStringEquals(CSSGetID(CSSStyleRule(style),CSSPropertyCounterIncrement),zeroIncrement))
+            CSSPutID(CSSStyleRule(style),CSSPropertyWordNumId,"0");
         free(zeroIncrement);
     }
 
@@ -339,28 +339,28 @@ static void WordGetSectPr(DFNode *concrete, CSSProperties *body, CSSProperties *
             if (leftStr != NULL) {
                 double leftPct = 100.0*atof(leftStr)/width;
                 char buf[100];
-                CSSPut(body,"margin-left",DFFormatDoublePct(buf,100,leftPct));
+                CSSPutID(body,CSSPropertyMarginLeft,DFFormatDoublePct(buf,100,leftPct));
                 section->leftMargin = atoi(leftStr);
             }
 
             if (rightStr != NULL) {
                 double rightPct = 100.0*atof(rightStr)/width;
                 char buf[100];
-                CSSPut(body,"margin-right",DFFormatDoublePct(buf,100,rightPct));
+                CSSPutID(body,CSSPropertyMarginRight,DFFormatDoublePct(buf,100,rightPct));
                 section->rightMargin = atoi(rightStr);
             }
 
             if (topStr != NULL) {
                 double topPct = 100.0*atof(topStr)/width;
                 char buf[100];
-                CSSPut(body,"margin-top",DFFormatDoublePct(buf,100,topPct));
+                CSSPutID(body,CSSPropertyMarginTop,DFFormatDoublePct(buf,100,topPct));
                 section->topMargin = atoi(topStr);
             }
 
             if (bottomStr != NULL) {
                 double bottomPct = 100.0*atof(bottomStr)/width;
                 char buf[100];
-                CSSPut(body,"margin-bottom",DFFormatDoublePct(buf,100,bottomPct));
+                CSSPutID(body,CSSPropertyMarginBottom,DFFormatDoublePct(buf,100,bottomPct));
                 section->bottomMargin = atoi(bottomStr);
             }
 
@@ -369,13 +369,13 @@ static void WordGetSectPr(DFNode *concrete, CSSProperties *body, CSSProperties *
             int heightTwips = atoi(heightStr);
 
             if ((widthTwips == A4_WIDTH_TWIPS) && (heightTwips == A4_HEIGHT_TWIPS))
-                CSSPut(page,"size","A4 portrait");
+                CSSPutID(page,CSSPropertySize,"A4 portrait");
             else if ((widthTwips == A4_HEIGHT_TWIPS) && (heightTwips == A4_WIDTH_TWIPS))
-                CSSPut(page,"size","A4 landscape");
+                CSSPutID(page,CSSPropertySize,"A4 landscape");
             else if ((widthTwips == LETTER_WIDTH_TWIPS) && (heightTwips == LETTER_HEIGHT_TWIPS))
-                CSSPut(page,"size","letter portrait");
+                CSSPutID(page,CSSPropertySize,"letter portrait");
             else if ((widthTwips == LETTER_HEIGHT_TWIPS) && (heightTwips == LETTER_WIDTH_TWIPS))
-                CSSPut(page,"size","letter landscape");
+                CSSPutID(page,CSSPropertySize,"letter landscape");
         }
     }
 }
@@ -421,8 +421,8 @@ static void WordPutSectPr(DFNode *concrete, CSSSheet *styleSheet, WordSection *s
         heightTwips = atoi(heightStr);
     }
 
-    if (!DFStringEquals(CSSGet(oldPage,"size"),CSSGet(newPage,"size"))) {
-        const char *newSize = CSSGet(newPage,"size");
+    if (!DFStringEquals(CSSGetID(oldPage,CSSPropertySize),CSSGetID(newPage,CSSPropertySize))) {
+        const char *newSize = CSSGetID(newPage,CSSPropertySize);
         if (DFStringEqualsCI(newSize,"A4 portrait")) {
             widthTwips = A4_WIDTH_TWIPS;
             heightTwips = A4_HEIGHT_TWIPS;
@@ -460,17 +460,17 @@ static void WordPutSectPr(DFNode *concrete, CSSSheet *styleSheet, WordSection *s
         children[WORD_PGMAR] = DFCreateElement(concrete->doc,WORD_PGMAR);
 
     // Page margins
-    if (!DFStringEquals(CSSGet(oldBody,"margin-left"),CSSGet(newBody,"margin-left")) || updatePageSize)
-        updateTwipsFromLength(children[WORD_PGMAR],WORD_LEFT,CSSGet(newBody,"margin-left"),widthTwips);
+    if (!DFStringEquals(CSSGetID(oldBody,CSSPropertyMarginLeft),CSSGetID(newBody,CSSPropertyMarginLeft)) || updatePageSize)
+        updateTwipsFromLength(children[WORD_PGMAR],WORD_LEFT,CSSGetID(newBody,CSSPropertyMarginLeft),widthTwips);
 
-    if (!DFStringEquals(CSSGet(oldBody,"margin-right"),CSSGet(newBody,"margin-right")) || updatePageSize)
-        updateTwipsFromLength(children[WORD_PGMAR],WORD_RIGHT,CSSGet(newBody,"margin-right"),widthTwips);
+    if (!DFStringEquals(CSSGetID(oldBody,CSSPropertyMarginRight),CSSGetID(newBody,CSSPropertyMarginRight)) || updatePageSize)
+        updateTwipsFromLength(children[WORD_PGMAR],WORD_RIGHT,CSSGetID(newBody,CSSPropertyMarginRight),widthTwips);
 
-    if (!DFStringEquals(CSSGet(oldBody,"margin-top"),CSSGet(newBody,"margin-top")) || updatePageSize)
-        updateTwipsFromLength(children[WORD_PGMAR],WORD_TOP,CSSGet(newBody,"margin-top"),widthTwips);
+    if (!DFStringEquals(CSSGetID(oldBody,CSSPropertyMarginTop),CSSGetID(newBody,CSSPropertyMarginTop)) || updatePageSize)
+        updateTwipsFromLength(children[WORD_PGMAR],WORD_TOP,CSSGetID(newBody,CSSPropertyMarginTop),widthTwips);
 
-    if (!DFStringEquals(CSSGet(oldBody,"margin-bottom"),CSSGet(newBody,"margin-bottom")) || updatePageSize)
-        updateTwipsFromLength(children[WORD_PGMAR],WORD_BOTTOM,CSSGet(newBody,"margin-bottom"),widthTwips);
+    if (!DFStringEquals(CSSGetID(oldBody,CSSPropertyMarginBottom),CSSGetID(newBody,CSSPropertyMarginBottom)) || updatePageSize)
+        updateTwipsFromLength(children[WORD_PGMAR],WORD_BOTTOM,CSSGetID(newBody,CSSPropertyMarginBottom),widthTwips);
 
     if (children[WORD_PGMAR]->attrsCount == 0)
         children[WORD_PGMAR] = NULL;;
@@ -550,34 +550,34 @@ static void fixParagraphSpacing(CSSStyle *style, DFNode *element)
 
     if (beforeAuto != NULL) {
         if (Word_parseOnOff(beforeAuto))
-            CSSPut(rule,"margin-top",NULL);
+            CSSPutID(rule,CSSPropertyMarginTop,NULL);
         else
-            CSSPut(rule,"margin-top","0");
+            CSSPutID(rule,CSSPropertyMarginTop,"0");
     }
     else {
-        if (CSSGet(rule,"margin-top") == NULL)
-            CSSPut(rule,"margin-top","0");
+        if (CSSGetID(rule,CSSPropertyMarginTop) == NULL)
+            CSSPutID(rule,CSSPropertyMarginTop,"0");
     }
 
     int isBeforeAuto = ((beforeAuto != NULL) && Word_parseOnOff(beforeAuto));
     int isAfterAuto = ((afterAuto != NULL) && Word_parseOnOff(afterAuto));
 
     if (isBeforeAuto)
-        CSSPut(rule,"margin-top",NULL);
-    else if (CSSGet(rule,"margin-top") == NULL)
-        CSSPut(rule,"margin-top","0");
+        CSSPutID(rule,CSSPropertyMarginTop,NULL);
+    else if (CSSGetID(rule,CSSPropertyMarginTop) == NULL)
+        CSSPutID(rule,CSSPropertyMarginTop,"0");
 
     if (isAfterAuto)
-        CSSPut(rule,"margin-bottom",NULL);
-    else if (CSSGet(rule,"margin-bottom") == NULL)
-        CSSPut(rule,"margin-bottom","0");
+        CSSPutID(rule,CSSPropertyMarginBottom,NULL);
+    else if (CSSGetID(rule,CSSPropertyMarginBottom) == NULL)
+        CSSPutID(rule,CSSPropertyMarginBottom,"0");
 }
 
 CSSSheet *WordParseStyles(WordConverter *converter)
 {
     CSSSheet *styleSheet = CSSSheetNew();
     CSSStyle *bodyStyle = CSSSheetLookupElement(styleSheet,"body",NULL,1,0);
-    CSSPut(CSSStyleRule(bodyStyle),"counter-reset","h1 h2 h3 h4 h5 h6 figure table");
+    CSSPutID(CSSStyleRule(bodyStyle),CSSPropertyCounterReset,"h1 h2 h3 h4 h5 h6 figure table");
     parseBody(converter,styleSheet);
     if (converter->package->styles == NULL)
         return styleSheet;;
@@ -589,7 +589,9 @@ CSSSheet *WordParseStyles(WordConverter *converter)
 
     WordSheet *sheet = converter->styles;
 
+    // If there are several default styles for a family, the first by name is used
     const char **allIdents = WordSheetCopyIdents(sheet);
+    DFSortStringsCaseSensitive(allIdents);
     for (int i = 0; allIdents[i]; i++) {
         WordStyle *wordStyle = WordSheetStyleForIdent(sheet,allIdents[i]);
         if ((wordStyle->selector == NULL) || WordStyleIsProtected(wordStyle))
@@ -599,7 +601,8 @@ CSSSheet *WordParseStyles(WordConverter *converter)
         const char *defaultVal = DFGetAttribute(wordStyle->element,WORD_DEFAULT);
         if ((defaultVal != NULL) && Word_parseOnOff(defaultVal)) {
             StyleFamily family = WordStyleFamilyForSelector(style->selector);
-            CSSSheetSetDefaultStyle(styleSheet,style,family);
+            if (CSSSheetDefaultStyleForFamily(styleSheet,family) == NULL)
+                CSSSheetSetDefaultStyle(styleSheet,style,family);
             CSSSetDefault(CSSStyleRule(style),1);
 
             if (family == StyleFamilyParagraph)
@@ -620,10 +623,10 @@ CSSSheet *WordParseStyles(WordConverter *converter)
     // Special case for figure style: set left and right margin to auto, if not already set
     CSSStyle *figure = CSSSheetLookupElement(styleSheet,"figure",NULL,0,0);
     if (figure != NULL) {
-        if (CSSGet(CSSStyleRule(figure),"margin-left") == NULL)
-            CSSPut(CSSStyleRule(figure),"margin-left","auto");
-        if (CSSGet(CSSStyleRule(figure),"margin-right") == NULL)
-            CSSPut(CSSStyleRule(figure),"margin-right","auto");
+        if (CSSGetID(CSSStyleRule(figure),CSSPropertyMarginLeft) == NULL)
+            CSSPutID(CSSStyleRule(figure),CSSPropertyMarginLeft,"auto");
+        if (CSSGetID(CSSStyleRule(figure),CSSPropertyMarginRight) == NULL)
+            CSSPutID(CSSStyleRule(figure),CSSPropertyMarginRight,"auto");
     }
 
     return styleSheet;
@@ -648,10 +651,10 @@ static void updateDefaults(WordConverter *converter, CSSSheet *styleSheet)
         DFHashTable *collapsed = CSSCollapseProperties(CSSStyleRule(bodyStyle));
         CSSProperties *copy = CSSPropertiesNewWithRaw(collapsed);
         DFHashTableRelease(collapsed);
-        CSSPut(copy,"margin-top",NULL);
-        CSSPut(copy,"margin-bottom",NULL);
-        CSSPut(copy,"margin-left",NULL);
-        CSSPut(copy,"margin-right",NULL);
+        CSSPutID(copy,CSSPropertyMarginTop,NULL);
+        CSSPutID(copy,CSSPropertyMarginBottom,NULL);
+        CSSPutID(copy,CSSPropertyMarginLeft,NULL);
+        CSSPutID(copy,CSSPropertyMarginRight,NULL);
 
         DFNode *docDefaults = DFChildWithTag(root,WORD_DOCDEFAULTS);
         DFNode *rPrDefault = DFChildWithTag(docDefaults,WORD_RPRDEFAULT);
@@ -738,11 +741,11 @@ static char *WordStyleNameForStyle(CSSStyle *style)
 void WordUpdateStyles(WordConverter *converter, CSSSheet *styleSheet)
 {
     CSSStyle *paraDefault = CSSSheetDefaultStyleForFamily(styleSheet,StyleFamilyParagraph);
-    if (CSSGet(CSSStyleRule(paraDefault),"margin-top") == NULL)
-        CSSPut(CSSStyleRule(paraDefault),"margin-top","-word-auto");
+    if (CSSGetID(CSSStyleRule(paraDefault),CSSPropertyMarginTop) == NULL)
+        CSSPutID(CSSStyleRule(paraDefault),CSSPropertyMarginTop,"-word-auto");
 
-    if (CSSGet(CSSStyleRule(paraDefault),"margin-bottom") == NULL)
-        CSSPut(CSSStyleRule(paraDefault),"margin-bottom","-word-auto");
+    if (CSSGetID(CSSStyleRule(paraDefault),CSSPropertyMarginBottom) == NULL)
+        CSSPutID(CSSStyleRule(paraDefault),CSSPropertyMarginBottom,"-word-auto");
 
     if (converter->package->styles == NULL) // FIXME: create this document
         return;;
@@ -880,8 +883,8 @@ CSSStyle *WordSetupTableGridStyle(CSSSheet *styleSheet, int *changed)
         CSSPropertiesUpdateFromRaw(CSSStyleRule(style),collapsed);
         CSSPropertiesUpdateFromRaw(CSSStyleCell(style),collapsed);
         DFHashTableRelease(collapsed);
-        CSSPut(CSSStyleRule(style),"margin-left","auto");
-        CSSPut(CSSStyleRule(style),"margin-right","auto");
+        CSSPutID(CSSStyleRule(style),CSSPropertyMarginLeft,"auto");
+        CSSPutID(CSSStyleRule(style),CSSPropertyMarginRight,"auto");
 
         // These must be set last, as updateRaw clears them when modifying rule
         CSSStyleSetParent(style,"table.Normal_Table");
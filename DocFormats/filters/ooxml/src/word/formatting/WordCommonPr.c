@@ -83,7 +83,7 @@ void WordGetShd(DFNode *concrete, CSSProperties *properties)
     const char *fill = DFGetAttribute(concrete,WORD_FILL);
     if (isRRGGBB(fill)) {
         char *value = DFFormatString("#%s",fill);
-        CSSPut(properties,"background-color",value);
+        CSSPutID(properties,CSSPropertyBackgroundColor,value);
         free(value);
     }
 }
@@ -104,12 +104,12 @@ void WordGetNumPrStyle(DFNode *numPr, CSSStyle *style, WordConverter *converter)
     WordNumLevel *level = WordConcreteNumGetLevel(num,ilvl);
     if ((level != NULL) && (level->lvlText != NULL)) {
         char *parsed = parseLvlText(level->lvlText,num);
-        CSSPut(before,"content",parsed);
+        CSSPutID(before,CSSPropertyContent,parsed);
         free(parsed);
     }
 
     char *mainCounterName = DFFormatString("h%d",ilvl+1);
-    CSSPut(during,"counter-increment",mainCounterName);
+    CSSPutID(during,CSSPropertyCounterIncrement,mainCounterName);
     free(mainCounterName);
 
     DFBuffer *reset = DFBufferNew();
@@ -121,7 +121,7 @@ void WordGetNumPrStyle(DFNode *numPr, CSSStyle *style, WordConverter *converter)
             DFBufferFormat(reset," %s",counterName);
         free(counterName);
     }
-    CSSPut(during,"counter-reset",reset->data);
+    CSSPutID(during,CSSPropertyCounterReset,reset->data);
     DFBufferRelease(reset);
 }
 
@@ -171,13 +171,13 @@ void updateNumbering(WordConverter *converter, CSSSheet *cssSheet)
         DFHashTableAdd(infoByStyleId,selector,info);
 
         CSSStyle *cssStyle = CSSSheetLookupSelector(cssSheet,selector,0,0);
-        if ((cssStyle != NULL) && (CSSGet(CSSStyleBefore(cssStyle),"content") != NULL)) {
+        if ((cssStyle != NULL) && (CSSGetID(CSSStyleBefore(cssStyle),CSSPropertyContent) != NULL)) {
             char *elementName = CSSSelectorCopyElementName(selector);
 
             if ((cssStyle->headingLevel >= 1) && (cssStyle->headingLevel <= 6))
                 cssLevelNumbered[cssStyle->headingLevel-1] = 1;;
 
-            DFArray *contentParts = CSSParseContent(CSSGet(CSSStyleBefore(cssStyle),"content"));
+            DFArray *contentParts = CSSParseContent(CSSGetID(CSSStyleBefore(cssStyle),CSSPropertyContent));
             DFBuffer *format = DFBufferNew();
             for (size_t partIndex = 0; partIndex < DFArrayCount(contentParts); partIndex++) {
                 ContentPart *part = DFArrayItemAt(contentParts,partIndex);
@@ -295,9 +295,9 @@ void updateNumbering(WordConverter *converter, CSSSheet *cssSheet)
                 next = item->next;
                 CSSStyle *style = CSSSheetLookupSelector(cssSheet,item->selector,0,0);
                 // FIXME: need to do this comparison based on lvlText
-                if ((CSSGet(CSSStyleBefore(style),"content") != NULL) &&
-                    !DFStringEquals(CSSGet(CSSStyleBefore(style),"content"),"none") &&
-                    !DFStringEquals(CSSGet(CSSStyleBefore(style),"content"),"\"\"")) {
+                if ((CSSGetID(CSSStyleBefore(style),CSSPropertyContent) != NULL) &&
+                    !DFStringEquals(CSSGetID(CSSStyleBefore(style),CSSPropertyContent),"none") &&
+                    !DFStringEquals(CSSGetID(CSSStyleBefore(style),CSSPropertyContent),"\"\"")) {
                     DFHashTableAddInt(numStylesByLevel,i,style);
                 }
                 free(item->selector);
@@ -364,11 +364,11 @@ void updateNumbering(WordConverter *converter, CSSSheet *cssSheet)
         WordNumInfo *info = DFHashTableLookup(infoByStyleId,selector);
         CSSStyle *cssStyle = CSSSheetLookupSelector(cssSheet,selector,0,0);
         if (cssStyle != NULL) {
-            CSSPut(CSSStyleRule(cssStyle),"-word-numId",info->wordNumId);
+            CSSPutID(CSSStyleRule(cssStyle),CSSPropertyWordNumId,info->wordNumId);
             if (DFStringEquals(info->wordIlvl,"0"))
-                CSSPut(CSSStyleRule(cssStyle),"-word-ilvl",NULL);
+                CSSPutID(CSSStyleRule(cssStyle),CSSPropertyWordIlvl,NULL);
             else
-                CSSPut(CSSStyleRule(cssStyle),"-word-ilvl",info->wordIlvl);
+                CSSPutID(CSSStyleRule(cssStyle),CSSPropertyWordIlvl,info->wordIlvl);
         }
     }
     free(cssSelectors);
@@ -135,10 +135,10 @@ static void WordGetNumPr(DFNode *concrete, CSSProperties *properties)
     for (DFNode *child = concrete->first; child != NULL; child = child->next) {
         switch (child->tag) {
             case WORD_NUMID:
-                CSSPut(properties,"-word-numId",DFGetAttribute(child,WORD_VAL));
+                CSSPutID(properties,CSSPropertyWordNumId,DFGetAttribute(child,WORD_VAL));
                 break;
             case WORD_ILVL:
-                CSSPut(properties,"-word-ilvl",DFGetAttribute(child,WORD_VAL));
+                CSSPutID(properties,CSSPropertyWordIlvl,DFGetAttribute(child,WORD_VAL));
                 break;
         }
     }
@@ -152,15 +152,15 @@ static void WordPutNumPr(DFNode *concrete, CSSProperties *newp)
     CSSProperties *oldp = CSSPropertiesNew();
     WordGetNumPr(concrete,oldp);
 
-    if (!DFStringEquals(CSSGet(oldp,"-word-numId"),CSSGet(newp,"-word-numId")) ||
-        !DFStringEquals(CSSGet(oldp,"-word-ilvl"),CSSGet(newp,"-word-ilvl"))) {
-        if (CSSGet(newp,"-word-numId") != NULL) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyWordNumId),CSSGetID(newp,CSSPropertyWordNumId)) ||
+        !DFStringEquals(CSSGetID(oldp,CSSPropertyWordIlvl),CSSGetID(newp,CSSPropertyWordIlvl))) {
+        if (CSSGetID(newp,CSSPropertyWordNumId) != NULL) {
             children[WORD_NUMID] = DFCreateElement(concrete->doc,WORD_NUMID);
-            DFSetAttribute(children[WORD_NUMID],WORD_VAL,CSSGet(newp,"-word-numId"));
+            DFSetAttribute(children[WORD_NUMID],WORD_VAL,CSSGetID(newp,CSSPropertyWordNumId));
 
-            if (CSSGet(newp,"-word-ilvl") != NULL) {
+            if (CSSGetID(newp,CSSPropertyWordIlvl) != NULL) {
                 children[WORD_ILVL] = DFCreateElement(concrete->doc,WORD_ILVL);
-                DFSetAttribute(children[WORD_ILVL],WORD_VAL,CSSGet(newp,"-word-ilvl"));
+                DFSetAttribute(children[WORD_ILVL],WORD_VAL,CSSGetID(newp,CSSPropertyWordIlvl));
             }
             else {
                 children[WORD_ILVL] = NULL;
@@ -197,13 +197,13 @@ void WordGetPPr(DFNode *pPr, CSSProperties *properties, const char **styleId, Wo
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if (val != NULL) {
                     if (!strcmp(val,"left") || !strcmp(val,"start"))
-                        CSSPut(properties,"text-align","left");
+                        CSSPutID(properties,CSSPropertyTextAlign,"left");
                     else if (!strcmp(val,"right") || !strcmp(val,"end"))
-                        CSSPut(properties,"text-align","right");
+                        CSSPutID(properties,CSSPropertyTextAlign,"right");
                     else if (!strcmp(val,"center"))
-                        CSSPut(properties,"text-align","center");
+                        CSSPutID(properties,CSSPropertyTextAlign,"center");
                     else if (!strcmp(val,"both"))
-                        CSSPut(properties,"text-align","justify");
+                        CSSPutID(properties,CSSPropertyTextAlign,"justify");
                 }
                 break;
             }
@@ -225,13 +225,13 @@ void WordGetPPr(DFNode *pPr, CSSProperties *properties, const char **styleId, Wo
                 if (left != NULL) {
                     double leftPct = 100.0*atoi(left)/(double)WordSectionContentWidth(section);
                     char buf[100];
-                    CSSPut(properties,"margin-left",DFFormatDoublePct(buf,100,leftPct));
+                    CSSPutID(properties,CSSPropertyMarginLeft,DFFormatDoublePct(buf,100,leftPct));
                 }
 
                 if (right != NULL) {
                     double rightPct = 100.0*atoi(right)/(double)WordSectionContentWidth(section);
                     char buf[100];
-                    CSSPut(properties,"margin-right",DFFormatDoublePct(buf,100,rightPct));
+                    CSSPutID(properties,CSSPropertyMarginRight,DFFormatDoublePct(buf,100,rightPct));
                 }
 
                 // hanging and firstLine attributes are mutually exclusive. If both are specified,
@@ -239,12 +239,12 @@ void WordGetPPr(DFNode *pPr, CSSProperties *properties, const char **styleId, Wo
                 if (hanging != NULL) {
                     double indentPct = -100.0*atoi(hanging)/(double)WordSectionContentWidth(section);
                     char buf[100];
-                    CSSPut(properties,"text-indent",DFFormatDoublePct(buf,100,indentPct));
+                    CSSPutID(properties,CSSPropertyTextIndent,DFFormatDoublePct(buf,100,indentPct));
                 }
                 else if (firstLine != NULL) {
                     double indentPct = 100.0*atoi(firstLine)/(double)WordSectionContentWidth(section);
                     char buf[100];
-                    CSSPut(properties,"text-indent",DFFormatDoublePct(buf,100,indentPct));
+                    CSSPutID(properties,CSSPropertyTextIndent,DFFormatDoublePct(buf,100,indentPct));
                 }
 
                 break;
@@ -253,13 +253,13 @@ void WordGetPPr(DFNode *pPr, CSSProperties *properties, const char **styleId, Wo
                 const char *before = DFGetAttribute(child,WORD_BEFORE);
                 if (before != NULL) { // units: 1/20th of a point
                     char buf[100];
-                    CSSPut(properties,"margin-top",DFFormatDoublePt(buf,100,atoi(before)/20.0));
+                    CSSPutID(properties,CSSPropertyMarginTop,DFFormatDoublePt(buf,100,atoi(before)/20.0));
                 }
 
                 const char *after = DFGetAttribute(child,WORD_AFTER);
                 if (after != NULL) { // units: 1/20th of a point
                     char buf[100];
-                    CSSPut(properties,"margin-bottom",DFFormatDoublePt(buf,100,atoi(after)/20.0));
+                    CSSPutID(properties,CSSPropertyMarginBottom,DFFormatDoublePt(buf,100,atoi(after)/20.0));
                 }
 
                 const char *line = DFGetAttribute(child,WORD_LINE);
@@ -268,7 +268,7 @@ void WordGetPPr(DFNode *pPr, CSSProperties *properties, const char **styleId, Wo
                     // Only other alternative for lineRule is "atLeast", which we ignore
                     if (line != NULL) { // units: 1/2.4th of a percent
                         char buf[100];
-                        CSSPut(properties,"line-height",DFFormatDoublePct(buf,100,atoi(line)/2.4));
+                        CSSPutID(properties,CSSPropertyLineHeight,DFFormatDoublePct(buf,100,atoi(line)/2.4));
                     }
                 }
                 break;
@@ -348,8 +348,8 @@ void WordPutPPr(DFNode *pPr, CSSProperties *properties, const char *styleId, Wor
 
         // background-color
 
-        char *oldBackgroundColor = CSSHexColor(CSSGet(oldp,"background-color"),0);
-        char *newBackgroundColor = CSSHexColor(CSSGet(newp,"background-color"),0);
+        char *oldBackgroundColor = CSSHexColor(CSSGetID(oldp,CSSPropertyBackgroundColor),0);
+        char *newBackgroundColor = CSSHexColor(CSSGetID(newp,CSSPropertyBackgroundColor),0);
         if (!DFStringEquals(oldBackgroundColor,newBackgroundColor))
             WordPutShd(pPr->doc,&children[WORD_SHD],newBackgroundColor);
         free(oldBackgroundColor);
@@ -357,8 +357,8 @@ void WordPutPPr(DFNode *pPr, CSSProperties *properties, const char *styleId, Wor
 
         // text-align
 
-        if (!DFStringEquals(CSSGet(oldp,"text-align"),CSSGet(newp,"text-align"))) {
-            const char *newTextAlign = CSSGet(newp,"text-align");
+        if (!DFStringEquals(CSSGetID(oldp,CSSPropertyTextAlign),CSSGetID(newp,CSSPropertyTextAlign))) {
+            const char *newTextAlign = CSSGetID(newp,CSSPropertyTextAlign);
             if (newTextAlign != NULL) {
                 const char *val = NULL;
                 if (!strcmp(newTextAlign,"left"))
@@ -380,17 +380,17 @@ void WordPutPPr(DFNode *pPr, CSSProperties *properties, const char *styleId, Wor
         }
 
         if ((section != NULL) && (WordSectionContentWidth(section) >= 0)) {
-            const char *oldMarginLeft = CSSGet(oldp,"margin-left");
-            const char *oldMarginRight = CSSGet(oldp,"margin-right");
-            const char *oldTextIndent = CSSGet(oldp,"text-indent");
-            const char *newMarginLeft = CSSGet(newp,"margin-left");
-            const char *newMarginRight = CSSGet(newp,"margin-right");
-            const char *newTextIndent = CSSGet(newp,"text-indent");
+            const char *oldMarginLeft = CSSGetID(oldp,CSSPropertyMarginLeft);
+            const char *oldMarginRight = CSSGetID(oldp,CSSPropertyMarginRight);
+            const char *oldTextIndent = CSSGetID(oldp,CSSPropertyTextIndent);
+            const char *newMarginLeft = CSSGetID(newp,CSSPropertyMarginLeft);
+            const char *newMarginRight = CSSGetID(newp,CSSPropertyMarginRight);
+            const char *newTextIndent = CSSGetID(newp,CSSPropertyTextIndent);
 
             // Special case of the List_Paragraph style, which is used by Word to ensure lists are indented. We
             // don't set this property for HTML, because it automatically indents lists. However we need to ensure
             // that it remains unchanged when updating the word document
-            const char *newWordMarginLeft = CSSGet(newp,"-word-margin-left");
+            const char *newWordMarginLeft = CSSGetID(newp,CSSPropertyWordMarginLeft);
             if (newMarginLeft == NULL)
                 newMarginLeft = newWordMarginLeft;
 
@@ -444,41 +444,41 @@ void WordPutPPr(DFNode *pPr, CSSProperties *properties, const char *styleId, Wor
             }
         }
 
-        if (!DFStringEquals(CSSGet(oldp,"margin-top"),CSSGet(newp,"margin-top")) ||
-            !DFStringEquals(CSSGet(oldp,"margin-bottom"),CSSGet(newp,"margin-bottom")) ||
-            !DFStringEquals(CSSGet(oldp,"line-height"),CSSGet(newp,"line-height"))) {
+        if (!DFStringEquals(CSSGetID(oldp,CSSPropertyMarginTop),CSSGetID(newp,CSSPropertyMarginTop)) ||
+            !DFStringEquals(CSSGetID(oldp,CSSPropertyMarginBottom),CSSGetID(newp,CSSPropertyMarginBottom)) ||
+            !DFStringEquals(CSSGetID(oldp,CSSPropertyLineHeight),CSSGetID(newp,CSSPropertyLineHeight))) {
 
-            if ((CSSGet(newp,"margin-top") == NULL) &&
-                (CSSGet(newp,"margin-bottom") == NULL) &&
-                (CSSGet(newp,"line-height") == NULL)) {
+            if ((CSSGetID(newp,CSSPropertyMarginTop) == NULL) &&
+                (CSSGetID(newp,CSSPropertyMarginBottom) == NULL) &&
+                (CSSGetID(newp,CSSPropertyLineHeight) == NULL)) {
                 children[WORD_SPACING] = NULL;
             }
             else {
                 children[WORD_SPACING] = DFCreateElement(pPr->doc,WORD_SPACING);
 
-                if (DFStringEquals(CSSGet(newp,"margin-top"),"-word-auto")) {
+                if (DFStringEquals(CSSGetID(newp,CSSPropertyMarginTop),"-word-auto")) {
                     DFSetAttribute(children[WORD_SPACING],WORD_BEFORE,"100");
                     DFSetAttribute(children[WORD_SPACING],WORD_BEFOREAUTOSPACING,"1");
                 }
                 else {
-                    char *before = twipsFromCSS(CSSGet(newp,"margin-top"),WordSectionContentWidth(section));
+                    char *before = twipsFromCSS(CSSGetID(newp,CSSPropertyMarginTop),WordSectionContentWidth(section));
                     DFSetAttribute(children[WORD_SPACING],WORD_BEFORE,before);
                     DFSetAttribute(children[WORD_SPACING],WORD_BEFOREAUTOSPACING,NULL);
                     free(before);
                 }
 
-                if (DFStringEquals(CSSGet(newp,"margin-bottom"),"-word-auto")) {
+                if (DFStringEquals(CSSGetID(newp,CSSPropertyMarginBottom),"-word-auto")) {
                     DFSetAttribute(children[WORD_SPACING],WORD_AFTER,"100");
                     DFSetAttribute(children[WORD_SPACING],WORD_AFTERAUTOSPACING,"1");
                 }
                 else {
-                    char *after = twipsFromCSS(CSSGet(newp,"margin-bottom"),WordSectionContentWidth(section));
+                    char *after = twipsFromCSS(CSSGetID(newp,CSSPropertyMarginBottom),WordSectionContentWidth(section));
                     DFSetAttribute(children[WORD_SPACING],WORD_AFTER,after);
                     DFSetAttribute(children[WORD_SPACING],WORD_AFTERAUTOSPACING,NULL);
                     free(after);
                 }
 
-                CSSLength lineHeight = CSSLengthFromString(CSSGet(newp,"line-height"));
+                CSSLength lineHeight = CSSLengthFromString(CSSGetID(newp,CSSPropertyLineHeight));
                 if (CSSLengthIsValid(lineHeight) && (lineHeight.units == UnitsPct)) {
                     int value = (int)round(lineHeight.value*2.4);
                     DFFormatAttribute(children[WORD_SPACING],WORD_LINE,"%d",value);
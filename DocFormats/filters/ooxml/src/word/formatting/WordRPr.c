@@ -138,7 +138,7 @@ static void highlightGet(DFNode *concrete, CSSProperties *properties)
         return;
     for (int i = 0; highlightColors[i].highlight != NULL; i++) {
         if (!strcmp(val,highlightColors[i].highlight)) {
-            CSSPut(properties,"background-color",highlightColors[i].color);
+            CSSPutID(properties,CSSPropertyBackgroundColor,highlightColors[i].color);
             break;
         }
     }
@@ -158,34 +158,34 @@ void WordGetRPr(DFNode *concrete, CSSProperties *properties, const char **styleI
             case WORD_BCS: {
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if ((val == NULL) || Word_parseOnOff(val))
-                    CSSPut(properties,"font-weight","bold");
+                    CSSPutID(properties,CSSPropertyFontWeight,"bold");
                 else
-                    CSSPut(properties,"font-weight","normal");
+                    CSSPutID(properties,CSSPropertyFontWeight,"normal");
                 break;
             }
             case WORD_I:
             case WORD_ICS: {
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if ((val == NULL) || Word_parseOnOff(val))
-                    CSSPut(properties,"font-style","italic");
+                    CSSPutID(properties,CSSPropertyFontStyle,"italic");
                 else
-                    CSSPut(properties,"font-style","normal");
+                    CSSPutID(properties,CSSPropertyFontStyle,"normal");
                 break;
             }
             case WORD_CAPS: {
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if ((val == NULL) || Word_parseOnOff(val))
-                    CSSPut(properties,"text-transform","uppercase");
+                    CSSPutID(properties,CSSPropertyTextTransform,"uppercase");
                 else
-                    CSSPut(properties,"text-transform","none");
+                    CSSPutID(properties,CSSPropertyTextTransform,"none");
                 break;
             }
             case WORD_SMALLCAPS: {
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if ((val == NULL) || Word_parseOnOff(val))
-                    CSSPut(properties,"font-variant","small-caps");
+                    CSSPutID(properties,CSSPropertyFontVariant,"small-caps");
                 else
-                    CSSPut(properties,"font-variant","normal");
+                    CSSPutID(properties,CSSPropertyFontVariant,"normal");
                 break;
             }
             case WORD_U: {
@@ -208,16 +208,16 @@ void WordGetRPr(DFNode *concrete, CSSProperties *properties, const char **styleI
             case WORD_VERTALIGN: {
                 const char *val = DFGetAttribute(child,WORD_VAL);
                 if ((val != NULL) && !strcmp(val,"subscript"))
-                    CSSPut(properties,"vertical-align","sub");
+                    CSSPutID(properties,CSSPropertyVerticalAlign,"sub");
                 else if ((val != NULL) && !strcmp(val,"superscript"))
-                    CSSPut(properties,"vertical-align","super");
+                    CSSPutID(properties,CSSPropertyVerticalAlign,"super");
                 break;
             }
             case WORD_COLOR: {
                 const char *value = DFGetAttribute(child,WORD_VAL);
                 if ((value != NULL) && isRRGGBB(value)) {
                     char *cssValue = DFFormatString("#%s",value);
-                    CSSPut(properties,"color",cssValue);
+                    CSSPutID(properties,CSSPropertyColor,cssValue);
                     free(cssValue);
                 }
                 break;
@@ -227,7 +227,7 @@ void WordGetRPr(DFNode *concrete, CSSProperties *properties, const char **styleI
                 // units: 1/2 pt
                 if (value != NULL) {
                     char buf[100];
-                    CSSPut(properties,"font-size",DFFormatDoublePt(buf,100,atof(value)/2));
+                    CSSPutID(properties,CSSPropertyFontSize,DFFormatDoublePt(buf,100,atof(value)/2));
                 }
                 break;
             }
@@ -242,18 +242,18 @@ void WordGetRPr(DFNode *concrete, CSSProperties *properties, const char **styleI
                 if (fontFamily == NULL)
                     fontFamily = DFGetAttribute(child,WORD_CS);
 
-                CSSPut(properties,"font-family",substituteFontFromWord(fontFamily));
+                CSSPutID(properties,CSSPropertyFontFamily,substituteFontFromWord(fontFamily));
 
                 const char *asciiTheme = DFGetAttribute(child,WORD_ASCIITHEME);
                 if (asciiTheme != NULL) {
                     if (!strncmp(asciiTheme,"major",5) && (theme->majorFont != NULL))
-                        CSSPut(properties,"font-family",theme->majorFont);
+                        CSSPutID(properties,CSSPropertyFontFamily,theme->majorFont);
                     else if (!strncmp(asciiTheme,"minor",5) && (theme->minorFont != NULL))
-                        CSSPut(properties,"font-family",theme->minorFont);
+                        CSSPutID(properties,CSSPropertyFontFamily,theme->minorFont);
                 }
 
-                char *encodedFontFamily = CSSEncodeFontFamily(CSSGet(properties,"font-family"));
-                CSSPut(properties,"font-family",encodedFontFamily);
+                char *encodedFontFamily = CSSEncodeFontFamily(CSSGetID(properties,CSSPropertyFontFamily));
+                CSSPutID(properties,CSSPropertyFontFamily,encodedFontFamily);
                 free(encodedFontFamily);
                 break;
             }
@@ -288,8 +288,8 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Font weight (bold/normal)
-    if (!DFStringEquals(CSSGet(oldp,"font-weight"),CSSGet(newp,"font-weight"))) {
-        if (DFStringEquals(CSSGet(newp,"font-weight"),"bold")) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyFontWeight),CSSGetID(newp,CSSPropertyFontWeight))) {
+        if (DFStringEquals(CSSGetID(newp,CSSPropertyFontWeight),"bold")) {
             children[WORD_B] = DFCreateElement(concrete->doc,WORD_B);
             children[WORD_BCS] = DFCreateElement(concrete->doc,WORD_BCS);
         }
@@ -300,8 +300,8 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Font style (italic/normal)
-    if (!DFStringEquals(CSSGet(oldp,"font-style"),CSSGet(newp,"font-style"))) {
-        if (DFStringEquals(CSSGet(newp,"font-style"),"italic")) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyFontStyle),CSSGetID(newp,CSSPropertyFontStyle))) {
+        if (DFStringEquals(CSSGetID(newp,CSSPropertyFontStyle),"italic")) {
             children[WORD_I] = DFCreateElement(concrete->doc,WORD_I);
             children[WORD_ICS] = DFCreateElement(concrete->doc,WORD_ICS);
         }
@@ -312,11 +312,11 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Text transform (uppercase/normal)
-    if (!DFStringEquals(CSSGet(oldp,"text-transform"),CSSGet(newp,"text-transform"))) {
-        if (DFStringEquals(CSSGet(newp,"text-transform"),"uppercase")) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyTextTransform),CSSGetID(newp,CSSPropertyTextTransform))) {
+        if (DFStringEquals(CSSGetID(newp,CSSPropertyTextTransform),"uppercase")) {
             children[WORD_CAPS] = DFCreateElement(concrete->doc,WORD_CAPS);
         }
-        else if (DFStringEquals(CSSGet(newp,"text-transform"),"none")) {
+        else if (DFStringEquals(CSSGetID(newp,CSSPropertyTextTransform),"none")) {
             children[WORD_CAPS] = DFCreateElement(concrete->doc,WORD_CAPS);
             DFSetAttribute(children[WORD_CAPS],WORD_VAL,"false");
         }
@@ -326,11 +326,11 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Font variant (small-caps/normal)
-    if (!DFStringEquals(CSSGet(oldp,"font-variant"),CSSGet(newp,"font-variant"))) {
-        if (DFStringEquals(CSSGet(newp,"font-variant"),"small-caps")) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyFontVariant),CSSGetID(newp,CSSPropertyFontVariant))) {
+        if (DFStringEquals(CSSGetID(newp,CSSPropertyFontVariant),"small-caps")) {
             children[WORD_SMALLCAPS] = DFCreateElement(concrete->doc,WORD_SMALLCAPS);
         }
-        else if (DFStringEquals(CSSGet(newp,"font-variant"),"normal")) {
+        else if (DFStringEquals(CSSGetID(newp,CSSPropertyFontVariant),"normal")) {
             children[WORD_SMALLCAPS] = DFCreateElement(concrete->doc,WORD_SMALLCAPS);
             DFSetAttribute(children[WORD_SMALLCAPS],WORD_VAL,"false");
         }
@@ -360,12 +360,12 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Vertical alignment (subscript/superscript)
-    if (!DFStringEquals(CSSGet(oldp,"vertical-align"),CSSGet(newp,"vertical-align"))) {
-        if (DFStringEquals(CSSGet(newp,"vertical-align"),"sub")) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyVerticalAlign),CSSGetID(newp,CSSPropertyVerticalAlign))) {
+        if (DFStringEquals(CSSGetID(newp,CSSPropertyVerticalAlign),"sub")) {
             children[WORD_VERTALIGN] = DFCreateElement(concrete->doc,WORD_VERTALIGN);
             DFSetAttribute(children[WORD_VERTALIGN],WORD_VAL,"subscript");
         }
-        else if (DFStringEquals(CSSGet(newp,"vertical-align"),"sup")) {
+        else if (DFStringEquals(CSSGetID(newp,CSSPropertyVerticalAlign),"sup")) {
             children[WORD_VERTALIGN] = DFCreateElement(concrete->doc,WORD_VERTALIGN);
             DFSetAttribute(children[WORD_VERTALIGN],WORD_VAL,"superscript");
         }
@@ -375,8 +375,8 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Text color
-    char *oldColor = CSSHexColor(CSSGet(oldp,"color"),0);
-    char *newColor = CSSHexColor(CSSGet(newp,"color"),0);
+    char *oldColor = CSSHexColor(CSSGetID(oldp,CSSPropertyColor),0);
+    char *newColor = CSSHexColor(CSSGetID(newp,CSSPropertyColor),0);
     if (!DFStringEquals(oldColor,newColor)) {
         if (newColor != NULL) {
             children[WORD_COLOR] = DFCreateElement(concrete->doc,WORD_COLOR);
@@ -391,8 +391,8 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
 
     // background-color
 
-    char *oldBackgroundColor = CSSHexColor(CSSGet(oldp,"background-color"),0);
-    char *newBackgroundColor = CSSHexColor(CSSGet(newp,"background-color"),0);
+    char *oldBackgroundColor = CSSHexColor(CSSGetID(oldp,CSSPropertyBackgroundColor),0);
+    char *newBackgroundColor = CSSHexColor(CSSGetID(newp,CSSPropertyBackgroundColor),0);
     if (!DFStringEquals(oldBackgroundColor,newBackgroundColor)) {
         children[WORD_HIGHLIGHT] = NULL;
         WordPutShd(concrete->doc,&children[WORD_SHD],newBackgroundColor);
@@ -402,11 +402,11 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
 
     // Font size
     // units: 1/2 pt
-    if (!DFStringEquals(CSSGet(oldp,"font-size"),CSSGet(newp,"font-size"))) {
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyFontSize),CSSGetID(newp,CSSPropertyFontSize))) {
         children[WORD_SZ] = NULL;
         children[WORD_SZCS] = NULL;
-        if (CSSGet(newp,"font-size") != NULL) {
-            CSSLength length = CSSLengthFromString(CSSGet(newp,"font-size"));
+        if (CSSGetID(newp,CSSPropertyFontSize) != NULL) {
+            CSSLength length = CSSLengthFromString(CSSGetID(newp,CSSPropertyFontSize));
             if (CSSLengthIsValid(length) && (length.units != UnitsPct)) {
                 double dval = convertBetweenUnits(length.value,length.units,UnitsPt);
                 int ival = (int)dval;
@@ -420,8 +420,8 @@ void WordPutRPr(DFNode *concrete, CSSProperties *newp, const char *newStyleId, s
     }
 
     // Font family
-    char *oldFontFamily = CSSDecodeFontFamily(CSSGet(oldp,"font-family"));
-    char *newFontFamily = CSSDecodeFontFamily(CSSGet(newp,"font-family"));
+    char *oldFontFamily = CSSDecodeFontFamily(CSSGetID(oldp,CSSPropertyFontFamily));
+    char *newFontFamily = CSSDecodeFontFamily(CSSGetID(newp,CSSPropertyFontFamily));
     if (!DFStringEquals(oldFontFamily,newFontFamily)) {
         const char *subst = substituteFontToWord(newFontFamily);
         if (subst != NULL) {
@@ -150,27 +150,27 @@ static void WordGetTblBorders(DFNode *concrete, CSSProperties *table, CSSPropert
     }
 
     if (haveInsideH) {
-        if (CSSGet(table,"border-left-style") == NULL) {
-            CSSPut(table,"border-left-style","hidden");
-            CSSPut(table,"border-left-width",NULL);
-            CSSPut(table,"border-left-color",NULL);
+        if (CSSGetID(table,CSSPropertyBorderLeftStyle) == NULL) {
+            CSSPutID(table,CSSPropertyBorderLeftStyle,"hidden");
+            CSSPutID(table,CSSPropertyBorderLeftWidth,NULL);
+            CSSPutID(table,CSSPropertyBorderLeftColor,NULL);
         }
-        if (CSSGet(table,"border-right-style") == NULL) {
-            CSSPut(table,"border-right-style","hidden");
-            CSSPut(table,"border-right-width",NULL);
-            CSSPut(table,"border-right-color",NULL);
+        if (CSSGetID(table,CSSPropertyBorderRightStyle) == NULL) {
+            CSSPutID(table,CSSPropertyBorderRightStyle,"hidden");
+            CSSPutID(table,CSSPropertyBorderRightWidth,NULL);
+            CSSPutID(table,CSSPropertyBorderRightColor,NULL);
         }
     }
     if (haveInsideV) {
-        if (CSSGet(table,"border-top-style") == NULL) {
-            CSSPut(table,"border-top-style","hidden");
-            CSSPut(table,"border-top-width",NULL);
-            CSSPut(table,"border-top-color",NULL);
+        if (CSSGetID(table,CSSPropertyBorderTopStyle) == NULL) {
+            CSSPutID(table,CSSPropertyBorderTopStyle,"hidden");
+            CSSPutID(table,CSSPropertyBorderTopWidth,NULL);
+            CSSPutID(table,CSSPropertyBorderTopColor,NULL);
         }
-        if (CSSGet(table,"border-bottom-style") == NULL) {
-            CSSPut(table,"border-bottom-style","hidden");
-            CSSPut(table,"border-bottom-width",NULL);
-            CSSPut(table,"border-bottom-color",NULL);
+        if (CSSGetID(table,CSSPropertyBorderBottomStyle) == NULL) {
+            CSSPutID(table,CSSPropertyBorderBottomStyle,"hidden");
+            CSSPutID(table,CSSPropertyBorderBottomWidth,NULL);
+            CSSPutID(table,CSSPropertyBorderBottomColor,NULL);
         }
     }
 }
@@ -290,7 +290,7 @@ void WordGetTblPr(DFNode *concrete, CSSProperties *table, CSSProperties *cell, W
                 if (width == NULL)
                     break;
                 char *widthValue = cssPctWidth(type,width,section);
-                CSSPut(table,"width",widthValue);
+                CSSPutID(table,CSSPropertyWidth,widthValue);
                 free(widthValue);
                 break;
             }
@@ -308,16 +308,16 @@ void WordGetTblPr(DFNode *concrete, CSSProperties *table, CSSProperties *cell, W
             case WORD_JC: {
                 const char *value = DFGetAttribute(child,WORD_VAL);
                 if ((value != NULL) && !strcmp(value,"center")) {
-                    CSSPut(table,"margin-left","auto");
-                    CSSPut(table,"margin-right","auto");
+                    CSSPutID(table,CSSPropertyMarginLeft,"auto");
+                    CSSPutID(table,CSSPropertyMarginRight,"auto");
                 }
                 else if ((value != NULL) && (!strcmp(value,"right") || !strcmp(value,"end"))) {
-                    CSSPut(table,"margin-left","auto");
-                    CSSPut(table,"margin-right","0");
+                    CSSPutID(table,CSSPropertyMarginLeft,"auto");
+                    CSSPutID(table,CSSPropertyMarginRight,"0");
                 }
                 else if ((value != NULL) && (!strcmp(value,"left") || !strcmp(value,"start"))) {
-                    CSSPut(table,"margin-left","0");
-                    CSSPut(table,"margin-right","auto");
+                    CSSPutID(table,CSSPropertyMarginLeft,"0");
+                    CSSPutID(table,CSSPropertyMarginRight,"auto");
                 }
                 break;
             }
@@ -329,12 +329,12 @@ void WordGetTblPr(DFNode *concrete, CSSProperties *table, CSSProperties *cell, W
     for (DFNode *child = concrete->first; child != NULL; child = child->next) {
         switch (child->tag) {
             case WORD_TBLIND:
-                if ((CSSGet(table,"margin-left") == NULL) || !strcmp(CSSGet(table,"margin-left"),"0")) {
+                if ((CSSGetID(table,CSSPropertyMarginLeft) == NULL) || !strcmp(CSSGetID(table,CSSPropertyMarginLeft),"0")) {
                     const char *type = DFGetAttribute(child,WORD_TYPE);
                     const char *w = DFGetAttribute(child,WORD_W);
                     char *newMarginLeft = cssPctWidth(type,w,section);
                     if ((newMarginLeft != NULL) && !DFStringEquals(newMarginLeft,"0%"))
-                        CSSPut(table,"margin-left",newMarginLeft);
+                        CSSPutID(table,CSSPropertyMarginLeft,newMarginLeft);
                     free(newMarginLeft);
                 }
                 break;
@@ -363,10 +363,10 @@ void WordPutTblPr(DFNode *concrete, CSSProperties *newTable, CSSProperties *newC
         }
     }
 
-    if (!DFStringEquals(CSSGet(oldTable,"width"),CSSGet(newTable,"width"))) {
+    if (!DFStringEquals(CSSGetID(oldTable,CSSPropertyWidth),CSSGetID(newTable,CSSPropertyWidth))) {
         CSSLength length = CSSLengthNull;
-        if (CSSGet(newTable,"width") != NULL) {
-            length = CSSLengthFromString(CSSGet(newTable,"width"));
+        if (CSSGetID(newTable,CSSPropertyWidth) != NULL) {
+            length = CSSLengthFromString(CSSGetID(newTable,CSSPropertyWidth));
             if (!CSSLengthIsValid(length) || (length.units != UnitsPct))
                 length = CSSLengthNull;
         }
@@ -382,13 +382,13 @@ void WordPutTblPr(DFNode *concrete, CSSProperties *newTable, CSSProperties *newC
         }
     }
 
-    if (!DFStringEquals(CSSGet(oldTable,"margin-left"),CSSGet(newTable,"margin-left")) ||
-        !DFStringEquals(CSSGet(oldTable,"margin-right"),CSSGet(newTable,"margin-right"))) {
+    if (!DFStringEquals(CSSGetID(oldTable,CSSPropertyMarginLeft),CSSGetID(newTable,CSSPropertyMarginLeft)) ||
+        !DFStringEquals(CSSGetID(oldTable,CSSPropertyMarginRight),CSSGetID(newTable,CSSPropertyMarginRight))) {
 
         const char *jc = NULL;
 
-        const char *newMarginLeft = CSSGet(newTable,"margin-left");
-        const char *newMarginRight = CSSGet(newTable,"margin-right");
+        const char *newMarginLeft = CSSGetID(newTable,CSSPropertyMarginLeft);
+        const char *newMarginRight = CSSGetID(newTable,CSSPropertyMarginRight);
 
         if (DFStringEquals(newMarginLeft,"0") && DFStringEquals(newMarginRight,"auto")) {
             jc = "left";
@@ -410,12 +410,12 @@ void WordPutTblPr(DFNode *concrete, CSSProperties *newTable, CSSProperties *newC
 
         // Only set tblInd if table is left justified (or unspecified)
         if ((jc == NULL) || DFStringEquals(jc,"left")) {
-            if (!DFStringEquals(CSSGet(oldTable,"margin-left"),CSSGet(newTable,"margin-left"))) {
+            if (!DFStringEquals(CSSGetID(oldTable,CSSPropertyMarginLeft),CSSGetID(newTable,CSSPropertyMarginLeft))) {
 
 
                 int haveTwips = 0;
                 int twips = 0;
-                CSSLength length = CSSLengthFromString(CSSGet(newTable,"margin-left"));
+                CSSLength length = CSSLengthFromString(CSSGetID(newTable,CSSPropertyMarginLeft));
                 if (CSSLengthIsValid(length) && (length.units == UnitsPct)) {
                     twips = (int)round((length.value/100.0)*WordSectionContentWidth(section));
                     haveTwips = 1;
@@ -504,9 +504,9 @@ void WordPutTcPr1(DFNode *concrete, CSSProperties *newp)
     CSSProperties *oldp = CSSPropertiesNew();
     WordGetTcPr(concrete,oldp);
 
-    if (!DFStringEquals(CSSGet(oldp,"width"),CSSGet(newp,"width"))) {
-        if (CSSGet(newp,"width") != NULL) {
-            CSSLength length = CSSLengthFromString(CSSGet(newp,"width"));
+    if (!DFStringEquals(CSSGetID(oldp,CSSPropertyWidth),CSSGetID(newp,CSSPropertyWidth))) {
+        if (CSSGetID(newp,CSSPropertyWidth) != NULL) {
+            CSSLength length = CSSLengthFromString(CSSGetID(newp,CSSPropertyWidth));
             if (length.units == UnitsPct) {
                 int pct50 = (int)round(length.value*50);
                 children[WORD_TCW] = DFCreateElement(concrete->doc,WORD_TCW);
@@ -522,8 +522,8 @@ void WordPutTcPr1(DFNode *concrete, CSSProperties *newp)
         }
     }
 
-    char *oldBackgroundColor = CSSHexColor(CSSGet(oldp,"background-color"),0);
-    char *newBackgroundColor = CSSHexColor(CSSGet(newp,"background-color"),0);
+    char *oldBackgroundColor = CSSHexColor(CSSGetID(oldp,CSSPropertyBackgroundColor),0);
+    char *newBackgroundColor = CSSHexColor(CSSGetID(newp,CSSPropertyBackgroundColor),0);
     if (!DFStringEquals(oldBackgroundColor,newBackgroundColor))
         WordPutShd(concrete->doc,&children[WORD_SHD],newBackgroundColor);
     free(oldBackgroundColor);
@@ -214,7 +214,7 @@ static DFNode *imageWithFilename(WordGetData *get, const char *filename, double
         double widthPct = widthPts/contentWidthPts*100.0;
         CSSProperties *properties = CSSPropertiesNew();
         char buf[100];
-        CSSPut(properties,"width",DFFormatDoublePct(buf,100,widthPct));
+        CSSPutID(properties,CSSPropertyWidth,DFFormatDoublePct(buf,100,widthPct));
         char *propertiesText = CSSPropertiesCopyDescription(properties);
         DFSetAttribute(imageNode,HTML_STYLE,propertiesText);
         free(propertiesText);
@@ -254,8 +254,8 @@ static ImageInfo *getImageInfoObject(DFNode *concrete)
         return NULL;;
 
     CSSProperties *imgProperties = CSSPropertiesNewWithString(cssText);
-    CSSLength width = CSSLengthFromString(CSSGet(imgProperties,"width"));
-    CSSLength height = CSSLengthFromString(CSSGet(imgProperties,"height"));
+    CSSLength width = CSSLengthFromString(CSSGetID(imgProperties,CSSPropertyWidth));
+    CSSLength height = CSSLengthFromString(CSSGetID(imgProperties,CSSPropertyHeight));
     CSSPropertiesRelease(imgProperties);
 
     if (!CSSLengthIsValid(width) || !CSSLengthIsAbsolute(width))
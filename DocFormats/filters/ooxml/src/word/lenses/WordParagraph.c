@@ -168,13 +168,13 @@ static void WordParagraphPut(WordPutData *put, DFNode *abstract, DFNode *concret
         // If both the level and paragraph have a margin-left property set, add the level's
         // margin-left to the paragraph's, since word treats the corresponding indentation property
         // as being absolute, not relative to the numbering level's indentation
-        CSSLength levelMarginLeft = CSSLengthFromString(CSSGet(levelProperties,"margin-left"));
-        CSSLength paragraphMarginLeft = CSSLengthFromString(CSSGet(paragraphProperties,"margin-left"));
+        CSSLength levelMarginLeft = CSSLengthFromString(CSSGetID(levelProperties,CSSPropertyMarginLeft));
+        CSSLength paragraphMarginLeft = CSSLengthFromString(CSSGetID(paragraphProperties,CSSPropertyMarginLeft));
         if (CSSLengthIsValid(levelMarginLeft) && (levelMarginLeft.units == UnitsPct) &&
             CSSLengthIsValid(paragraphMarginLeft) && (paragraphMarginLeft.units == UnitsPct)) {
             double newMarginLeft = levelMarginLeft.value + paragraphMarginLeft.value;
             char buf[100];
-            CSSPut(paragraphProperties,"margin-left",DFFormatDoublePct(buf,100,newMarginLeft));
+            CSSPutID(paragraphProperties,CSSPropertyMarginLeft,DFFormatDoublePct(buf,100,newMarginLeft));
             char *propertiesText = CSSPropertiesCopyDescription(paragraphProperties);
             DFSetAttribute(abstract,HTML_STYLE,propertiesText);
             free(propertiesText);
@@ -218,14 +218,14 @@ static void WordParagraphPut(WordPutData *put, DFNode *abstract, DFNode *concret
 
     if ((numId != NULL) && (ilvl != NULL)) {
         if (isListItem) {
-            CSSPut(properties,"-word-numId",numId);
-            CSSPut(properties,"-word-ilvl",ilvl);
+            CSSPutID(properties,CSSPropertyWordNumId,numId);
+            CSSPutID(properties,CSSPropertyWordIlvl,ilvl);
         }
         else {
             double indent = listDesiredIndent(put->conv,numId,ilvl);
             if (indent > 0) {
                 char buf[100];
-                CSSPut(properties,"margin-left",DFFormatDoublePct(buf,100,indent));
+                CSSPutID(properties,CSSPropertyMarginLeft,DFFormatDoublePct(buf,100,indent));
             }
         }
     }
@@ -287,14 +287,14 @@ static CellPadding getPadding(CSSSheet *styleSheet, WordStyle *wordStyle, CSSPro
     }
 
     if (style != NULL) {
-        paddingLeftStr = CSSGet(CSSStyleCell(style),"padding-left");
-        paddingRightStr = CSSGet(CSSStyleCell(style),"padding-right");
+        paddingLeftStr = CSSGetID(CSSStyleCell(style),CSSPropertyPaddingLeft);
+        paddingRightStr = CSSGetID(CSSStyleCell(style),CSSPropertyPaddingRight);
     }
 
-    if (CSSGet(cellProperties,"padding-left") != NULL)
-        paddingLeftStr = CSSGet(cellProperties,"padding-left");
-    if (CSSGet(cellProperties,"padding-right") != NULL)
-        paddingRightStr = CSSGet(cellProperties,"padding-right");;
+    if (CSSGetID(cellProperties,CSSPropertyPaddingLeft) != NULL)
+        paddingLeftStr = CSSGetID(cellProperties,CSSPropertyPaddingLeft);
+    if (CSSGetID(cellProperties,CSSPropertyPaddingRight) != NULL)
+        paddingRightStr = CSSGetID(cellProperties,CSSPropertyPaddingRight);;
 
     CellPadding padding;
     padding.leftPts = 0;
@@ -343,8 +343,8 @@ static DFNode *WordTblGet(WordGetData *get, DFNode *concrete)
     const char *cellWidthType = cellWidthTypeForTable(concrete);
     int autoWidth = DFStringEquals(cellWidthType,"auto");
 
-    if ((CSSGet(cinfo->tableProperties,"width") == NULL) && autoWidth) {
-        CSSPut(cinfo->tableProperties,"width",NULL);
+    if ((CSSGetID(cinfo->tableProperties,CSSPropertyWidth) == NULL) && autoWidth) {
+        CSSPutID(cinfo->tableProperties,CSSPropertyWidth,NULL);
     }
     else {
         // Determine column widths and table width
@@ -357,15 +357,15 @@ static DFNode *WordTblGet(WordGetData *get, DFNode *concrete)
             if (WordSectionContentWidth(get->conv->mainSection) > 0) {
                 double contentWidthPts = WordSectionContentWidth(get->conv->mainSection)/20.0;
                 tableWidthPct = 100.0*cinfo->totalWidthPts/contentWidthPts;
-                if (CSSGet(cinfo->tableProperties,"width") == NULL) {
+                if (CSSGetID(cinfo->tableProperties,CSSPropertyWidth) == NULL) {
                     char buf[100];
-                    CSSPut(cinfo->tableProperties,"width",DFFormatDoublePct(buf,100,tableWidthPct));
+                    CSSPutID(cinfo->tableProperties,CSSPropertyWidth,DFFormatDoublePct(buf,100,tableWidthPct));
                 }
             }
         }
 
-        if (CSSGet(cinfo->tableProperties,"width") == NULL)
-            CSSPut(cinfo->tableProperties,"width","100%");
+        if (CSSGetID(cinfo->tableProperties,CSSPropertyWidth) == NULL)
+            CSSPutID(cinfo->tableProperties,CSSPropertyWidth,"100%");
     }
 
     DFHashTable *collapsed = CSSCollapseProperties(cinfo->tableProperties);
@@ -493,8 +493,8 @@ static void WordTblPut(WordPutData *put, DFNode *abstract, DFNode *concrete)
     const char *newJc = DFGetChildAttribute(tblPr,WORD_JC,WORD_VAL);
 
     double tableWidthPct = 100;
-    if (CSSGet(tableProperties,"width") != NULL) {
-        CSSLength length = CSSLengthFromString(CSSGet(tableProperties,"width"));
+    if (CSSGetID(tableProperties,CSSPropertyWidth) != NULL) {
+        CSSLength length = CSSLengthFromString(CSSGetID(tableProperties,CSSPropertyWidth));
         if (CSSLengthIsValid(length) && (length.units == UnitsPct))
             tableWidthPct = length.value;
     }
@@ -559,7 +559,7 @@ static void WordTblPut(WordPutData *put, DFNode *abstract, DFNode *concrete)
                 for (unsigned int c = col; c < col + cell->colSpan; c++)
                     spannedWidthPct += DFTablePctWidthForCol(abstractStructure,c);
                 char buf[100];
-                CSSPut(innerCellProperties,"width",DFFormatDoublePct(buf,100,spannedWidthPct));
+                CSSPutID(innerCellProperties,CSSPropertyWidth,DFFormatDoublePct(buf,100,spannedWidthPct));
             }
 
             WordPutTcPr1(tcPr,innerCellProperties);
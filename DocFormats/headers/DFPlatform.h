@@ -54,6 +54,9 @@ struct DFDirEntryList {
 
 int DFMkdirIfAbsent(const char *path, char **errmsg);
 
+// Rename src to dest, replacing dest if it exists. If this fails, dest is left as it was.
+int DFReplaceFile(const char *src, const char *dest, char **errmsg);
+
 int DFAddDirContents(const char *absPath, const char *relPath, 
                      int recursive, DFDirEntryList ***list, 
                      char **errmsg);
@@ -62,12 +65,53 @@ int DFGetImageDimensions(const void *data, size_t len,
                          const char *ext, unsigned int *width, 
                          unsigned int *height, char **errmsg);
 
+// Reads the width and height of a PNG, JPEG, GIF, BMP, TIFF or WebP image from its header, without
+// decoding it. Returns 0 if the format is not recognised or the header is malformed, in which case
+// the image has to be decoded instead. DFGetImageDimensions tries this first.
+int DFextImageDimensions(const void *data, size_t len, unsigned int *width, unsigned int *height);
+
 #define DF_ONCE_INIT 0
 typedef int DFOnce;
 typedef void (*DFOnceFunction)(void);
 
+// Call fun, unless it has already been called with the same once. If another thread is calling it
+// at the same time, wait until it has finished.
 void DFInitOnce(DFOnce *once, DFOnceFunction fun);
 
+// A lock which can be held by only one thread at a time. It is not recursive.
+typedef struct DFMutex DFMutex;
+
+DFMutex *DFMutexNew(void);
+void DFMutexFree(DFMutex *mutex);
+void DFMutexLock(DFMutex *mutex);
+void DFMutexUnlock(DFMutex *mutex);
+
+// Atomically read *value, or add one to or subtract one from it, returning the new value
+int DFAtomicLoad(volatile int *value);
+int DFAtomicIncrement(volatile int *value);
+int DFAtomicDecrement(volatile int *value);
+
+// Atomically set *value to desired if it is equal to expected. Returns 1 if it was changed.
+int DFAtomicCompareExchange(volatile int *value, int expected, int desired);
+
+// Call fun for every index from 0 to count-1, using up to the given number of threads (including
+// the calling one). Returns once all calls have completed.
+typedef void (*DFParallelFunction)(void *ctx, int index);
+
+void DFRunParallel(int count, int threads, DFParallelFunction fun, void *ctx);
+
+// The number of processors available, or 1 if it cannot be determined
+int DFProcessorCount(void);
+
+// Seconds since an arbitrary fixed point, from a clock which is not affected by changes to the
+// system time. Only the difference between two values is meaningful.
+double DFCurrentTime(void);
+
+// Map an entire file read-only into memory. Returns NULL if the file cannot be mapped, or the
+// platform does not support it; callers are expected to fall back to stdio in that case.
+void *DFMapFile(const char *path, size_t *len);
+void DFUnmapFile(void *data, size_t len);
+
 // Zip functions
 typedef struct {
     int   compressedSize;    // File size on disk
@@ -83,18 +127,46 @@ typedef struct {
     int               zipFileCount;   // number of entries in array
     int               zipCreateMode;  // > 0 signals create mode, # is allocation of array
     DFextZipDirEntry *zipFileEntries; // array with filenames in zip
+    unsigned char    *zipData;        // read only mapping of zip file, NULL if read with stdio
+    size_t            zipDataSize;    // size of mapping
 } DFextZipHandle;
 typedef DFextZipHandle * DFextZipHandleP;
+typedef struct {
+    DFextZipDirEntry  entry;           // sizes, method and crc of the data written so far
+    unsigned char    *compressedData;  // deflated data
+    int               compressedAlloc; // allocation of compressedData
+    void             *zStream;         // zlib state, NULL once finished
+} DFextZipStream;
+typedef DFextZipStream * DFextZipStreamP;
+typedef int (*DFextZipReadFunction)(void *ctx, const void *buf, size_t len);
 
 
 DFextZipHandleP DFextZipOpen(const char *zipFilename);
 DFextZipHandleP DFextZipCreate(const char *zipFilename);
 
 unsigned char     *DFextZipReadFile(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry);
+const void        *DFextZipViewFile(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry);
+unsigned char    **DFextZipReadFiles(DFextZipHandleP zipHandle, int first, int count, int threads);
+int                DFextZipReadFileChunks(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry, DFextZipReadFunction fun, void *ctx);
 DFextZipDirEntryP  DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileName, const void *buf, const int len);
+DFextZipDirEntryP  DFextZipCopyFile(DFextZipHandleP zipHandle, DFextZipHandleP srcHandle, DFextZipDirEntryP srcEntry);
+
+// Streams compress data as it is produced, so the uncompressed contents of an entry never need
+// to be held in memory at once. A finished stream can be read back, or written to a zip file.
+DFextZipStreamP    DFextZipStreamNew(void);
+int                DFextZipStreamWrite(DFextZipStreamP stream, const void *buf, int len);
+int                DFextZipStreamFinish(DFextZipStreamP stream);
+unsigned char     *DFextZipStreamRead(DFextZipStreamP stream);
+int                DFextZipStreamReadChunks(DFextZipStreamP stream, DFextZipReadFunction fun, void *ctx);
+DFextZipDirEntryP  DFextZipWriteStream(DFextZipHandleP zipHandle, const char *fileName, DFextZipStreamP stream);
+void               DFextZipStreamFree(DFextZipStreamP stream);
 
 void DFextZipClose(DFextZipHandleP zipHandle);
 
+// Update a running CRC-32 (the same checksum zip entries record) with len more bytes. Pass 0 as
+// crc to start a new one.
+unsigned long      DFextZipCrc32(unsigned long crc, const void *buf, size_t len);
+
 
 
 
@@ -1076,6 +1076,9 @@ TIDY_EXPORT TidyAttr TIDY_CALL tidyAttrGetROWSPAN( TidyNode tnod );
 
 /** @} end AttrGet group */
 
+/* Pointer to the unescaped UTF-8 value of a text node, without copying it. The value is not
+   null-terminated, and remains valid until the document is released. */
+TIDY_EXPORT ctmbstr TIDY_CALL tidyNodeGetValuePtr( TidyDoc tdoc, TidyNode tnod, uint* len );
 TIDY_EXPORT void TIDY_CALL tidyDiscardContainer( TidyDoc tdoc, TidyNode tnod );
 TIDY_EXPORT void TIDY_CALL tidyDiscardElement( TidyDoc tdoc, TidyNode tnod );
 TIDY_EXPORT void TIDY_CALL tidyRemoveAttribute( TidyDoc tdoc, TidyNode tnod, TidyAttr tattr );
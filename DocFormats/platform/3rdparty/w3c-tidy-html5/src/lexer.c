@@ -751,7 +751,14 @@ void TY_(AddCharToLexer)( Lexer *lexer, uint c )
 {
     int i, err, count = 0;
     tmbchar buf[10] = {0};
-    
+
+    /* ASCII needs no encoding */
+    if ( c < 0x80 )
+    {
+        AddByte( lexer, (tmbchar) c );
+        return;
+    }
+
     err = TY_(EncodeCharToUTF8Bytes)( c, buf, NULL, &count );
     if (err)
     {
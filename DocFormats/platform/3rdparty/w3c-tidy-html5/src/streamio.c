@@ -1247,7 +1247,11 @@ static uint ReadCharFromStream( StreamIn* in )
         /* deal with UTF-8 encoded char */
 
         int err, count = 0;
-        
+
+        /* ASCII needs no decoding */
+        if ( c < 0x80 )
+            return c;
+
         /* first byte "c" is passed in separately */
         err = TY_(DecodeUTF8BytesToChar)( &n, c, NULL, &in->source, &count );
         if (!err && (n == (uint)EndOfStream) && (count == 1)) /* EOF */
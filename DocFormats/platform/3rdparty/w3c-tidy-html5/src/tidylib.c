@@ -1615,6 +1615,17 @@ Bool TIDY_CALL tidyNodeGetValue( TidyDoc tdoc, TidyNode tnod, TidyBuffer* buf )
     return yes;
 }
 
+ctmbstr TIDY_CALL tidyNodeGetValuePtr( TidyDoc tdoc, TidyNode tnod, uint* len )
+{
+    TidyDocImpl *doc = tidyDocToImpl( tdoc );
+    Node *node = tidyNodeToImpl( tnod );
+    *len = 0;
+    if ( doc == NULL || node == NULL || node->type != TextNode )
+        return NULL;
+    *len = node->end - node->start;
+    return doc->lexer->lexbuf + node->start;
+}
+
 Bool TIDY_CALL tidyNodeIsProp( TidyDoc ARG_UNUSED(tdoc), TidyNode tnod )
 {
   Node* nimp = tidyNodeToImpl( tnod );
@@ -26,6 +26,9 @@
 int DFGetImageDimensions(const void *data, size_t len, const char *ext,
                          unsigned int *width, unsigned int *height, char **errmsg)
 {
+    if (DFextImageDimensions(data,len,width,height))
+        return 1;
+
     // FIXME: Should use ext here to determine the UTI, and pass that in the options directory
     // (the second parameter to CGImageSourceCreateWithData)
 
@@ -27,6 +27,11 @@
 int DFGetImageDimensions(const void *data, size_t len, const char *ext,
                          unsigned int *width, unsigned int *height, char **errmsg)
 {
+    // Decoding the whole image just to find its size is slow, so only do that for formats we can't
+    // read the header of ourselves
+    if (DFextImageDimensions(data,len,width,height))
+        return 1;
+
     SDL_Surface *image = IMG_Load_RW(SDL_RWFromMem((void *)data,len),1);
     if (image == NULL) {
         if (errmsg != NULL)
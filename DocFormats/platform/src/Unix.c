@@ -28,21 +28,78 @@
 
 #include <pthread.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
 
-static int testAndSet(int *var, int value, pthread_mutex_t *lock)
-{
-    pthread_mutex_lock(lock);
-    int oldValue = *var;
-    *var = value;
-    pthread_mutex_unlock(lock);
-    return oldValue;
-}
+// A DFOnce is DF_ONCE_INIT (0) until the function is called, 1 while it is running, and 2 once it
+// has returned
 
 void DFInitOnce(DFOnce *once, DFOnceFunction fun)
 {
     static pthread_mutex_t onceLock = PTHREAD_MUTEX_INITIALIZER;
-    if (testAndSet(once,1,&onceLock) == 0)
+    static pthread_cond_t onceDone = PTHREAD_COND_INITIALIZER;
+    pthread_mutex_lock(&onceLock);
+    while (*once == 1)
+        pthread_cond_wait(&onceDone,&onceLock);
+    if (*once == 0) {
+        *once = 1;
+        pthread_mutex_unlock(&onceLock);
         fun();
+        pthread_mutex_lock(&onceLock);
+        *once = 2;
+        pthread_cond_broadcast(&onceDone);
+    }
+    pthread_mutex_unlock(&onceLock);
+}
+
+struct DFMutex {
+    pthread_mutex_t lock;
+};
+
+DFMutex *DFMutexNew(void)
+{
+    DFMutex *mutex = (DFMutex *)xmalloc(sizeof(DFMutex));
+    pthread_mutex_init(&mutex->lock,NULL);
+    return mutex;
+}
+
+void DFMutexFree(DFMutex *mutex)
+{
+    if (mutex == NULL)
+        return;
+    pthread_mutex_destroy(&mutex->lock);
+    free(mutex);
+}
+
+void DFMutexLock(DFMutex *mutex)
+{
+    pthread_mutex_lock(&mutex->lock);
+}
+
+void DFMutexUnlock(DFMutex *mutex)
+{
+    pthread_mutex_unlock(&mutex->lock);
+}
+
+int DFAtomicLoad(volatile int *value)
+{
+    return __atomic_load_n(value,__ATOMIC_ACQUIRE);
+}
+
+int DFAtomicIncrement(volatile int *value)
+{
+    return __atomic_add_fetch(value,1,__ATOMIC_ACQ_REL);
+}
+
+int DFAtomicDecrement(volatile int *value)
+{
+    return __atomic_sub_fetch(value,1,__ATOMIC_ACQ_REL);
+}
+
+int DFAtomicCompareExchange(volatile int *value, int expected, int desired)
+{
+    return __atomic_compare_exchange_n(value,&expected,desired,0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE);
 }
 
 int DFMkdirIfAbsent(const char *path, char **errmsg)
@@ -56,6 +113,17 @@ int DFMkdirIfAbsent(const char *path, char **errmsg)
     return 1;
 }
 
+int DFReplaceFile(const char *src, const char *dest, char **errmsg)
+{
+    // rename() replaces dest atomically, so there's no point at which neither file exists
+    if (rename(src,dest) != 0) {
+        if (errmsg != NULL)
+            *errmsg = xstrdup(strerror(errno));
+        return 0;
+    }
+    return 1;
+}
+
 int DFAddDirContents(const char *absPath, const char *relPath, int recursive, DFDirEntryList ***list, char **errmsg)
 {
     DFDirEntryList **listptr = *list;
@@ -108,4 +176,94 @@ int DFAddDirContents(const char *absPath, const char *relPath, int recursive, DF
     return ok;
 }
 
+void *DFMapFile(const char *path, size_t *len)
+{
+    int fd = open(path,O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    void *data = NULL;
+    struct stat statbuf;
+    if ((0 == fstat(fd,&statbuf)) && (statbuf.st_size > 0)) {
+        data = mmap(NULL,(size_t)statbuf.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+        if (data == MAP_FAILED)
+            data = NULL;
+        else
+            *len = (size_t)statbuf.st_size;
+    }
+
+    // The mapping remains valid after the descriptor is closed
+    close(fd);
+    return data;
+}
+
+void DFUnmapFile(void *data, size_t len)
+{
+    if (data != NULL)
+        munmap(data,len);
+}
+
+int DFProcessorCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 1) ? (int)count : 1;
+}
+
+double DFCurrentTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec/1e9;
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    int next;
+    int count;
+    DFParallelFunction fun;
+    void *ctx;
+} ParallelWork;
+
+static void *parallelWorker(void *arg)
+{
+    ParallelWork *work = (ParallelWork *)arg;
+    for (;;) {
+        pthread_mutex_lock(&work->lock);
+        int index = work->next++;
+        pthread_mutex_unlock(&work->lock);
+        if (index >= work->count)
+            break;
+        work->fun(work->ctx,index);
+    }
+    return NULL;
+}
+
+void DFRunParallel(int count, int threads, DFParallelFunction fun, void *ctx)
+{
+    ParallelWork work;
+    pthread_mutex_init(&work.lock,NULL);
+    work.next = 0;
+    work.count = count;
+    work.fun = fun;
+    work.ctx = ctx;
+
+    if (threads > count)
+        threads = count;
+
+    // The calling thread takes part as well, so we only need to start threads-1 others. If any of
+    // them cannot be started, the remaining ones just get more of the work.
+    pthread_t *ids = (pthread_t *)xcalloc(threads > 1 ? threads-1 : 1,sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; i < threads-1; i++) {
+        if (pthread_create(&ids[started],NULL,parallelWorker,&work) == 0)
+            started++;
+    }
+    parallelWorker(&work);
+    for (int i = 0; i < started; i++)
+        pthread_join(ids[i],NULL);
+
+    free(ids);
+    pthread_mutex_destroy(&work.lock);
+}
+
 #endif
@@ -24,6 +24,7 @@
 #include <windows.h>
 #include <SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 
 static void DFErrorMsgSetWin32(char **errmsg, DWORD code)
@@ -53,11 +54,15 @@ static void DFErrorMsgSetWin32(char **errmsg, DWORD code)
 
 HANDLE onceMutex = NULL;
 
-static int testAndSet(int *var,int value,HANDLE lock)
+// A DFOnce is DF_ONCE_INIT (0) until the function is called, 1 while it is running, and 2 once it
+// has returned
+
+static int onceState(int *var, int newValueIfInit, HANDLE lock)
 {
     WaitForSingleObject(lock,INFINITE);
     int oldValue = *var;
-    *var = value;
+    if (oldValue == 0)
+        *var = newValueIfInit;
     ReleaseMutex(lock);
     return oldValue;
 }
@@ -72,8 +77,68 @@ void DFInitOnce(DFOnce *once, DFOnceFunction fun)
 {
     static INIT_ONCE initOnce = INIT_ONCE_STATIC_INIT;
     InitOnceExecuteOnce(&initOnce,initOnceMutex,NULL,NULL);
-    if (testAndSet(once,1,onceMutex) == 0)
-        fun();
+    for (;;) {
+        int state = onceState(once,1,onceMutex);
+        if (state == 0) {
+            fun();
+            WaitForSingleObject(onceMutex,INFINITE);
+            *once = 2;
+            ReleaseMutex(onceMutex);
+            return;
+        }
+        if (state == 2)
+            return;
+        Sleep(0);
+    }
+}
+
+struct DFMutex {
+    CRITICAL_SECTION section;
+};
+
+DFMutex *DFMutexNew(void)
+{
+    DFMutex *mutex = (DFMutex *)xmalloc(sizeof(DFMutex));
+    InitializeCriticalSection(&mutex->section);
+    return mutex;
+}
+
+void DFMutexFree(DFMutex *mutex)
+{
+    if (mutex == NULL)
+        return;
+    DeleteCriticalSection(&mutex->section);
+    free(mutex);
+}
+
+void DFMutexLock(DFMutex *mutex)
+{
+    EnterCriticalSection(&mutex->section);
+}
+
+void DFMutexUnlock(DFMutex *mutex)
+{
+    LeaveCriticalSection(&mutex->section);
+}
+
+int DFAtomicLoad(volatile int *value)
+{
+    return (int)InterlockedCompareExchange((volatile LONG *)value,0,0);
+}
+
+int DFAtomicIncrement(volatile int *value)
+{
+    return (int)InterlockedIncrement((volatile LONG *)value);
+}
+
+int DFAtomicDecrement(volatile int *value)
+{
+    return (int)InterlockedDecrement((volatile LONG *)value);
+}
+
+int DFAtomicCompareExchange(volatile int *value, int expected, int desired)
+{
+    return (InterlockedCompareExchange((volatile LONG *)value,desired,expected) == expected);
 }
 
 int DFMkdirIfAbsent(const char *path, char **errmsg)
@@ -85,6 +150,15 @@ int DFMkdirIfAbsent(const char *path, char **errmsg)
     return 1;
 }
 
+int DFReplaceFile(const char *src, const char *dest, char **errmsg)
+{
+    if (!MoveFileEx(src,dest,MOVEFILE_REPLACE_EXISTING)) {
+        DFErrorMsgSetWin32(errmsg,GetLastError());
+        return 0;
+    }
+    return 1;
+}
+
 int DFAddDirContents(const char *absPath, const char *relPath, int recursive, DFDirEntryList ***list, char **errmsg)
 {
     DFDirEntryList **listptr = *list;
@@ -141,6 +215,11 @@ int DFAddDirContents(const char *absPath, const char *relPath, int recursive, DF
 int DFGetImageDimensions(const void *data, size_t len, const char *ext,
                          unsigned int *width, unsigned int *height, char **errmsg)
 {
+    // Decoding the whole image just to find its size is slow, so only do that for formats we can't
+    // read the header of ourselves
+    if (DFextImageDimensions(data,len,width,height))
+        return 1;
+
     SDL_Surface *image = IMG_Load_RW(SDL_RWFromMem((void *)data,(int)len),1);
     if (image == NULL) {
         if (errmsg != NULL)
@@ -154,4 +233,82 @@ int DFGetImageDimensions(const void *data, size_t len, const char *ext,
     return 1;
 }
 
+void *DFMapFile(const char *path, size_t *len)
+{
+    // Not supported yet; callers fall back to reading the file with stdio
+    return NULL;
+}
+
+void DFUnmapFile(void *data, size_t len)
+{
+}
+
+int DFProcessorCount(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 1) ? (int)info.dwNumberOfProcessors : 1;
+}
+
+double DFCurrentTime(void)
+{
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+}
+
+typedef struct {
+    volatile LONG next;
+    int count;
+    DFParallelFunction fun;
+    void *ctx;
+} ParallelWork;
+
+static DWORD WINAPI parallelWorker(LPVOID arg)
+{
+    ParallelWork *work = (ParallelWork *)arg;
+    for (;;) {
+        int index = (int)InterlockedIncrement(&work->next) - 1;
+        if (index >= work->count)
+            break;
+        work->fun(work->ctx,index);
+    }
+    return 0;
+}
+
+void DFRunParallel(int count, int threads, DFParallelFunction fun, void *ctx)
+{
+    ParallelWork work;
+    work.next = 0;
+    work.count = count;
+    work.fun = fun;
+    work.ctx = ctx;
+
+    if (threads > count)
+        threads = count;
+
+    // The calling thread takes part as well, so we only need to start threads-1 others
+    HANDLE *handles = (HANDLE *)xcalloc(threads > 1 ? threads-1 : 1,sizeof(HANDLE));
+    DWORD started = 0;
+    for (int i = 0; i < threads-1; i++) {
+        handles[started] = CreateThread(NULL,0,parallelWorker,&work,0,NULL);
+        if (handles[started] != NULL)
+            started++;
+    }
+    parallelWorker(&work);
+
+    // Wait for each thread individually, since WaitForMultipleObjects is limited to
+    // MAXIMUM_WAIT_OBJECTS handles. We can't return while any of them might still be using work.
+    for (DWORD i = 0; i < started; i++) {
+        if (WaitForSingleObject(handles[i],INFINITE) != WAIT_OBJECT_0) {
+            fprintf(stderr,"DFRunParallel: WaitForSingleObject failed (error %lu)\n",GetLastError());
+            abort();
+        }
+        CloseHandle(handles[i]);
+    }
+    free(handles);
+}
+
 #endif
@@ -0,0 +1,209 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "DFPlatform.h"
+
+// Image headers, read just far enough to find the dimensions. JPEG files need the most work, as
+// the frame header can come after any number of other marker segments.
+
+static uint32_t readBE16(const unsigned char *p) { return ((uint32_t)p[0] << 8) | p[1]; }
+static uint32_t readLE16(const unsigned char *p) { return ((uint32_t)p[1] << 8) | p[0]; }
+static uint32_t readBE32(const unsigned char *p) { return (readBE16(p) << 16) | readBE16(p+2); }
+static uint32_t readLE32(const unsigned char *p) { return (readLE16(p+2) << 16) | readLE16(p); }
+static uint32_t readLE24(const unsigned char *p) { return ((uint32_t)p[2] << 16) | readLE16(p); }
+
+static int pngDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    // The IHDR chunk is required to come first
+    if ((len < 24) || memcmp(d,"\x89PNG\r\n\x1a\n",8) || memcmp(&d[12],"IHDR",4))
+        return 0;
+    *w = readBE32(&d[16]);
+    *h = readBE32(&d[20]);
+    return 1;
+}
+
+static int gifDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    if ((len < 10) || (memcmp(d,"GIF87a",6) && memcmp(d,"GIF89a",6)))
+        return 0;
+    *w = readLE16(&d[6]);
+    *h = readLE16(&d[8]);
+    return 1;
+}
+
+static int bmpDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    if ((len < 26) || memcmp(d,"BM",2))
+        return 0;
+    uint32_t headerSize = readLE32(&d[14]);
+    if (headerSize == 12) {
+        // OS/2 BITMAPCOREHEADER, with 16-bit dimensions
+        *w = readLE16(&d[18]);
+        *h = readLE16(&d[20]);
+        return 1;
+    }
+    // Both fields are signed, and the height is negative for images stored top-down. It is negated
+    // as an unsigned value, as -2^31 has no positive int32_t equivalent; neither it nor a negative
+    // width is a valid size, so those are rejected.
+    uint32_t width = readLE32(&d[18]);
+    uint32_t height = readLE32(&d[22]);
+    if ((width > INT32_MAX) || (height == 0x80000000u))
+        return 0;
+    *w = width;
+    *h = (height > INT32_MAX) ? (0u - height) : height;
+    return 1;
+}
+
+static int jpegDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    if ((len < 4) || (d[0] != 0xFF) || (d[1] != 0xD8))
+        return 0;
+
+    size_t pos = 2;
+    while (pos + 4 <= len) {
+        if (d[pos] != 0xFF)
+            return 0;
+        unsigned char marker = d[pos+1];
+        if (marker == 0xFF) { // fill byte
+            pos++;
+            continue;
+        }
+        if ((marker == 0x01) || ((marker >= 0xD0) && (marker <= 0xD7))) { // no length
+            pos += 2;
+            continue;
+        }
+        if ((marker == 0xD9) || (marker == 0xDA)) // end of image, or start of scan
+            return 0;
+
+        uint32_t segmentLen = readBE16(&d[pos+2]);
+        if (segmentLen < 2)
+            return 0;
+
+        // SOF0-SOF15, except DHT (C4), JPG (C8) and DAC (CC), which share the range
+        if ((marker >= 0xC0) && (marker <= 0xCF) && (marker != 0xC4) && (marker != 0xC8) && (marker != 0xCC)) {
+            if ((segmentLen < 7) || (pos + 9 > len))
+                return 0;
+            *h = readBE16(&d[pos+5]);
+            *w = readBE16(&d[pos+7]);
+            return 1;
+        }
+        pos += 2 + segmentLen;
+    }
+    return 0;
+}
+
+static int tiffDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    if (len < 8)
+        return 0;
+
+    int little;
+    if (!memcmp(d,"II*\0",4))
+        little = 1;
+    else if (!memcmp(d,"MM\0*",4))
+        little = 0;
+    else
+        return 0;
+
+    uint32_t (*read16)(const unsigned char *) = little ? readLE16 : readBE16;
+    uint32_t (*read32)(const unsigned char *) = little ? readLE32 : readBE32;
+
+    // Only the first image file directory is examined
+    uint32_t ifd = read32(&d[4]);
+    if ((ifd > len) || (len - ifd < 2))
+        return 0;
+    uint32_t count = read16(&d[ifd]);
+    if ((len - ifd - 2)/12 < count)
+        return 0;
+
+    int found = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const unsigned char *entry = &d[ifd + 2 + 12*i];
+        uint32_t tag = read16(entry);
+        uint32_t type = read16(&entry[2]);
+        if ((tag != 256) && (tag != 257))
+            continue;
+
+        // ImageWidth and ImageLength may be either SHORT (3) or LONG (4)
+        uint32_t value;
+        if (type == 3)
+            value = read16(&entry[8]);
+        else if (type == 4)
+            value = read32(&entry[8]);
+        else
+            return 0;
+
+        if (tag == 256)
+            *w = value;
+        else
+            *h = value;
+        found |= (tag == 256) ? 1 : 2;
+    }
+    return (found == 3);
+}
+
+static int webpDimensions(const unsigned char *d, size_t len, uint32_t *w, uint32_t *h)
+{
+    if ((len < 30) || memcmp(d,"RIFF",4) || memcmp(&d[8],"WEBP",4))
+        return 0;
+
+    if (!memcmp(&d[12],"VP8 ",4)) {
+        // Lossy: a key frame header, with 14-bit dimensions
+        if (memcmp(&d[23],"\x9d\x01\x2a",3))
+            return 0;
+        *w = readLE16(&d[26]) & 0x3FFF;
+        *h = readLE16(&d[28]) & 0x3FFF;
+        return 1;
+    }
+    if (!memcmp(&d[12],"VP8L",4)) {
+        // Lossless: a signature byte, then 14-bit dimensions minus one, packed into four bytes
+        if (d[20] != 0x2F)
+            return 0;
+        uint32_t bits = readLE32(&d[21]);
+        *w = (bits & 0x3FFF) + 1;
+        *h = ((bits >> 14) & 0x3FFF) + 1;
+        return 1;
+    }
+    if (!memcmp(&d[12],"VP8X",4)) {
+        // Extended: 24-bit canvas dimensions minus one
+        *w = readLE24(&d[24]) + 1;
+        *h = readLE24(&d[27]) + 1;
+        return 1;
+    }
+    return 0;
+}
+
+int DFextImageDimensions(const void *data, size_t len, unsigned int *width, unsigned int *height)
+{
+    const unsigned char *d = (const unsigned char *)data;
+    uint32_t w = 0;
+    uint32_t h = 0;
+    if (!pngDimensions(d,len,&w,&h) &&
+        !jpegDimensions(d,len,&w,&h) &&
+        !gifDimensions(d,len,&w,&h) &&
+        !bmpDimensions(d,len,&w,&h) &&
+        !tiffDimensions(d,len,&w,&h) &&
+        !webpDimensions(d,len,&w,&h))
+        return 0;
+    if ((w == 0) || (h == 0))
+        return 0;
+    *width = w;
+    *height = h;
+    return 1;
+}
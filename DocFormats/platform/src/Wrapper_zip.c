@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <limits.h>
 #include "DFPlatform.h"
 #include "zlib.h"
 
@@ -75,6 +76,9 @@ typedef struct {
 } ZipFileHeader;
 #pragma pack()
 static const uint32_t ZipFileHeader_signature = 0x04034B50;
+
+// Amount of data handed out at once when reading an entry in chunks
+#define ZIP_CHUNK_SIZE 65536
 static const int FILECOUNT_ALLOC_SIZE = 5;
 
 
@@ -92,7 +96,7 @@ static int readDirectory(FILE *zipFile, DFextZipHandleP zipHandle)
 
     // find end of file, and calculate size
     if (fseek(zipFile, 0, SEEK_END)
-        || (fileSize = ftell(zipFile)) <= sizeof(ZipEndRecord))
+        || (fileSize = ftell(zipFile)) < sizeof(ZipEndRecord))
         return -1;
 
     // Read size of workBuf of filesize from end of file to locate EndRecord
@@ -110,7 +114,7 @@ static int readDirectory(FILE *zipFile, DFextZipHandleP zipHandle)
             // update zipHandle
             zipOffset                 = recEnd->centralDirectoryOffset;
             zipHandle->zipFileCount   = recEnd->numEntries;
-            zipHandle->zipFileEntries = xmalloc(zipHandle->zipFileCount * sizeof(DFextZipDirEntry));
+            zipHandle->zipFileEntries = xcalloc(zipHandle->zipFileCount, sizeof(DFextZipDirEntry));
             break;
         }
     }
@@ -161,6 +165,116 @@ static int readDirectory(FILE *zipFile, DFextZipHandleP zipHandle)
 
 
 
+static int readMappedDirectory(DFextZipHandleP zipHandle)
+{
+    const unsigned char *data = zipHandle->zipData;
+    size_t               size = zipHandle->zipDataSize;
+    size_t               pos, limit;
+    long                 i;
+
+
+    //***** Locate EndRecord *****
+    // Same as readDirectory, but the whole file is already in memory, so the
+    // search can cover the maximum comment length
+
+
+    if (size < sizeof(ZipEndRecord))
+        return -1;
+
+    limit = (size > 0xFFFF + sizeof(ZipEndRecord)) ? size - 0xFFFF - sizeof(ZipEndRecord) : 0;
+    for (i = size - sizeof(ZipEndRecord); i >= (long)limit; i--) {
+        const ZipEndRecord *recEnd = (const ZipEndRecord *)(data + i);
+
+        if (recEnd->signature == ZipEndRecord_signature) {
+            pos                       = recEnd->centralDirectoryOffset;
+            zipHandle->zipFileCount   = recEnd->numEntries;
+            zipHandle->zipFileEntries = xcalloc(zipHandle->zipFileCount, sizeof(DFextZipDirEntry));
+            break;
+        }
+    }
+    if (i < (long)limit)
+        return -1;
+
+
+    //***** Parse Directory in place *****
+
+
+    for (i = 0; i < zipHandle->zipFileCount; i++) {
+        const ZipDirectoryRecord *recDir   = (const ZipDirectoryRecord *)(data + pos);
+        DFextZipDirEntry         *dirEntry = &zipHandle->zipFileEntries[i];
+
+        if (pos + sizeof(ZipDirectoryRecord) > size
+            || recDir->signature != ZipDirectoryRecord_signature
+            || pos + sizeof(ZipDirectoryRecord) + recDir->fileNameLength > size)
+            return -1;
+
+        dirEntry->compressedSize    = recDir->compressedSize;
+        dirEntry->uncompressedSize  = recDir->uncompressedSize;
+        dirEntry->compressionMethod = recDir->compressionMethod;
+        dirEntry->offset            = recDir->relativeOffsetOflocalHeader;
+        dirEntry->crc32             = recDir->crc32;
+
+        // Add filename
+        dirEntry->fileName = xmalloc(recDir->fileNameLength + 1);
+        memcpy(dirEntry->fileName, data + pos + sizeof(ZipDirectoryRecord), recDir->fileNameLength);
+        dirEntry->fileName[recDir->fileNameLength] = '\0';
+
+        // Skip name, extra info and comment to get to next entry
+        pos += sizeof(ZipDirectoryRecord) + recDir->fileNameLength
+             + recDir->extraFieldLength + recDir->fileCommentLength;
+    }
+
+    return 0;
+}
+
+
+
+static const unsigned char *mappedEntryData(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry)
+{
+    const ZipFileHeader *recFile;
+    size_t               pos = zipEntry->offset;
+
+    // Locate the local header, and skip it to get at the data
+    if (pos + sizeof(ZipFileHeader) > zipHandle->zipDataSize)
+        return NULL;
+    recFile = (const ZipFileHeader *)(zipHandle->zipData + pos);
+    if (recFile->signature != ZipFileHeader_signature)
+        return NULL;
+
+    pos += sizeof(ZipFileHeader) + recFile->fileNameLength + recFile->extraFieldLength;
+    if (pos + (size_t)zipEntry->compressedSize > zipHandle->zipDataSize)
+        return NULL;
+    return zipHandle->zipData + pos;
+}
+
+
+
+static int inflateEntry(const unsigned char *comprData, DFextZipDirEntryP zipEntry, unsigned char *fileBuf)
+{
+    z_stream strm;
+    int      r;
+
+
+    strm.zalloc = Z_NULL;
+    strm.zfree = strm.opaque = strm.next_in = Z_NULL;
+    strm.avail_in = 0;
+
+    // Use inflateInit2 with negative window bits to indicate raw data
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+        return 0;
+
+    // and inflate data
+    strm.avail_in  = zipEntry->compressedSize;
+    strm.next_in   = (Bytef *)comprData;
+    strm.avail_out = zipEntry->uncompressedSize;
+    strm.next_out  = fileBuf;
+    r = inflate(&strm, Z_NO_FLUSH);
+    inflateEnd(&strm);
+    return r != Z_STREAM_ERROR;
+}
+
+
+
 static void releaseMemory(DFextZipHandleP zipHandle) {
     if (zipHandle) {
         int count = zipHandle->zipCreateMode ? zipHandle->zipCreateMode : zipHandle->zipFileCount;
@@ -172,6 +286,7 @@ static void releaseMemory(DFextZipHandleP zipHandle) {
             }
             free(zipHandle->zipFileEntries);
         }
+        DFUnmapFile(zipHandle->zipData, zipHandle->zipDataSize);
         free(zipHandle);
     }
 }
@@ -225,12 +340,25 @@ static void writeGlobalDirAndEndRecord(DFextZipHandleP zipHandle) {
 DFextZipHandleP DFextZipOpen(const char *zipFilename) {
     DFextZipHandleP zipHandle = xmalloc(sizeof(DFextZipHandle));
 
-    // open zip file for reading
     zipHandle->zipCreateMode = zipHandle->zipFileCount = 0;
-    zipHandle->zipFile       = fopen(zipFilename, "rb");
-    if (zipHandle->zipFile
-        && !readDirectory(zipHandle->zipFile, zipHandle))
-        return zipHandle;
+    zipHandle->zipFile       = NULL;
+    zipHandle->zipFileEntries = NULL;
+
+    // prefer a mapping of the file, avoiding a read for every record and entry
+    zipHandle->zipData = DFMapFile(zipFilename, &zipHandle->zipDataSize);
+    if (zipHandle->zipData) {
+        if (!readMappedDirectory(zipHandle))
+            return zipHandle;
+    }
+    else {
+        // open zip file for reading
+        zipHandle->zipFile = fopen(zipFilename, "rb");
+        if (zipHandle->zipFile
+            && !readDirectory(zipHandle->zipFile, zipHandle))
+            return zipHandle;
+        if (zipHandle->zipFile)
+            fclose(zipHandle->zipFile);
+    }
 
     // release memory
     releaseMemory(zipHandle);
@@ -238,72 +366,232 @@ DFextZipHandleP DFextZipOpen(const char *zipFilename) {
 }
 
 
-unsigned char *DFextZipReadFile(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry) {
+static unsigned char *decodeEntry(const unsigned char *comprData, DFextZipDirEntryP zipEntry) {
     unsigned char *fileBuf = xmalloc(zipEntry->uncompressedSize);
-    ZipFileHeader  recFile;
-    z_stream       strm;
+    int            ok;
 
+    // interesting a zip file that is uncompressed, have to handle that
+    if (zipEntry->compressionMethod != Z_DEFLATED) {
+        ok = zipEntry->uncompressedSize <= zipEntry->compressedSize;
+        if (ok)
+            memcpy(fileBuf, comprData, zipEntry->uncompressedSize);
+    }
+    else
+        ok = inflateEntry(comprData, zipEntry, fileBuf);
 
-    // Position in front of file
-    if (fseek(zipHandle->zipFile, zipEntry->offset, SEEK_SET)
-        || fread(&recFile, 1, sizeof(ZipFileHeader), zipHandle->zipFile) < sizeof(ZipFileHeader)
-        || recFile.signature != ZipFileHeader_signature
-        || fseek(zipHandle->zipFile, recFile.extraFieldLength + recFile.fileNameLength, SEEK_CUR)) {
+    if (!ok) {
         free(fileBuf);
         return NULL;
     }
+    return fileBuf;
+}
 
-    // interesting a zip file that is uncompressed, have to handle that
-    if (zipEntry->compressionMethod != Z_DEFLATED) {
-        if (fread(fileBuf, 1, zipEntry->uncompressedSize, zipHandle->zipFile) < (unsigned long)zipEntry->uncompressedSize
-            || ferror(zipHandle->zipFile)) {
-            free(fileBuf);
-            fileBuf = NULL;
-        }
-        return fileBuf;
-    }
 
 
-    //***** Handle zlib inflate *****
+static int seekEntryData(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry) {
+    ZipFileHeader recFile;
 
+    // Position in front of file
+    return !fseek(zipHandle->zipFile, zipEntry->offset, SEEK_SET)
+        && fread(&recFile, 1, sizeof(ZipFileHeader), zipHandle->zipFile) == sizeof(ZipFileHeader)
+        && recFile.signature == ZipFileHeader_signature
+        && !fseek(zipHandle->zipFile, recFile.extraFieldLength + recFile.fileNameLength, SEEK_CUR);
+}
 
-    strm.zalloc = Z_NULL;
-    strm.zfree = strm.opaque = strm.next_in = Z_NULL;
-    strm.avail_in = 0;
 
-    // Use inflateInit2 with negative window bits to indicate raw data
-    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
-        free(fileBuf);
+
+static unsigned char *readCompressed(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry) {
+    unsigned char *comprBuf;
+
+    if (!seekEntryData(zipHandle, zipEntry))
         return NULL;
-    }
 
     // Read compressed data
-    unsigned char *comprBuf = xmalloc(zipEntry->compressedSize);
+    comprBuf = xmalloc(zipEntry->compressedSize);
     if (fread(comprBuf, 1, zipEntry->compressedSize, zipHandle->zipFile) < (unsigned long)zipEntry->compressedSize
         || ferror(zipHandle->zipFile)) {
-        free(fileBuf);
         free(comprBuf);
         return NULL;
     }
+    return comprBuf;
+}
 
-    // and inflate data
-    strm.avail_in  = zipEntry->compressedSize;
-    strm.next_in   = comprBuf;
-    strm.avail_out = zipEntry->uncompressedSize;
-    strm.next_out  = fileBuf;
-    if (inflate(&strm, Z_NO_FLUSH) == Z_STREAM_ERROR) {
-        free(fileBuf);
-        free(comprBuf);
-        return NULL;
+
+
+unsigned char *DFextZipReadFile(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry) {
+    const unsigned char *comprData;
+    unsigned char       *comprBuf;
+    unsigned char       *fileBuf;
+
+
+    // a mapped file can be inflated directly, without reading the compressed data first
+    if (zipHandle->zipData) {
+        comprData = mappedEntryData(zipHandle, zipEntry);
+        return comprData ? decodeEntry(comprData, zipEntry) : NULL;
     }
 
+    if ((comprBuf = readCompressed(zipHandle, zipEntry)) == NULL)
+        return NULL;
+    fileBuf = decodeEntry(comprBuf, zipEntry);
     free(comprBuf);
-    inflateEnd(&strm);
     return fileBuf;
 }
 
 
 
+typedef struct {
+    DFextZipDirEntryP     entries;
+    const unsigned char **comprData;
+    unsigned char       **fileBufs;
+} ReadFilesWork;
+
+static void readFilesEntry(void *ctx, int index) {
+    ReadFilesWork *work = (ReadFilesWork *)ctx;
+
+    if (work->comprData[index])
+        work->fileBufs[index] = decodeEntry(work->comprData[index], &work->entries[index]);
+}
+
+
+
+unsigned char **DFextZipReadFiles(DFextZipHandleP zipHandle, int first, int count, int threads) {
+    ReadFilesWork work;
+    int           i;
+
+    // Locating the compressed data needs the file, and is done up front. Decoding the entries
+    // is independent, and is shared between the threads
+    work.entries   = &zipHandle->zipFileEntries[first];
+    work.comprData = xcalloc(count, sizeof(unsigned char *));
+    work.fileBufs  = xcalloc(count, sizeof(unsigned char *));
+    for (i = 0; i < count; i++) {
+        if (zipHandle->zipData)
+            work.comprData[i] = mappedEntryData(zipHandle, &work.entries[i]);
+        else
+            work.comprData[i] = readCompressed(zipHandle, &work.entries[i]);
+    }
+
+    DFRunParallel(count, threads, readFilesEntry, &work);
+
+    if (!zipHandle->zipData) {
+        for (i = 0; i < count; i++)
+            free((void *)work.comprData[i]);
+    }
+    free(work.comprData);
+    return work.fileBufs;
+}
+
+
+
+// Hands the contents of an entry to fun, one chunk at a time. The compressed data is taken from
+// comprData if given, or else read from file, which must be positioned at the start of the data.
+static int readChunks(FILE *file, const unsigned char *comprData, DFextZipDirEntryP zipEntry,
+                      DFextZipReadFunction fun, void *ctx) {
+    unsigned char *inBuf   = NULL;
+    unsigned char *outBuf  = NULL;
+    unsigned long  inLeft  = zipEntry->compressedSize;
+    unsigned long  outLeft = zipEntry->uncompressedSize;
+    unsigned long  len;
+    int            ok = 0;
+    z_stream       strm;
+
+
+    if (!comprData)
+        inBuf = xmalloc(ZIP_CHUNK_SIZE);
+
+    // stored data is passed on as it is read
+    if (zipEntry->compressionMethod != Z_DEFLATED) {
+        if (outLeft > inLeft)
+            goto end;
+        while (outLeft > 0) {
+            len = (outLeft < ZIP_CHUNK_SIZE) ? outLeft : ZIP_CHUNK_SIZE;
+            if (comprData) {
+                if (!fun(ctx, comprData, len))
+                    goto end;
+                comprData += len;
+            }
+            else if (fread(inBuf, 1, len, file) < len || !fun(ctx, inBuf, len))
+                goto end;
+            outLeft -= len;
+        }
+        ok = 1;
+        goto end;
+    }
+
+    // Use inflateInit2 with negative window bits to indicate raw data
+    strm.zalloc = Z_NULL;
+    strm.zfree = strm.opaque = strm.next_in = Z_NULL;
+    strm.avail_in = 0;
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+        goto end;
+    outBuf = xmalloc(ZIP_CHUNK_SIZE);
+
+    while (outLeft > 0) {
+        // refill the input, all at once if it is in memory
+        if (strm.avail_in == 0 && inLeft > 0) {
+            if (comprData) {
+                strm.next_in = (Bytef *)comprData;
+                len          = inLeft;
+            }
+            else {
+                len = (inLeft < ZIP_CHUNK_SIZE) ? inLeft : ZIP_CHUNK_SIZE;
+                if (fread(inBuf, 1, len, file) < len)
+                    break;
+                strm.next_in = inBuf;
+            }
+            strm.avail_in = len;
+            inLeft       -= len;
+        }
+
+        strm.next_out  = outBuf;
+        strm.avail_out = (outLeft < ZIP_CHUNK_SIZE) ? outLeft : ZIP_CHUNK_SIZE;
+        int r = inflate(&strm, Z_NO_FLUSH);
+        if (r != Z_OK && r != Z_STREAM_END && r != Z_BUF_ERROR)
+            break;
+
+        len = strm.next_out - outBuf;
+        if (len > 0 && !fun(ctx, outBuf, len))
+            break;
+        outLeft -= len;
+
+        // stop if the data ends early
+        if ((r == Z_STREAM_END || (len == 0 && strm.avail_in == 0 && inLeft == 0)) && outLeft > 0)
+            break;
+    }
+    ok = (outLeft == 0);
+    inflateEnd(&strm);
+
+end:
+    free(inBuf);
+    free(outBuf);
+    return ok;
+}
+
+
+
+int DFextZipReadFileChunks(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry, DFextZipReadFunction fun, void *ctx) {
+    if (zipHandle->zipData) {
+        const unsigned char *comprData = mappedEntryData(zipHandle, zipEntry);
+        return comprData && readChunks(NULL, comprData, zipEntry, fun, ctx);
+    }
+
+    return seekEntryData(zipHandle, zipEntry)
+        && readChunks(zipHandle->zipFile, NULL, zipEntry, fun, ctx);
+}
+
+
+
+const void *DFextZipViewFile(DFextZipHandleP zipHandle, DFextZipDirEntryP zipEntry) {
+    // only stored entries of a mapped file can be handed out without a copy
+    if (!zipHandle->zipData
+        || zipEntry->compressionMethod != 0
+        || zipEntry->uncompressedSize != zipEntry->compressedSize)
+        return NULL;
+
+    return mappedEntryData(zipHandle, zipEntry);
+}
+
+
+
 DFextZipHandleP DFextZipCreate(const char *zipFilename) {
     DFextZipHandleP zipHandle = xmalloc(sizeof(DFextZipHandle));
     int             memSize;
@@ -314,6 +602,8 @@ DFextZipHandleP DFextZipCreate(const char *zipFilename) {
     }
 
     // prepare to add files
+    zipHandle->zipData        = NULL;
+    zipHandle->zipDataSize    = 0;
     zipHandle->zipFileCount   = 0;
     zipHandle->zipCreateMode  = FILECOUNT_ALLOC_SIZE;
     memSize                   = zipHandle->zipCreateMode * sizeof(DFextZipDirEntry);
@@ -325,12 +615,7 @@ DFextZipHandleP DFextZipCreate(const char *zipFilename) {
 
 
 
-DFextZipDirEntryP DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileName, const void *buf, const int len) {
-    z_stream       strm;
-    unsigned char *outbuf;
-    ZipFileHeader  header;
-    int            fileNameLength = strlen(fileName);
-
+static DFextZipDirEntryP addEntry(DFextZipHandleP zipHandle, const char *fileName) {
     // do we have space for one more entry ?
     if (zipHandle->zipFileCount >= zipHandle->zipCreateMode) {
         zipHandle->zipCreateMode += FILECOUNT_ALLOC_SIZE;
@@ -338,17 +623,48 @@ DFextZipDirEntryP DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileN
         bzero(&zipHandle->zipFileEntries[zipHandle->zipFileCount], FILECOUNT_ALLOC_SIZE * sizeof(DFextZipDirEntry));
     }
 
+    // prepare global file entry, the caller fills in sizes and crc
+    DFextZipDirEntryP entryPtr = &zipHandle->zipFileEntries[zipHandle->zipFileCount++];
+    entryPtr->offset           = ftell(zipHandle->zipFile);
+    entryPtr->fileName         = xstrdup(fileName);
+    return entryPtr;
+}
+
+
+
+static void writeLocalHeader(DFextZipHandleP zipHandle, DFextZipDirEntryP entryPtr) {
+    ZipFileHeader header;
+    int           fileNameLength = strlen(entryPtr->fileName);
+
+    // sizes and crc always come from the global entry, so a data descriptor is never needed
+    header.versionNeededToExtract = 20;
+    header.generalPurposeBitFlag  = 0;
+    header.lastModFileDate        = 32;
+    header.lastModFileTime        = header.extraFieldLength = 0;
+    header.signature              = ZipFileHeader_signature;
+    header.compressionMethod      = entryPtr->compressionMethod;
+    header.compressedSize         = entryPtr->compressedSize;
+    header.uncompressedSize       = entryPtr->uncompressedSize;
+    header.fileNameLength         = fileNameLength;
+    header.crc32                  = entryPtr->crc32;
+
+    fwrite(&header,            1, sizeof(header), zipHandle->zipFile);
+    fwrite(entryPtr->fileName, 1, fileNameLength, zipHandle->zipFile);
+}
+
+
+
+DFextZipDirEntryP DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileName, const void *buf, const int len) {
+    z_stream       strm;
+    unsigned char *outbuf;
+
     // prepare local and global file entry
-    DFextZipDirEntryP entryPtr  = &zipHandle->zipFileEntries[zipHandle->zipFileCount++];
-    entryPtr->offset            = ftell(zipHandle->zipFile);
+    DFextZipDirEntryP entryPtr  = addEntry(zipHandle, fileName);
     entryPtr->uncompressedSize  = len;
-    entryPtr->fileName          = xmalloc(fileNameLength + 1);
     entryPtr->compressionMethod = Z_DEFLATED;
     entryPtr->crc32             = crc32(0L, Z_NULL, 0);
     entryPtr->crc32             = crc32(entryPtr->crc32, buf, len);
 
-    strcpy(entryPtr->fileName, fileName);
-
     // prepare to deflate
     strm.zalloc = Z_NULL;
     strm.zfree  = strm.opaque = Z_NULL;
@@ -368,22 +684,9 @@ DFextZipDirEntryP DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileN
     deflateEnd(&strm);
     entryPtr->compressedSize = strm.total_out;
 
-    // prepare local header
-    header.versionNeededToExtract = 20;
-    header.generalPurposeBitFlag  = 0;
-    header.lastModFileDate        = 32;
-    header.lastModFileTime        = header.extraFieldLength = header.crc32 = 0;
-    header.signature              = ZipFileHeader_signature;
-    header.compressionMethod      = entryPtr->compressionMethod;
-    header.compressedSize         = entryPtr->compressedSize;
-    header.uncompressedSize       = entryPtr->uncompressedSize;
-    header.fileNameLength         = fileNameLength;
-    header.crc32                  = entryPtr->crc32;
-
     // put data to file
-    fwrite(&header,            1, sizeof(header),        zipHandle->zipFile);
-    fwrite(entryPtr->fileName, 1, fileNameLength,        zipHandle->zipFile);
-    fwrite(outbuf,             1, header.compressedSize, zipHandle->zipFile); // skip CMD bytes in front
+    writeLocalHeader(zipHandle, entryPtr);
+    fwrite(outbuf, 1, entryPtr->compressedSize, zipHandle->zipFile);
 
     // cleanup
     free(outbuf);
@@ -392,11 +695,194 @@ DFextZipDirEntryP DFextZipWriteFile(DFextZipHandleP zipHandle, const char *fileN
 
 
 
+DFextZipDirEntryP DFextZipCopyFile(DFextZipHandleP zipHandle, DFextZipHandleP srcHandle, DFextZipDirEntryP srcEntry) {
+    ZipFileHeader        header;
+    unsigned char        copyBuf[4096];
+    long                 remaining;
+    const unsigned char *mapped = NULL;
+
+    // Position in front of the compressed data of the source entry
+    if (srcHandle->zipData) {
+        if ((mapped = mappedEntryData(srcHandle, srcEntry)) == NULL)
+            return NULL;
+    }
+    else if (fseek(srcHandle->zipFile, srcEntry->offset, SEEK_SET)
+        || fread(&header, 1, sizeof(ZipFileHeader), srcHandle->zipFile) < sizeof(ZipFileHeader)
+        || header.signature != ZipFileHeader_signature
+        || fseek(srcHandle->zipFile, header.extraFieldLength + header.fileNameLength, SEEK_CUR))
+        return NULL;
+
+    // the global entry is taken over as is, only the position changes. Should the source archive
+    // use a data descriptor, it is dropped, as the local header gets the values from the directory
+    DFextZipDirEntryP entryPtr  = addEntry(zipHandle, srcEntry->fileName);
+    entryPtr->uncompressedSize  = srcEntry->uncompressedSize;
+    entryPtr->compressedSize    = srcEntry->compressedSize;
+    entryPtr->compressionMethod = srcEntry->compressionMethod;
+    entryPtr->crc32             = srcEntry->crc32;
+    writeLocalHeader(zipHandle, entryPtr);
+
+    // copy compressed data without touching it
+    if (mapped)
+        return (fwrite(mapped, 1, entryPtr->compressedSize, zipHandle->zipFile) < (size_t)entryPtr->compressedSize) ? NULL : entryPtr;
+
+    for (remaining = entryPtr->compressedSize; remaining > 0; ) {
+        size_t chunk = (remaining < (long)sizeof(copyBuf)) ? (size_t)remaining : sizeof(copyBuf);
+        if (fread(copyBuf, 1, chunk, srcHandle->zipFile) < chunk
+            || fwrite(copyBuf, 1, chunk, zipHandle->zipFile) < chunk)
+            return NULL;
+        remaining -= chunk;
+    }
+    return entryPtr;
+}
+
+
+
+DFextZipStreamP DFextZipStreamNew(void) {
+    DFextZipStreamP stream = xcalloc(1, sizeof(DFextZipStream));
+    z_stream       *strm   = xcalloc(1, sizeof(z_stream));
+
+    strm->zalloc = Z_NULL;
+    strm->zfree  = strm->opaque = Z_NULL;
+    if (deflateInit2(strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        free(strm);
+        free(stream);
+        return NULL;
+    }
+
+    stream->zStream                 = strm;
+    stream->entry.compressionMethod = Z_DEFLATED;
+    stream->entry.crc32             = crc32(0L, Z_NULL, 0);
+    return stream;
+}
+
+
+
+static int streamDeflate(DFextZipStreamP stream, const void *buf, int len, int flush) {
+    z_stream *strm = stream->zStream;
+    int       r;
+
+    strm->next_in  = (Bytef *)buf;
+    strm->avail_in = len;
+    do {
+        // grow output buffer when full, compressed data is normally a fraction of the input
+        if (stream->entry.compressedSize == stream->compressedAlloc) {
+            stream->compressedAlloc = stream->compressedAlloc ? 2 * stream->compressedAlloc : 16384;
+            stream->compressedData  = xrealloc(stream->compressedData, stream->compressedAlloc);
+        }
+        strm->next_out  = stream->compressedData + stream->entry.compressedSize;
+        strm->avail_out = stream->compressedAlloc - stream->entry.compressedSize;
+        r = deflate(strm, flush);
+        if (r == Z_STREAM_ERROR)
+            return 0;
+        stream->entry.compressedSize = strm->total_out;
+    } while (strm->avail_out == 0 || (flush == Z_FINISH && r != Z_STREAM_END));
+    return 1;
+}
+
+
+
+int DFextZipStreamWrite(DFextZipStreamP stream, const void *buf, int len) {
+    if (stream->zStream == NULL)
+        return 0;
+
+    // Entry sizes are stored as ints, and we don't write zip64 archives
+    if ((len < 0) || (len > INT_MAX - stream->entry.uncompressedSize))
+        return 0;
+
+    stream->entry.uncompressedSize += len;
+    stream->entry.crc32             = crc32(stream->entry.crc32, buf, len);
+    return streamDeflate(stream, buf, len, Z_NO_FLUSH);
+}
+
+
+
+int DFextZipStreamFinish(DFextZipStreamP stream) {
+    int ok;
+
+    if (stream->zStream == NULL)
+        return 1;
+
+    ok = streamDeflate(stream, NULL, 0, Z_FINISH);
+    deflateEnd(stream->zStream);
+    free(stream->zStream);
+    stream->zStream = NULL;
+    return ok;
+}
+
+
+
+unsigned char *DFextZipStreamRead(DFextZipStreamP stream) {
+    unsigned char *fileBuf = xmalloc(stream->entry.uncompressedSize);
+
+    if (stream->zStream != NULL || !inflateEntry(stream->compressedData, &stream->entry, fileBuf)) {
+        free(fileBuf);
+        return NULL;
+    }
+    return fileBuf;
+}
+
+
+
+int DFextZipStreamReadChunks(DFextZipStreamP stream, DFextZipReadFunction fun, void *ctx) {
+    return stream->zStream == NULL
+        && readChunks(NULL, stream->compressedData, &stream->entry, fun, ctx);
+}
+
+
+
+DFextZipDirEntryP DFextZipWriteStream(DFextZipHandleP zipHandle, const char *fileName, DFextZipStreamP stream) {
+    if (stream->zStream != NULL)
+        return NULL;
+
+    DFextZipDirEntryP entryPtr  = addEntry(zipHandle, fileName);
+    entryPtr->uncompressedSize  = stream->entry.uncompressedSize;
+    entryPtr->compressedSize    = stream->entry.compressedSize;
+    entryPtr->compressionMethod = stream->entry.compressionMethod;
+    entryPtr->crc32             = stream->entry.crc32;
+    writeLocalHeader(zipHandle, entryPtr);
+
+    if (fwrite(stream->compressedData, 1, entryPtr->compressedSize, zipHandle->zipFile) < (size_t)entryPtr->compressedSize)
+        return NULL;
+    return entryPtr;
+}
+
+
+
+void DFextZipStreamFree(DFextZipStreamP stream) {
+    if (stream == NULL)
+        return;
+
+    if (stream->zStream != NULL) {
+        deflateEnd(stream->zStream);
+        free(stream->zStream);
+    }
+    free(stream->compressedData);
+    free(stream);
+}
+
+
+
 void DFextZipClose(DFextZipHandleP zipHandle)
 {
     if (zipHandle->zipCreateMode)
         writeGlobalDirAndEndRecord(zipHandle);
 
-    fclose(zipHandle->zipFile);
+    if (zipHandle->zipFile)
+        fclose(zipHandle->zipFile);
     releaseMemory(zipHandle);
 }
+
+
+
+unsigned long DFextZipCrc32(unsigned long crc, const void *buf, size_t len)
+{
+    // zlib takes the length as an unsigned int, so very large buffers are passed in pieces
+    const unsigned char *bytes = buf;
+    while (len > 0) {
+        uInt n = (len > 0x40000000) ? 0x40000000 : (uInt)len;
+        crc = crc32(crc, bytes, n);
+        bytes += n;
+        len -= n;
+    }
+    return crc;
+}
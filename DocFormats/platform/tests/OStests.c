@@ -19,6 +19,7 @@
 #include "DFPlatform.h"
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void test_DFGetImageDimensions_gif(void)
 {
@@ -131,6 +132,50 @@ static void test_DFGetImageDimensions_png(void)
 }
 
 
+static void test_DFextImageDimensions(void)
+{
+    // Just the headers, as only those are read. Bitmap 333x77
+    static unsigned char data_bmp[] = {
+        0x42, 0x4D, 0xFE, 0x2C, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x28, 0x00,
+        0x00, 0x00, 0x4D, 0x01, 0x00, 0x00, 0x4D, 0x00, 0x00, 0x00 };
+    // Lossless WebP 17x10
+    static unsigned char data_webp[] = {
+        0x52, 0x49, 0x46, 0x46, 0x1E, 0x00, 0x00, 0x00, 0x57, 0x45, 0x42, 0x50, 0x56, 0x50, 0x38, 0x4C,
+        0x11, 0x00, 0x00, 0x00, 0x2F, 0x10, 0x40, 0x02, 0x00, 0x07, 0x50, 0x8A, 0x2A, 0xD4 };
+    // Big-endian TIFF 300x200, with the width as a SHORT and the height as a LONG
+    static unsigned char data_tiff[] = {
+        0x4D, 0x4D, 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08, 0x00, 0x02, 0x01, 0x00, 0x00, 0x03, 0x00, 0x00,
+        0x00, 0x01, 0x01, 0x2C, 0x00, 0x00, 0x01, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+        0x00, 0xC8, 0x00, 0x00, 0x00, 0x00 };
+
+    unsigned int width = 0, height = 0;
+
+    utassert(DFextImageDimensions(data_bmp, sizeof(data_bmp), &width, &height), "bmp not read");
+    utassert((width == 333) && (height == 77), "wrong bmp dimensions");
+
+    // Top-down, with a negative height
+    unsigned char data_bmp_topdown[sizeof(data_bmp)];
+    memcpy(data_bmp_topdown, data_bmp, sizeof(data_bmp));
+    memcpy(&data_bmp_topdown[22], "\xB3\xFF\xFF\xFF", 4);
+    utassert(DFextImageDimensions(data_bmp_topdown, sizeof(data_bmp), &width, &height), "top-down bmp not read");
+    utassert((width == 333) && (height == 77), "wrong top-down bmp dimensions");
+
+    // A height of -2^31 is not valid
+    memcpy(&data_bmp_topdown[22], "\x00\x00\x00\x80", 4);
+    utassert(!DFextImageDimensions(data_bmp_topdown, sizeof(data_bmp), &width, &height), "bmp with height -2^31 read");
+
+    utassert(DFextImageDimensions(data_webp, sizeof(data_webp), &width, &height), "webp not read");
+    utassert((width == 17) && (height == 10), "wrong webp dimensions");
+
+    utassert(DFextImageDimensions(data_tiff, sizeof(data_tiff), &width, &height), "tiff not read");
+    utassert((width == 300) && (height == 200), "wrong tiff dimensions");
+
+    // Truncated headers are left for the platform's decoder to reject
+    utassert(!DFextImageDimensions(data_tiff, 20, &width, &height), "truncated tiff read");
+    utassert(!DFextImageDimensions("not an image", 12, &width, &height), "unknown format read");
+}
+
+
 static int testOnceCount;
 static void testOnce(void)
 {
@@ -192,6 +237,7 @@ TestGroup PlatformOSTests = {
         { "DFGetImageDimensions (gif)", PlainTest, test_DFGetImageDimensions_gif },
         { "DFGetImageDimensions (jpg)", PlainTest, test_DFGetImageDimensions_jpg },
         { "DFGetImageDimensions (png)", PlainTest, test_DFGetImageDimensions_png },
+        { "DFextImageDimensions", PlainTest, test_DFextImageDimensions },
         { "DFInitOnce", PlainTest, test_DFInitOnce },
         { "DFMkdirIfAbsent",            PlainTest, test_DFMkdirIfAbsent },
         { "DFAddDirContents",           PlainTest, test_DFAddDirContents },
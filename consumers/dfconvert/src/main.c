@@ -18,6 +18,7 @@
 #include "DFPlatform.h"
 #include <DocFormats/DocFormats.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 void usage(void)
@@ -46,25 +47,218 @@ void usage(void)
            "    Create a new Word document from a HTML file. The Word document must\n"
            "    not already exist.\n"
            "\n"
+           "dfconvert batch manifest [threads]\n"
+           "\n"
+           "    Run many conversions in one process, up to the given number (default\n"
+           "    1) at a time. Each line of the manifest is a command, followed by the\n"
+           "    two filenames, separated by tabs or (if the filenames contain no\n"
+           "    spaces) spaces; for example:\n"
+           "\n"
+           "        get report.docx report.html\n"
+           "\n"
+           "    Blank lines, and lines starting with #, are ignored. A manifest of -\n"
+           "    is read from standard input. For each conversion, a line of JSON is\n"
+           "    written to standard output as it completes, giving the manifest line\n"
+           "    number, command, filenames, whether it succeeded (with the error\n"
+           "    message if not), and how long it took.\n"
+           "\n"
            "dfconvert does not yet convert odf or latex files.\n"
            "\n");
 }
 
-int main(int argc, const char **argv)
+static int runCommand(const char *command, const char *concrete, const char *abstract, DFError **error)
+{
+    if (!strcmp(command,"get"))
+        return DFGetFile(concrete,abstract,error);
+    if (!strcmp(command,"put"))
+        return DFPutFile(concrete,abstract,error);
+    if (!strcmp(command,"create"))
+        return DFCreateFile(concrete,abstract,error);
+    DFErrorFormat(error,"Unknown command: %s",command);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//                                           Batch mode                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    int lineno;
+    char *text;     // the manifest line, split in place into the fields below
+    char *fields[3]; // command, concrete, abstract
+    int fieldCount;
+} BatchJob;
+
+typedef struct {
+    BatchJob *jobs;
+    int count;
+    int alloc;
+    int failures;
+    DFMutex *outputLock;
+} Batch;
+
+// Splits on tabs if there are any, so that filenames can contain spaces, and otherwise on runs of
+// spaces. Trailing whitespace, including the newline, has already been removed.
+
+static void splitFields(BatchJob *job)
+{
+    const char *separators = (strchr(job->text,'\t') != NULL) ? "\t" : " ";
+    char *pos = job->text;
+    job->fieldCount = 0;
+    while (*pos != '\0') {
+        if (strchr(separators,*pos) != NULL) {
+            pos++;
+            continue;
+        }
+        if (job->fieldCount == 3) {
+            job->fieldCount++; // too many
+            break;
+        }
+        job->fields[job->fieldCount++] = pos;
+        pos += strcspn(pos,separators);
+        if (*pos != '\0')
+            *pos++ = '\0';
+    }
+}
+
+static int readManifest(Batch *batch, FILE *file)
+{
+    size_t alloc = 256;
+    char *line = (char *)xmalloc(alloc);
+    int lineno = 0;
+    for (;;) {
+        // Read a complete line, however long it is
+        size_t len = 0;
+        while (fgets(&line[len],(int)(alloc - len),file) != NULL) {
+            len += strlen(&line[len]);
+            if ((len > 0) && (line[len-1] == '\n'))
+                break;
+            alloc *= 2;
+            line = (char *)xrealloc(line,alloc);
+        }
+        if (len == 0)
+            break;
+        lineno++;
+
+        while ((len > 0) && ((line[len-1] == '\n') || (line[len-1] == '\r') ||
+                             (line[len-1] == ' ') || (line[len-1] == '\t')))
+            line[--len] = '\0';
+        size_t start = strspn(line," \t");
+        if ((line[start] == '\0') || (line[start] == '#'))
+            continue;
+
+        if (batch->count == batch->alloc) {
+            batch->alloc = (batch->alloc == 0) ? 64 : 2*batch->alloc;
+            batch->jobs = (BatchJob *)xrealloc(batch->jobs,batch->alloc*sizeof(BatchJob));
+        }
+        BatchJob *job = &batch->jobs[batch->count++];
+        job->lineno = lineno;
+        job->text = xstrdup(&line[start]);
+        splitFields(job);
+    }
+    free(line);
+    return !ferror(file);
+}
+
+static void printJSONString(const char *str)
+{
+    putchar('"');
+    for (const unsigned char *c = (const unsigned char *)str; *c != '\0'; c++) {
+        switch (*c) {
+            case '"':  fputs("\\\"",stdout); break;
+            case '\\': fputs("\\\\",stdout); break;
+            case '\n': fputs("\\n",stdout); break;
+            case '\r': fputs("\\r",stdout); break;
+            case '\t': fputs("\\t",stdout); break;
+            default:
+                if (*c < 0x20)
+                    printf("\\u%04x",*c);
+                else
+                    putchar(*c);
+                break;
+        }
+    }
+    putchar('"');
+}
+
+static void runBatchJob(void *ctx, int index)
 {
+    Batch *batch = (Batch *)ctx;
+    BatchJob *job = &batch->jobs[index];
     DFError *error = NULL;
-    if ((argc == 4) && !strcmp(argv[1],"get")) {
-        if (DFGetFile(argv[2],argv[3],&error))
-            return 0;
+
+    double start = DFCurrentTime();
+    int ok = 0;
+    if (job->fieldCount == 3)
+        ok = runCommand(job->fields[0],job->fields[1],job->fields[2],&error);
+    else
+        DFErrorFormat(&error,"Expected a command and two filenames");
+    double seconds = DFCurrentTime() - start;
+
+    // Each result is written as a single line, so output from different threads is never interleaved
+    DFMutexLock(batch->outputLock);
+    printf("{\"line\":%d",job->lineno);
+    const char *names[3] = { "command", "concrete", "abstract" };
+    for (int i = 0; (i < 3) && (i < job->fieldCount); i++) {
+        printf(",\"%s\":",names[i]);
+        printJSONString(job->fields[i]);
     }
-    else if ((argc == 4) && !strcmp(argv[1],"put")) {
-        if (DFPutFile(argv[2],argv[3],&error))
-            return 0;
+    printf(",\"ok\":%s",ok ? "true" : "false");
+    if (!ok) {
+        printf(",\"error\":");
+        printJSONString(DFErrorMessage(&error));
+        batch->failures++;
     }
-    else if ((argc == 4) && !strcmp(argv[1],"create")) {
-        if (DFCreateFile(argv[2],argv[3],&error))
+    printf(",\"seconds\":%.6f}\n",seconds);
+    fflush(stdout);
+    DFMutexUnlock(batch->outputLock);
+
+    DFErrorRelease(error);
+}
+
+static int runBatch(const char *manifest, int threads)
+{
+    FILE *file = !strcmp(manifest,"-") ? stdin : fopen(manifest,"r");
+    if (file == NULL) {
+        perror(manifest);
+        return 1;
+    }
+
+    Batch batch;
+    memset(&batch,0,sizeof(batch));
+    int readOK = readManifest(&batch,file);
+    if (file != stdin)
+        fclose(file);
+    if (!readOK) {
+        fprintf(stderr,"%s: Cannot read manifest\n",manifest);
+        for (int i = 0; i < batch.count; i++)
+            free(batch.jobs[i].text);
+        free(batch.jobs);
+        return 1;
+    }
+
+    batch.outputLock = DFMutexNew();
+    DFRunParallel(batch.count,(threads > 0) ? threads : 1,runBatchJob,&batch);
+    DFMutexFree(batch.outputLock);
+
+    for (int i = 0; i < batch.count; i++)
+        free(batch.jobs[i].text);
+    free(batch.jobs);
+    return (batch.failures == 0) ? 0 : 1;
+}
+
+int main(int argc, const char **argv)
+{
+    DFError *error = NULL;
+    if ((argc == 4) && (!strcmp(argv[1],"get") || !strcmp(argv[1],"put") || !strcmp(argv[1],"create"))) {
+        if (runCommand(argv[1],argv[2],argv[3],&error))
             return 0;
     }
+    else if (((argc == 3) || (argc == 4)) && !strcmp(argv[1],"batch")) {
+        return runBatch(argv[2],(argc == 4) ? atoi(argv[3]) : 1);
+    }
     else {
         usage();
         return 0;
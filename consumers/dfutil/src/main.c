@@ -18,6 +18,7 @@
 #include "DFPlatform.h"
 #include "Commands.h"
 #include "BDTTests.h"
+#include "XMLTests.h"
 #include "WordPlain.h"
 #include "HTMLPlain.h"
 #include "FunctionTests.h"
@@ -45,6 +46,17 @@ static int runCommand(int argc, const char **argv, DFError **dferr)
         BDT_Test(argc-2,&argv[2]);
         return 1;
     }
+    else if ((argc >= 2) && !strcmp(argv[1],"-bdt-stress")) {
+        if (!BDT_Stress(argc-2,&argv[2])) {
+            DFErrorFormat(dferr,"Order after put does not match");
+            return 0;
+        }
+        return 1;
+    }
+    else if ((argc >= 2) && !strcmp(argv[1],"-node-bench")) {
+        XML_Benchmark(argc-2,&argv[2]);
+        return 1;
+    }
     else if ((argc == 3) && !strcmp(argv[1],"-css")) {
         return testCSS(argv[2],dferr);
     }
@@ -92,15 +104,17 @@ static int runCommand(int argc, const char **argv, DFError **dferr)
         return 1;
     }
 #endif
-    else if ((argc == 4) && !strcmp(argv[1],"-zip")) {
+    else if (((argc == 4) || (argc == 5)) && !strcmp(argv[1],"-zip")) {
         DFStorage *storage = DFStorageNewFilesystem(argv[3],DFFileFormatUnknown);
-        int r = DFZip(argv[2],storage,dferr);
+        int threads = (argc == 5) ? atoi(argv[4]) : 1;
+        int r = DFZipParallel(argv[2],storage,threads,dferr);
         DFStorageRelease(storage);
         return r;
     }
-    else if ((argc == 4) && !strcmp(argv[1],"-unzip")) {
+    else if (((argc == 4) || (argc == 5)) && !strcmp(argv[1],"-unzip")) {
         DFStorage *storage = DFStorageNewFilesystem(argv[3],DFFileFormatUnknown);
-        int r = DFUnzip(argv[2],storage,dferr);
+        int threads = (argc == 5) ? atoi(argv[4]) : 1;
+        int r = DFUnzipParallel(argv[2],storage,threads,dferr);
         DFStorageRelease(storage);
         return r;
     }
@@ -133,11 +147,17 @@ static int runCommand(int argc, const char **argv, DFError **dferr)
               "dfutil -css-unescape [infilename]\n"
               "    Unescape CSS class name\n"
               "\n"
-               "dfutil -zip zipFilename sourceDir\n"
-               "    Create a zip file\n"
+               "dfutil -zip zipFilename sourceDir [threads]\n"
+               "    Create a zip file, compressing up to threads entries at once\n"
+               "\n"
+               "dfutil -unzip zipFilename destDir [threads]\n"
+               "    Extract a zip file, decompressing up to threads entries at once\n"
+               "\n"
+               "dfutil -bdt-stress [paragraphs] [edits] [seed]\n"
+               "    Time BDTContainerPut on a synthetic body after random edits\n"
                "\n"
-               "dfutil -unzip zipFilename destDir\n"
-               "    Extract a zip file\n"
+               "dfutil -node-bench [paragraphs|filename] [iterations]\n"
+               "    Time parsing an XML document and walking its nodes, in nodes per second\n"
                "\n"
               "dfutil input.html output.docx\n"
               "dfutil input.html output.odt\n"
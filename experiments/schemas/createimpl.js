@@ -165,6 +165,165 @@ function buildTagsArray()
 }
 
 
+// Perfect hashing for the predefined names, so they can be looked up from static tables rather
+// than a hash table built at runtime. We use hash-and-displace: each key hashes to a bucket, and
+// each bucket has a displacement, chosen so that the keys in it land in otherwise unused slots.
+// The hash functions below must match those emitted into the C source by printPerfectHashFunctions.
+
+var PERFECT_HASH_MAX_DISPLACEMENT = 65535;
+
+function hashMix(h)
+{
+    h = (h ^ (h >>> 16)) >>> 0;
+    h = Math.imul(h,0x85ebca6b) >>> 0;
+    h = (h ^ (h >>> 13)) >>> 0;
+    h = Math.imul(h,0xc2b2ae35) >>> 0;
+    h = (h ^ (h >>> 16)) >>> 0;
+    return h;
+}
+
+function hashString(seed,str)
+{
+    var h = (2166136261 ^ seed) >>> 0;
+    for (var i = 0; i < str.length; i++) {
+        var c = str.charCodeAt(i);
+        if (c >= 0x80)
+            throw new Error("Non-ASCII name: "+str);
+        h = Math.imul((h ^ c) >>> 0,16777619) >>> 0;
+    }
+    return h;
+}
+
+function hashSlot(h,displacement,slotCount)
+{
+    return hashMix((h ^ Math.imul(displacement,0x9e3779b9)) >>> 0) & (slotCount - 1);
+}
+
+// keys is an array of { hash, value }, where value is non-zero. Returns null if there is no
+// assignment of displacements that works for the given hashes.
+function buildPerfectHash(keys,bucketCount,slotCount)
+{
+    var buckets = new Array(bucketCount);
+    for (var b = 0; b < bucketCount; b++)
+        buckets[b] = { index: b, keys: [] };
+    for (var i = 0; i < keys.length; i++)
+        buckets[keys[i].hash & (bucketCount - 1)].keys.push(keys[i]);
+
+    // Place the fullest buckets first, while there is the most room
+    var order = buckets.slice().sort(function(a,b) {
+        return (b.keys.length - a.keys.length) || (a.index - b.index);
+    });
+
+    var displacements = new Array(bucketCount);
+    var slots = new Array(slotCount);
+    for (var b = 0; b < bucketCount; b++)
+        displacements[b] = 0;
+    for (var s = 0; s < slotCount; s++)
+        slots[s] = 0;
+
+    for (var o = 0; o < order.length; o++) {
+        var bucket = order[o];
+        if (bucket.keys.length == 0)
+            break;
+        var placed = false;
+        for (var d = 0; (d <= PERFECT_HASH_MAX_DISPLACEMENT) && !placed; d++) {
+            var used = new Object();
+            placed = true;
+            for (var k = 0; k < bucket.keys.length; k++) {
+                var slot = hashSlot(bucket.keys[k].hash,d,slotCount);
+                if ((slots[slot] != 0) || used[slot]) {
+                    placed = false;
+                    break;
+                }
+                used[slot] = true;
+            }
+            if (placed) {
+                displacements[bucket.index] = d;
+                for (var k = 0; k < bucket.keys.length; k++)
+                    slots[hashSlot(bucket.keys[k].hash,d,slotCount)] = bucket.keys[k].value;
+            }
+        }
+        if (!placed)
+            return null;
+    }
+    return { displacements: displacements, slots: slots };
+}
+
+function powerOfTwoAtLeast(n)
+{
+    var result = 1;
+    while (result < n)
+        result *= 2;
+    return result;
+}
+
+// Tries successive seeds until one gives a perfect hash. keyHash(seed,i) gives the hash of key i;
+// key i is stored in the table as the value i + firstValue.
+function findPerfectHash(count,firstValue,keyHash)
+{
+    var bucketCount = powerOfTwoAtLeast(Math.ceil(count/4));
+    var slotCount = powerOfTwoAtLeast(Math.ceil(count*1.2));
+    for (var seed = 0; seed < 1000; seed++) {
+        var keys = new Array();
+        for (var i = 0; i < count; i++)
+            keys.push({ hash: keyHash(seed,i), value: i + firstValue });
+        var result = buildPerfectHash(keys,bucketCount,slotCount);
+        if (result != null) {
+            result.seed = seed;
+            result.bucketCount = bucketCount;
+            result.slotCount = slotCount;
+            return result;
+        }
+    }
+    throw new Error("Could not find a perfect hash for "+count+" keys");
+}
+
+function printTable(output,type,name,values)
+{
+    output.push("static const "+type+" "+name+"["+values.length+"] = {");
+    var perLine = 16;
+    for (var i = 0; i < values.length; i += perLine)
+        output.push("    "+values.slice(i,i+perLine).join(",")+",");
+    output.push("};");
+}
+
+function printPerfectHashFunctions(output)
+{
+    output.push("static uint32_t hashMix(uint32_t h)");
+    output.push("{");
+    output.push("    h ^= h >> 16;");
+    output.push("    h *= 0x85ebca6bU;");
+    output.push("    h ^= h >> 13;");
+    output.push("    h *= 0xc2b2ae35U;");
+    output.push("    h ^= h >> 16;");
+    output.push("    return h;");
+    output.push("}");
+    output.push("");
+    output.push("static uint32_t hashString(uint32_t seed, const char *str)");
+    output.push("{");
+    output.push("    uint32_t h = 2166136261U ^ seed;");
+    output.push("    for (const unsigned char *c = (const unsigned char *)str; *c != 0; c++)");
+    output.push("        h = (h ^ *c) * 16777619U;");
+    output.push("    return h;");
+    output.push("}");
+    output.push("");
+    output.push("static uint32_t hashSlot(uint32_t h, uint32_t displacement, uint32_t slotCount)");
+    output.push("{");
+    output.push("    return hashMix(h ^ (displacement * 0x9e3779b9U)) & (slotCount - 1);");
+    output.push("}");
+}
+
+function namespaceID(namespaceURI)
+{
+    var namespace = namespacesByURI[namespaceURI];
+    return (namespace != null) ? namespaceArray.indexOf(namespace) + 1 : 0;
+}
+
+function tagKeyHash(seed,nsId,localName)
+{
+    return hashMix((hashString(seed,localName) ^ Math.imul(nsId,0x9e3779b9)) >>> 0);
+}
+
 function printNamespaceHeader(output)
 {
     output.push(autoGeneratedMsg);
@@ -192,6 +351,9 @@ function printNamespaceHeader(output)
     output.push("extern const NamespaceDecl PredefinedNamespaces[PREDEFINED_NAMESPACE_COUNT];");
     output.push("#endif");
     output.push("");
+    output.push("// Returns NAMESPACE_NULL if URI is not one of the predefined namespaces");
+    output.push("NamespaceID DFLookupPredefinedNamespace(const char *URI);");
+    output.push("");
     output.push("#endif");
 }
 
@@ -201,7 +363,9 @@ function printNamespaceSource(output)
     output.push("");
     output.push("#define NAMESPACE_C");
     output.push("#include \"DFXMLNamespaces.h\"");
+    output.push("#include <stdint.h>");
     output.push("#include <stdio.h>");
+    output.push("#include <string.h>");
     output.push("");
     output.push("const NamespaceDecl PredefinedNamespaces[PREDEFINED_NAMESPACE_COUNT] = {");
     output.push("    { NULL, NULL },");
@@ -211,6 +375,28 @@ function printNamespaceSource(output)
                     ", "+JSON.stringify(namespace.xmlPrefix)+" },");
     }
     output.push("};");
+
+    var hash = findPerfectHash(namespaceArray.length,1,function(seed,i) {
+        return hashMix(hashString(seed,namespaceArray[i].namespaceURI));
+    });
+    output.push("");
+    printPerfectHashFunctions(output);
+    output.push("");
+    printTable(output,"uint16_t","NamespaceDisplacements",hash.displacements);
+    output.push("");
+    printTable(output,"uint8_t","NamespaceSlots",hash.slots);
+    output.push("");
+    output.push("NamespaceID DFLookupPredefinedNamespace(const char *URI)");
+    output.push("{");
+    output.push("    if (URI == NULL)");
+    output.push("        return NAMESPACE_NULL;");
+    output.push("    uint32_t h = hashMix(hashString("+hash.seed+",URI));");
+    output.push("    uint32_t d = NamespaceDisplacements[h & "+(hash.bucketCount-1)+"];");
+    output.push("    NamespaceID nsId = NamespaceSlots[hashSlot(h,d,"+hash.slotCount+")];");
+    output.push("    if ((nsId == NAMESPACE_NULL) || strcmp(PredefinedNamespaces[nsId].namespaceURI,URI))");
+    output.push("        return NAMESPACE_NULL;");
+    output.push("    return nsId;");
+    output.push("}");
 }
 
 function printTagsHeader(output)
@@ -240,6 +426,9 @@ function printTagsHeader(output)
     output.push("extern const TagDecl PredefinedTags[PREDEFINED_TAG_COUNT];");
     output.push("#endif");
     output.push("");
+    output.push("// Returns 0 if there is no predefined tag with the given namespace and local name");
+    output.push("Tag DFLookupPredefinedTag(unsigned int nsId, const char *localName);");
+    output.push("");
     output.push("#endif");
 }
 
@@ -250,7 +439,9 @@ function printTagsSource(output)
     output.push("#define TAGS_C");
     output.push("#include \"DFXMLNames.h\"");
     output.push("#include \"DFXMLNamespaces.h\"");
+    output.push("#include <stdint.h>");
     output.push("#include <stdio.h>");
+    output.push("#include <string.h>");
     output.push("");
     output.push("const TagDecl PredefinedTags[PREDEFINED_TAG_COUNT] = {");
     for (var i = 0; i < MINIMUM_TAG; i++) {
@@ -266,6 +457,27 @@ function printTagsSource(output)
                     JSON.stringify(tag.localName)+" },");
     }
     output.push("};");
+
+    var hash = findPerfectHash(tagArray.length,MINIMUM_TAG,function(seed,i) {
+        return tagKeyHash(seed,namespaceID(tagArray[i].namespaceURI),tagArray[i].localName);
+    });
+    output.push("");
+    printPerfectHashFunctions(output);
+    output.push("");
+    printTable(output,"uint16_t","TagDisplacements",hash.displacements);
+    output.push("");
+    printTable(output,"uint16_t","TagSlots",hash.slots);
+    output.push("");
+    output.push("Tag DFLookupPredefinedTag(unsigned int nsId, const char *localName)");
+    output.push("{");
+    output.push("    uint32_t h = hashMix(hashString("+hash.seed+",localName) ^ (nsId * 0x9e3779b9U));");
+    output.push("    uint32_t d = TagDisplacements[h & "+(hash.bucketCount-1)+"];");
+    output.push("    Tag tag = TagSlots[hashSlot(h,d,"+hash.slotCount+")];");
+    output.push("    if ((tag == 0) || (PredefinedTags[tag].namespaceID != nsId) ||");
+    output.push("        strcmp(PredefinedTags[tag].localName,localName))");
+    output.push("        return 0;");
+    output.push("    return tag;");
+    output.push("}");
 }
 
 function printLookupHeader(output)